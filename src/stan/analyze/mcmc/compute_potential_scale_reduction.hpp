@@ -138,18 +138,13 @@ inline double compute_potential_scale_reduction(
  * @return potential scale reduction for the specified parameter
  */
 inline double compute_split_potential_scale_reduction(
-    std::vector<const double*> draws, std::vector<size_t> sizes) {
-  int num_chains = sizes.size();
-  size_t num_draws = sizes[0];
-  for (int chain = 1; chain < num_chains; ++chain) {
-    num_draws = std::min(num_draws, sizes[chain]);
+    const std::vector<const double*>& draws, const std::vector<size_t>& sizes) {
+  std::vector<const double*> split_draws;
+  std::vector<size_t> half_sizes;
+  for (const auto& half : split_chain_views(draws, sizes)) {
+    split_draws.push_back(half.data());
+    half_sizes.push_back(half.size());
   }
-
-  std::vector<const double*> split_draws = split_chains(draws, sizes);
-
-  double half = num_draws / 2.0;
-  std::vector<size_t> half_sizes(2 * num_chains, std::floor(half));
-
   return compute_potential_scale_reduction(split_draws, half_sizes);
 }
 
@@ -171,7 +166,7 @@ inline double compute_split_potential_scale_reduction(
  * @return potential scale reduction for the specified parameter
  */
 inline double compute_split_potential_scale_reduction(
-    std::vector<const double*> draws, size_t size) {
+    const std::vector<const double*>& draws, size_t size) {
   int num_chains = draws.size();
   std::vector<size_t> sizes(num_chains, size);
   return compute_split_potential_scale_reduction(draws, sizes);
@@ -0,0 +1,115 @@
+#ifndef STAN_ANALYZE_MCMC_COMPUTE_SPLIT_RANK_NORMALIZED_ESS_HPP
+#define STAN_ANALYZE_MCMC_COMPUTE_SPLIT_RANK_NORMALIZED_ESS_HPP
+
+#include <stan/math/prim.hpp>
+#include <stan/analyze/mcmc/compute_effective_sample_size.hpp>
+#include <stan/analyze/mcmc/rank_normalization.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace analyze {
+
+/**
+ * Computes the split effective sample size (ESS) of pooled,
+ * transformed draws stored chain after chain.
+ *
+ * @param pooled draws of all chains, each chain a contiguous segment
+ * @param num_chains number of chains
+ * @param num_draws number of draws per chain
+ * @return split effective sample size
+ */
+inline double compute_split_effective_sample_size_pooled(
+    const Eigen::VectorXd& pooled, size_t num_chains, size_t num_draws) {
+  std::vector<const double*> draws(num_chains);
+  for (size_t chain = 0; chain < num_chains; ++chain)
+    draws[chain] = pooled.data() + chain * num_draws;
+  return compute_split_effective_sample_size(draws, num_draws);
+}
+
+/**
+ * Computes the bulk and tail effective sample size (ESS) for the
+ * specified parameter across all kept samples.  The bulk ESS is the
+ * split ESS of the rank-normalized draws; the tail ESS is the minimum
+ * of the split ESS of the indicators for the draws falling below the
+ * 5% and 95% quantiles.
+ *
+ * All chains are ranked together with one parallel argsort.  Working
+ * space is a constant number of vectors the length of the pooled
+ * draws; the chains themselves are never copied into per-chain
+ * vectors.
+ *
+ * See Vehtari et al. (2021), "Rank-normalization, folding, and
+ * localization: An improved R-hat for assessing convergence of
+ * MCMC", https://doi.org/10.1214/20-BA1221.
+ *
+ * Current implementation assumes draws are stored in contiguous
+ * blocks of memory.  Chains are trimmed from the back to match the
+ * length of the shortest chain.  Note that the effective sample size
+ * can not be estimated with less than four draws.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param sizes stores sizes of chains
+ * @return pair of bulk and tail effective sample size; NaN if any
+ *   draw is not finite or there are less than four draws per chain
+ */
+inline std::pair<double, double> compute_split_rank_normalized_ess(
+    const std::vector<const double*>& draws, const std::vector<size_t>& sizes) {
+  int num_chains = sizes.size();
+  size_t num_draws = sizes[0];
+  for (int chain = 1; chain < num_chains; ++chain) {
+    num_draws = std::min(num_draws, sizes[chain]);
+  }
+  if (num_draws < 4) {
+    return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
+                          std::numeric_limits<double>::quiet_NaN());
+  }
+
+  Eigen::VectorXd pooled;
+  pool_draws(draws, num_draws, pooled);
+  if (!pooled.allFinite()) {
+    return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
+                          std::numeric_limits<double>::quiet_NaN());
+  }
+
+  Eigen::VectorXd work = pooled;
+  double q05 = partial_sort_quantile(work, 0.05);
+  double q95 = partial_sort_quantile(work, 0.95);
+
+  work = (pooled.array() <= q05).cast<double>();
+  double ess_tail
+      = compute_split_effective_sample_size_pooled(work, num_chains, num_draws);
+  work = (pooled.array() <= q95).cast<double>();
+  ess_tail = std::min(ess_tail, compute_split_effective_sample_size_pooled(
+                                    work, num_chains, num_draws));
+
+  std::vector<size_t> idx;
+  rank_normalize(pooled, idx);
+  double ess_bulk = compute_split_effective_sample_size_pooled(
+      pooled, num_chains, num_draws);
+
+  return std::make_pair(ess_bulk, ess_tail);
+}
+
+/**
+ * Computes the bulk and tail effective sample size (ESS) for the
+ * specified parameter across all kept samples.  Argument size will be
+ * broadcast to same length as draws.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param size size of chains
+ * @return pair of bulk and tail effective sample size
+ */
+inline std::pair<double, double> compute_split_rank_normalized_ess(
+    const std::vector<const double*>& draws, size_t size) {
+  std::vector<size_t> sizes(draws.size(), size);
+  return compute_split_rank_normalized_ess(draws, sizes);
+}
+
+}  // namespace analyze
+}  // namespace stan
+
+#endif
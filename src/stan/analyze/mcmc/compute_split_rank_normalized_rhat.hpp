@@ -0,0 +1,112 @@
+#ifndef STAN_ANALYZE_MCMC_COMPUTE_SPLIT_RANK_NORMALIZED_RHAT_HPP
+#define STAN_ANALYZE_MCMC_COMPUTE_SPLIT_RANK_NORMALIZED_RHAT_HPP
+
+#include <stan/math/prim.hpp>
+#include <stan/analyze/mcmc/compute_potential_scale_reduction.hpp>
+#include <stan/analyze/mcmc/rank_normalization.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace analyze {
+
+/**
+ * Computes the split potential scale reduction (Rhat) of pooled,
+ * transformed draws stored chain after chain.
+ *
+ * @param pooled draws of all chains, each chain a contiguous segment
+ * @param num_chains number of chains
+ * @param num_draws number of draws per chain
+ * @return split potential scale reduction
+ */
+inline double compute_split_potential_scale_reduction_pooled(
+    const Eigen::VectorXd& pooled, size_t num_chains, size_t num_draws) {
+  std::vector<const double*> draws(num_chains);
+  for (size_t chain = 0; chain < num_chains; ++chain)
+    draws[chain] = pooled.data() + chain * num_draws;
+  return compute_split_potential_scale_reduction(draws, num_draws);
+}
+
+/**
+ * Computes the rank-normalized split potential scale reduction (Rhat)
+ * for the bulk and the tails of the specified parameter across all
+ * kept samples.  The bulk Rhat is the split Rhat of the
+ * rank-normalized draws; the tail Rhat is the split Rhat of the
+ * rank-normalized draws folded around their median.
+ *
+ * All chains are ranked together with one parallel argsort per
+ * transform.  Working space is a constant number of vectors the
+ * length of the pooled draws; the chains themselves are never copied
+ * into per-chain vectors.
+ *
+ * See Vehtari et al. (2021), "Rank-normalization, folding, and
+ * localization: An improved R-hat for assessing convergence of
+ * MCMC", https://doi.org/10.1214/20-BA1221.
+ *
+ * Current implementation assumes draws are stored in contiguous
+ * blocks of memory.  Chains are trimmed from the back to match the
+ * length of the shortest chain.  Note that the potential scale
+ * reduction is not estimated with less than four draws.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param sizes stores sizes of chains
+ * @return pair of bulk and tail potential scale reduction; NaN if any
+ *   draw is not finite or there are less than four draws per chain
+ */
+inline std::pair<double, double> compute_split_rank_normalized_rhat(
+    const std::vector<const double*>& draws, const std::vector<size_t>& sizes) {
+  int num_chains = sizes.size();
+  size_t num_draws = sizes[0];
+  for (int chain = 1; chain < num_chains; ++chain) {
+    num_draws = std::min(num_draws, sizes[chain]);
+  }
+  if (num_draws < 4) {
+    return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
+                          std::numeric_limits<double>::quiet_NaN());
+  }
+
+  Eigen::VectorXd bulk;
+  pool_draws(draws, num_draws, bulk);
+  if (!bulk.allFinite()) {
+    return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
+                          std::numeric_limits<double>::quiet_NaN());
+  }
+
+  Eigen::VectorXd tail = bulk;
+  double median = partial_sort_quantile(tail, 0.5);
+  tail = (bulk.array() - median).abs();
+
+  std::vector<size_t> idx;
+  rank_normalize(bulk, idx);
+  rank_normalize(tail, idx);
+
+  return std::make_pair(
+      compute_split_potential_scale_reduction_pooled(bulk, num_chains,
+                                                     num_draws),
+      compute_split_potential_scale_reduction_pooled(tail, num_chains,
+                                                     num_draws));
+}
+
+/**
+ * Computes the rank-normalized split potential scale reduction (Rhat)
+ * for the bulk and the tails of the specified parameter across all
+ * kept samples.  Argument size will be broadcast to same length as
+ * draws.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param size size of chains
+ * @return pair of bulk and tail potential scale reduction
+ */
+inline std::pair<double, double> compute_split_rank_normalized_rhat(
+    const std::vector<const double*>& draws, size_t size) {
+  std::vector<size_t> sizes(draws.size(), size);
+  return compute_split_rank_normalized_rhat(draws, sizes);
+}
+
+}  // namespace analyze
+}  // namespace stan
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef STAN_ANALYZE_MCMC_RANK_NORMALIZATION_HPP
+#define STAN_ANALYZE_MCMC_RANK_NORMALIZATION_HPP
+
+#include <stan/math/prim.hpp>
+#include <tbb/parallel_sort.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace stan {
+namespace analyze {
+
+/**
+ * Copies the first <code>num_draws</code> draws of every chain into a
+ * single pooled vector, chain after chain, so that the draws of chain
+ * <code>n</code> are the segment starting at <code>n * num_draws</code>.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param num_draws number of draws to take from each chain
+ * @param[out] pooled pooled draws; resized to hold all of them
+ */
+inline void pool_draws(const std::vector<const double*>& draws,
+                       size_t num_draws, Eigen::VectorXd& pooled) {
+  size_t num_chains = draws.size();
+  pooled.resize(num_chains * num_draws);
+  for (size_t chain = 0; chain < num_chains; ++chain)
+    pooled.segment(chain * num_draws, num_draws)
+        = Eigen::Map<const Eigen::VectorXd>(draws[chain], num_draws);
+}
+
+/**
+ * Replaces every value with its rank-normalized score
+ * <code>inv_Phi((r - 3/8) / (S + 1/4))</code>, where <code>r</code>
+ * is the rank of the value among all <code>S</code> values and ties
+ * are given their average rank.
+ *
+ * The ranks come from a single parallel argsort of the values.  The
+ * transformation is done in place; the only other working space is
+ * the index vector, which is passed in so repeated calls can reuse
+ * its allocation.
+ *
+ * See Vehtari et al. (2021), "Rank-normalization, folding, and
+ * localization: An improved R-hat for assessing convergence of
+ * MCMC", https://doi.org/10.1214/20-BA1221.
+ *
+ * @param[in,out] x values, replaced by their normal scores
+ * @param[in,out] idx working space for the argsort
+ */
+inline void rank_normalize(Eigen::VectorXd& x, std::vector<size_t>& idx) {
+  size_t size = x.size();
+  idx.resize(size);
+  std::iota(idx.begin(), idx.end(), 0);
+  tbb::parallel_sort(idx.begin(), idx.end(),
+                     [&x](size_t a, size_t b) { return x(a) < x(b); });
+
+  double denom = size + 0.25;
+  size_t begin = 0;
+  while (begin < size) {
+    size_t end = begin + 1;
+    while (end < size && x(idx[end]) == x(idx[begin]))
+      ++end;
+    double rank = (begin + 1 + end) / 2.0;
+    double score = stan::math::inv_Phi((rank - 0.375) / denom);
+    for (size_t n = begin; n < end; ++n)
+      x(idx[n]) = score;
+    begin = end;
+  }
+}
+
+/**
+ * Returns the specified quantile of the values, linearly
+ * interpolating between order statistics.  The values are reordered
+ * by partial sorting.
+ *
+ * @param[in,out] x values; reordered on return
+ * @param prob probability of the quantile, in [0, 1]
+ * @return quantile
+ * @throw std::invalid_argument if there are no values
+ */
+inline double partial_sort_quantile(Eigen::VectorXd& x, double prob) {
+  stan::math::check_nonzero_size("partial_sort_quantile", "x", x);
+  double pos = prob * (x.size() - 1);
+  size_t lo = std::floor(pos);
+  double* data = x.data();
+  std::nth_element(data, data + lo, data + x.size());
+  double q = data[lo];
+  if (lo + 1 < static_cast<size_t>(x.size()) && pos > lo) {
+    double next = *std::min_element(data + lo + 1, data + x.size());
+    q += (pos - lo) * (next - q);
+  }
+  return q;
+}
+
+}  // namespace analyze
+}  // namespace stan
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef STAN_ANALYZE_MCMC_SPLIT_CHAINS_HPP
 #define STAN_ANALYZE_MCMC_SPLIT_CHAINS_HPP
 
-#include <cmath>
+#include <stan/math/prim/fun/Eigen.hpp>
 #include <vector>
 #include <algorithm>
 
@@ -9,20 +9,19 @@ namespace stan {
 namespace analyze {
 
 /**
- * Splits each chain into two chains of equal length.  When the
- * number of total draws N is odd, the (N+1)/2th draw is ignored.
+ * Splits each chain into two chains of equal length without copying
+ * any draws.  When the number of total draws N is odd, the (N+1)/2th
+ * draw is ignored.  Chains are trimmed from the back to match the
+ * length of the shortest chain.
  *
- * See more details in Stan reference manual section "Effective
- * Sample Size". http://mc-stan.org/users/documentation
- *
- * Current implementation assumes chains are all of equal size and
- * draws are stored in contiguous blocks of memory.
+ * The returned maps view the memory pointed to by the arguments,
+ * which must outlive them.
  *
  * @param draws stores pointers to arrays of chains
  * @param sizes stores sizes of chains
- * @return std::vector of pointers to twice as many arrays of half chains
+ * @return std::vector of twice as many views of half chains
  */
-inline std::vector<const double*> split_chains(
+inline std::vector<Eigen::Map<const Eigen::VectorXd>> split_chain_views(
     const std::vector<const double*>& draws, const std::vector<size_t>& sizes) {
   int num_chains = sizes.size();
   size_t num_draws = sizes[0];
@@ -30,17 +29,60 @@ inline std::vector<const double*> split_chains(
     num_draws = std::min(num_draws, sizes[chain]);
   }
 
-  double half = num_draws / 2.0;
-  int half_draws = std::ceil(half);
-  std::vector<const double*> split_draws(2 * num_chains);
+  size_t half_draws = num_draws / 2;
+  size_t offset = num_draws - half_draws;
+  std::vector<Eigen::Map<const Eigen::VectorXd>> split_draws;
+  split_draws.reserve(2 * num_chains);
   for (int n = 0; n < num_chains; ++n) {
-    split_draws[2 * n] = &draws[n][0];
-    split_draws[2 * n + 1] = &draws[n][half_draws];
+    split_draws.emplace_back(draws[n], half_draws);
+    split_draws.emplace_back(draws[n] + offset, half_draws);
   }
 
   return split_draws;
 }
 
+/**
+ * Splits each chain into two chains of equal length without copying
+ * any draws.  When the number of total draws N is odd, the (N+1)/2th
+ * draw is ignored.  Argument size will be broadcast to same length as
+ * draws.
+ *
+ * The returned maps view the memory pointed to by the arguments,
+ * which must outlive them.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param size size of chains
+ * @return std::vector of twice as many views of half chains
+ */
+inline std::vector<Eigen::Map<const Eigen::VectorXd>> split_chain_views(
+    const std::vector<const double*>& draws, size_t size) {
+  std::vector<size_t> sizes(draws.size(), size);
+  return split_chain_views(draws, sizes);
+}
+
+/**
+ * Splits each chain into two chains of equal length.  When the
+ * number of total draws N is odd, the (N+1)/2th draw is ignored.
+ *
+ * See more details in Stan reference manual section "Effective
+ * Sample Size". http://mc-stan.org/users/documentation
+ *
+ * Current implementation assumes chains are all of equal size and
+ * draws are stored in contiguous blocks of memory.  The half chains
+ * are those of <code>split_chain_views</code>.
+ *
+ * @param draws stores pointers to arrays of chains
+ * @param sizes stores sizes of chains
+ * @return std::vector of pointers to twice as many arrays of half chains
+ */
+inline std::vector<const double*> split_chains(
+    const std::vector<const double*>& draws, const std::vector<size_t>& sizes) {
+  std::vector<const double*> split_draws;
+  for (const auto& half : split_chain_views(draws, sizes))
+    split_draws.push_back(half.data());
+  return split_draws;
+}
+
 /**
  * Splits each chain into two chains of equal length.  When the
  * number of total draws N is odd, the (N+1)/2th draw is ignored.
@@ -56,10 +98,9 @@ inline std::vector<const double*> split_chains(
  * @param size size of chains
  * @return std::vector of pointers to twice as many arrays of half chains
  */
-inline std::vector<const double*> split_chains(std::vector<const double*> draws,
-                                               size_t size) {
-  int num_chains = draws.size();
-  std::vector<size_t> sizes(num_chains, size);
+inline std::vector<const double*> split_chains(
+    const std::vector<const double*>& draws, size_t size) {
+  std::vector<size_t> sizes(draws.size(), size);
   return split_chains(draws, sizes);
 }
 
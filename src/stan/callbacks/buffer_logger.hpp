@@ -0,0 +1,136 @@
+#ifndef STAN_CALLBACKS_BUFFER_LOGGER_HPP
+#define STAN_CALLBACKS_BUFFER_LOGGER_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * <code>buffer_logger</code> is an implementation of
+ * <code>logger</code> that records messages in memory so they can be
+ * passed on to another logger later with <code>replay</code>.
+ *
+ * This lets work done concurrently log into one buffer per task and
+ * have the messages reach the real logger in a deterministic order.
+ */
+class buffer_logger : public logger {
+ public:
+  /**
+   * Log levels, in the order of the <code>logger</code> methods.
+   */
+  enum level { debug_level, info_level, warn_level, error_level, fatal_level };
+
+  /**
+   * A recorded message.
+   */
+  struct message {
+    level lvl;
+    std::string text;
+    bool from_stream;
+  };
+
+ private:
+  std::vector<message> messages_;
+
+  void record(level lvl, const std::string& text, bool from_stream) {
+    messages_.push_back(message{lvl, text, from_stream});
+  }
+
+  template <typename T>
+  static void send(logger& out, level lvl, const T& msg) {
+    switch (lvl) {
+      case debug_level:
+        out.debug(msg);
+        break;
+      case info_level:
+        out.info(msg);
+        break;
+      case warn_level:
+        out.warn(msg);
+        break;
+      case error_level:
+        out.error(msg);
+        break;
+      case fatal_level:
+        out.fatal(msg);
+        break;
+    }
+  }
+
+ public:
+  void debug(const std::string& message) {
+    record(debug_level, message, false);
+  }
+
+  void debug(const std::stringstream& message) {
+    record(debug_level, message.str(), true);
+  }
+
+  void info(const std::string& message) { record(info_level, message, false); }
+
+  void info(const std::stringstream& message) {
+    record(info_level, message.str(), true);
+  }
+
+  void warn(const std::string& message) { record(warn_level, message, false); }
+
+  void warn(const std::stringstream& message) {
+    record(warn_level, message.str(), true);
+  }
+
+  void error(const std::string& message) {
+    record(error_level, message, false);
+  }
+
+  void error(const std::stringstream& message) {
+    record(error_level, message.str(), true);
+  }
+
+  void fatal(const std::string& message) {
+    record(fatal_level, message, false);
+  }
+
+  void fatal(const std::stringstream& message) {
+    record(fatal_level, message.str(), true);
+  }
+
+  /**
+   * Return the recorded messages in the order they were logged.
+   *
+   * @return messages
+   */
+  const std::vector<message>& messages() const { return messages_; }
+
+  /**
+   * Send the recorded messages, in the order they were logged, to
+   * the specified logger, at the same level and through the same
+   * overload (string or stringstream) they were logged with.
+   *
+   * @param[in,out] out logger to send the messages to
+   */
+  void replay(logger& out) const {
+    for (const message& msg : messages_) {
+      if (msg.from_stream) {
+        std::stringstream ss;
+        ss << msg.text;
+        send(out, msg.lvl, ss);
+      } else {
+        send(out, msg.lvl, msg.text);
+      }
+    }
+  }
+
+  /**
+   * Discard the recorded messages.
+   */
+  void clear() { messages_.clear(); }
+};
+
+}  // namespace callbacks
+}  // namespace stan
+
+#endif
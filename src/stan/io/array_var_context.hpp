@@ -3,9 +3,9 @@
 
 #include <stan/io/var_context.hpp>
 #include <stan/io/validate_dims.hpp>
+#include <stan/io/var_index.hpp>
 #include <stan/math.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
-#include <map>
 #include <algorithm>
 #include <functional>
 #include <numeric>
@@ -26,25 +26,7 @@ namespace io {
  */
 class array_var_context : public var_context {
  private:
-  // Pair used in data maps
-  template <typename T>
-  using data_pair_t = std::pair<std::vector<T>, std::vector<size_t>>;
-
-  std::map<std::string, data_pair_t<double>> vars_r_;  // Holds data for reals
-  std::map<std::string, data_pair_t<int>> vars_i_;     // Holds data for doubles
-  // When search for variable name fails, return one these
-  const std::vector<double> empty_vec_r_;
-  const std::vector<int> empty_vec_i_;
-  const std::vector<size_t> empty_vec_ui_;
-
-  /**
-   * Search over the real variables to check if a name is in the map
-   * @param name The name of the variable to search for
-   * @return logical indicating if the variable was found in the map of reals.
-   */
-  bool contains_r_only(const std::string& name) const {
-    return vars_r_.find(name) != vars_r_.end();
-  }
+  var_index vars_;  // Holds data for reals and integers
 
   /**
    * Check (1) if the vector size of dimensions is no smaller
@@ -95,11 +77,14 @@ class array_var_context : public var_context {
              const std::vector<double>& values,
              const std::vector<std::vector<size_t>>& dims) {
     std::vector<size_t> dim_vec = validate_dims(names, values.size(), dims);
+    vars_.reserve(vars_.size() + names.size());
     for (size_t i = 0; i < names.size(); i++) {
-      vars_r_.emplace(names[i],
-                      data_pair_t<double>{{values.data() + dim_vec[i],
-                                           values.data() + dim_vec[i + 1]},
-                                          dims[i]});
+      if (vars_.contains_r(names[i]))
+        continue;
+      var_index::var& var = vars_.insert_r(names[i]);
+      var.vals_r.assign(values.data() + dim_vec[i],
+                        values.data() + dim_vec[i + 1]);
+      var.dims = dims[i];
     }
   }
 
@@ -116,11 +101,14 @@ class array_var_context : public var_context {
              const Eigen::VectorXd& values,
              const std::vector<std::vector<size_t>>& dims) {
     std::vector<size_t> dim_vec = validate_dims(names, values.size(), dims);
+    vars_.reserve(vars_.size() + names.size());
     for (size_t i = 0; i < names.size(); i++) {
-      vars_r_.emplace(names[i],
-                      data_pair_t<double>{{values.data() + dim_vec[i],
-                                           values.data() + dim_vec[i + 1]},
-                                          dims[i]});
+      if (vars_.contains_r(names[i]))
+        continue;
+      var_index::var& var = vars_.insert_r(names[i]);
+      var.vals_r.assign(values.data() + dim_vec[i],
+                        values.data() + dim_vec[i + 1]);
+      var.dims = dims[i];
     }
   }
 
@@ -137,11 +125,14 @@ class array_var_context : public var_context {
              const std::vector<int>& values,
              const std::vector<std::vector<size_t>>& dims) {
     std::vector<size_t> dim_vec = validate_dims(names, values.size(), dims);
+    vars_.reserve(vars_.size() + names.size());
     for (size_t i = 0; i < names.size(); i++) {
-      vars_i_.emplace(names[i],
-                      data_pair_t<int>{{values.data() + dim_vec[i],
-                                        values.data() + dim_vec[i + 1]},
-                                       dims[i]});
+      if (vars_.contains_r(names[i]))
+        continue;
+      var_index::var& var = vars_.insert_i(names[i]);
+      var.vals_i.assign(values.data() + dim_vec[i],
+                        values.data() + dim_vec[i + 1]);
+      var.dims = dims[i];
     }
   }
 
@@ -251,7 +242,7 @@ class array_var_context : public var_context {
    * @return <code>true</code> if the variable exists.
    */
   bool contains_r(const std::string& name) const {
-    return contains_r_only(name) || contains_i(name);
+    return vars_.contains_r(name);
   }
 
   /**
@@ -263,7 +254,7 @@ class array_var_context : public var_context {
    * array value.
    */
   bool contains_i(const std::string& name) const {
-    return vars_i_.find(name) != vars_i_.end();
+    return vars_.contains_i(name);
   }
 
   /**
@@ -275,16 +266,30 @@ class array_var_context : public var_context {
    *
    */
   std::vector<double> vals_r(const std::string& name) const {
-    const auto ret_val_r = vars_r_.find(name);
-    if (ret_val_r != vars_r_.end()) {
-      return ret_val_r->second.first;
-    } else {
-      const auto ret_val_i = vars_i_.find(name);
-      if (ret_val_i != vars_i_.end()) {
-        return {ret_val_i->second.first.begin(), ret_val_i->second.first.end()};
-      }
-    }
-    return empty_vec_r_;
+    return vars_.vals_r(name);
+  }
+
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Real values are viewed in place; integer values
+   * are converted into a view that owns them.
+   *
+   * @param name Name of variable.
+   * @return View of values of variable.
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    return vars_.vals_r_view(name);
+  }
+
+  /**
+   * Look up the variable with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable.
+   */
+  var_entry lookup(const std::string& name) const {
+    return vars_.lookup(name);
   }
 
   /**
@@ -295,16 +300,7 @@ class array_var_context : public var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_r(const std::string& name) const {
-    const auto ret_val_r = vars_r_.find(name);
-    if (ret_val_r != vars_r_.end()) {
-      return ret_val_r->second.second;
-    } else {
-      const auto ret_val_i = vars_i_.find(name);
-      if (ret_val_i != vars_i_.end()) {
-        return ret_val_i->second.second;
-      }
-    }
-    return empty_vec_ui_;
+    return vars_.dims_r(name);
   }
 
   /**
@@ -315,11 +311,18 @@ class array_var_context : public var_context {
    * @return Values.
    */
   std::vector<int> vals_i(const std::string& name) const {
-    auto ret_val_i = vars_i_.find(name);
-    if (ret_val_i != vars_i_.end()) {
-      return ret_val_i->second.first;
-    }
-    return empty_vec_i_;
+    return vars_.vals_i(name);
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name, without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of values.
+   */
+  vals_view<int> vals_i_view(const std::string& name) const {
+    return vars_.vals_i_view(name);
   }
 
   /**
@@ -330,11 +333,7 @@ class array_var_context : public var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_i(const std::string& name) const {
-    auto ret_val_i = vars_i_.find(name);
-    if (ret_val_i != vars_i_.end()) {
-      return ret_val_i->second.second;
-    }
-    return empty_vec_ui_;
+    return vars_.dims_i(name);
   }
 
   /**
@@ -361,11 +360,7 @@ class array_var_context : public var_context {
    * @param names Vector to store the list of names in.
    */
   virtual void names_r(std::vector<std::string>& names) const {
-    names.clear();
-    names.reserve(vars_r_.size());
-    for (const auto& vars_r_iter : vars_r_) {
-      names.push_back(vars_r_iter.first);
-    }
+    vars_.names_r(names);
   }
 
   /**
@@ -375,11 +370,7 @@ class array_var_context : public var_context {
    * @param names Vector to store the list of names in.
    */
   virtual void names_i(std::vector<std::string>& names) const {
-    names.clear();
-    names.reserve(vars_i_.size());
-    for (const auto& vars_i_iter : vars_r_) {
-      names.push_back(vars_i_iter.first);
-    }
+    vars_.names_i(names);
   }
 
   /**
@@ -390,7 +381,7 @@ class array_var_context : public var_context {
    *   returns <code>false</code>.
    */
   bool remove(const std::string& name) {
-    return (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    return vars_.erase(name);
   }
 };
 }  // namespace io
@@ -0,0 +1,182 @@
+#ifndef STAN_IO_BINARY_DATA_WRITER_HPP
+#define STAN_IO_BINARY_DATA_WRITER_HPP
+
+#include <stan/io/var_context.hpp>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Layout of the binary data format read by
+ * <code>mmap_var_context</code>.
+ *
+ * A file starts with a 16 byte header: the magic bytes
+ * <code>STANDATA</code>, the format version and a byte order mark,
+ * both <code>uint32</code>.  The header is followed by one record per
+ * variable, each starting on an 8 byte boundary:
+ *
+ * <ul>
+ * <li><code>uint32</code> length of the name in bytes</li>
+ * <li><code>uint32</code> type, <code>int_type</code> or
+ *     <code>real_type</code></li>
+ * <li><code>uint64</code> number of dimensions</li>
+ * <li><code>uint64</code> each dimension</li>
+ * <li>the name, padded with zeros to an 8 byte boundary</li>
+ * <li>the values in column-major order, as <code>int32</code> or
+ *     <code>double</code>, padded with zeros to an 8 byte
+ *     boundary</li>
+ * </ul>
+ *
+ * Numbers are stored in the byte order of the machine that wrote the
+ * file; the byte order mark lets readers reject files from machines
+ * with a different one.  As the values of every variable start on an
+ * 8 byte boundary, they can be used in place from a memory mapping of
+ * the file.
+ */
+struct binary_data_format {
+  static const char* magic() { return "STANDATA"; }
+  static const std::uint32_t version = 1;
+  static const std::uint32_t byte_order_mark = 0x01020304;
+  static const std::uint32_t int_type = 0;
+  static const std::uint32_t real_type = 1;
+  static const size_t header_size = 16;
+  static const size_t alignment = 8;
+
+  /**
+   * Return the number of bytes to add to the specified size to reach
+   * the next 8 byte boundary.
+   *
+   * @param size size in bytes
+   * @return padding in bytes
+   */
+  static size_t padding(size_t size) {
+    return (alignment - size % alignment) % alignment;
+  }
+};
+
+/**
+ * Writes variables to an output stream in the binary data format
+ * described by <code>binary_data_format</code>, to be read back with
+ * <code>mmap_var_context</code>.  The stream should be opened in
+ * binary mode.
+ */
+class binary_data_writer {
+ private:
+  std::ostream& out_;
+
+  template <typename T>
+  void write_raw(const T& x) {
+    out_.write(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+
+  void write_padding(size_t size) {
+    static const char zeros[binary_data_format::alignment] = {0};
+    out_.write(zeros, binary_data_format::padding(size));
+  }
+
+  template <typename T>
+  void write_var(const std::string& name, std::uint32_t type,
+                 const T* vals, size_t num_vals,
+                 const std::vector<size_t>& dims) {
+    size_t size = 1;
+    for (size_t d : dims)
+      size *= d;
+    if (size != num_vals)
+      throw std::invalid_argument("variable " + name + ": number of values"
+                                  " does not match dimensions");
+    write_raw(static_cast<std::uint32_t>(name.size()));
+    write_raw(type);
+    write_raw(static_cast<std::uint64_t>(dims.size()));
+    for (size_t d : dims)
+      write_raw(static_cast<std::uint64_t>(d));
+    out_.write(name.data(), name.size());
+    write_padding(name.size());
+    if (num_vals > 0)
+      out_.write(reinterpret_cast<const char*>(vals), num_vals * sizeof(T));
+    write_padding(num_vals * sizeof(T));
+    if (!out_)
+      throw std::runtime_error("error writing variable " + name);
+  }
+
+ public:
+  /**
+   * Construct a writer and write the file header.
+   *
+   * @param out output stream, opened in binary mode
+   */
+  explicit binary_data_writer(std::ostream& out) : out_(out) {
+    out_.write(binary_data_format::magic(), 8);
+    write_raw(std::uint32_t(binary_data_format::version));
+    write_raw(std::uint32_t(binary_data_format::byte_order_mark));
+  }
+
+  /**
+   * Write a real variable.
+   *
+   * @param name variable name
+   * @param vals values in column-major order
+   * @param dims dimensions; empty for a scalar
+   * @throw std::invalid_argument if the number of values does not
+   *   match the dimensions
+   */
+  void write(const std::string& name, const std::vector<double>& vals,
+             const std::vector<size_t>& dims) {
+    write_var(name, binary_data_format::real_type, vals.data(), vals.size(),
+              dims);
+  }
+
+  /**
+   * Write an integer variable.
+   *
+   * @param name variable name
+   * @param vals values in column-major order
+   * @param dims dimensions; empty for a scalar
+   * @throw std::invalid_argument if the number of values does not
+   *   match the dimensions
+   */
+  void write(const std::string& name, const std::vector<int>& vals,
+             const std::vector<size_t>& dims) {
+    static_assert(sizeof(int) == sizeof(std::int32_t),
+                  "binary data format stores int as int32");
+    write_var(name, binary_data_format::int_type, vals.data(), vals.size(),
+              dims);
+  }
+
+  /**
+   * Write every variable of a <code>var_context</code>, for instance
+   * to convert a data file in dump or JSON format.  Integer variables
+   * are written as integers.  Values are read through views, so they
+   * are not copied out of contexts that store them.
+   *
+   * @param context variables to write
+   */
+  void write(const var_context& context) {
+    static_assert(sizeof(int) == sizeof(std::int32_t),
+                  "binary data format stores int as int32");
+    std::vector<std::string> names;
+    context.names_i(names);
+    for (const std::string& name : names) {
+      vals_view<int> vals = context.vals_i_view(name);
+      write_var(name, binary_data_format::int_type, vals.data(), vals.size(),
+                context.dims_i(name));
+    }
+    context.names_r(names);
+    for (const std::string& name : names) {
+      if (context.contains_i(name))
+        continue;
+      vals_view<double> vals = context.vals_r_view(name);
+      write_var(name, binary_data_format::real_type, vals.data(),
+                vals.size(), context.dims_r(name));
+    }
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
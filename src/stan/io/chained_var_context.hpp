@@ -31,11 +31,27 @@ class chained_var_context : public var_context {
   }
 
   std::vector<double> vals_r(const std::string& name) const {
-    return vc1_.contains_r(name) ? vc1_.vals_r(name) : vc2_.vals_r(name);
+    var_entry entry = vc1_.lookup(name);
+    if (!entry)
+      return vc2_.vals_r(name);
+    if (entry.is_int)
+      return std::vector<double>(entry.vals_i.begin(), entry.vals_i.end());
+    return entry.vals_r.to_vector();
   }
 
   std::vector<int> vals_i(const std::string& name) const {
-    return vc1_.contains_i(name) ? vc1_.vals_i(name) : vc2_.vals_i(name);
+    var_entry entry = vc1_.lookup(name);
+    return entry.is_int ? entry.vals_i.to_vector() : vc2_.vals_i(name);
+  }
+
+  vals_view<double> vals_r_view(const std::string& name) const {
+    var_entry entry = vc1_.lookup(name);
+    return entry ? entry.real_vals() : vc2_.vals_r_view(name);
+  }
+
+  vals_view<int> vals_i_view(const std::string& name) const {
+    var_entry entry = vc1_.lookup(name);
+    return entry.is_int ? entry.vals_i : vc2_.vals_i_view(name);
   }
 
   std::vector<size_t> dims_r(const std::string& name) const {
@@ -43,7 +59,21 @@ class chained_var_context : public var_context {
   }
 
   std::vector<size_t> dims_i(const std::string& name) const {
-    return vc1_.contains_r(name) ? vc1_.dims_i(name) : vc2_.dims_i(name);
+    return vc1_.contains_i(name) ? vc1_.dims_i(name) : vc2_.dims_i(name);
+  }
+
+  /**
+   * Look up the variable with the specified name in the first context
+   * and, if it is not defined there, in the second.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable.
+   */
+  var_entry lookup(const std::string& name) const {
+    var_entry entry = vc1_.lookup(name);
+    if (entry)
+      return entry;
+    return vc2_.lookup(name);
   }
 
   void names_r(std::vector<std::string>& names) const {
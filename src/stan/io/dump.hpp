@@ -1,14 +1,16 @@
 #ifndef STAN_IO_DUMP_HPP
 #define STAN_IO_DUMP_HPP
 
+#include <stan/io/parse_double.hpp>
 #include <stan/io/validate_zero_buf.hpp>
 #include <stan/io/validate_dims.hpp>
 #include <stan/io/var_context.hpp>
+#include <stan/io/var_index.hpp>
 #include <stan/math/prim.hpp>
 #include <boost/lexical_cast.hpp>
+#include <cmath>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -128,6 +130,24 @@ class dump_reader {
     return true;
   }
 
+  /**
+   * Skips whitespace and returns the next character without
+   * consuming it, reading straight from the stream buffer.  Sets
+   * <code>eofbit</code> and returns <code>EOF</code> at the end of
+   * the input.
+   *
+   * @return next non-whitespace character or <code>EOF</code>
+   */
+  int peek_nonspace() {
+    std::streambuf* buf = in_.rdbuf();
+    int c = buf->sgetc();
+    while (c != EOF && std::isspace(c))
+      c = buf->snextc();
+    if (c == EOF)
+      in_.setstate(std::ios::eofbit);
+    return c;
+  }
+
   bool scan_optional_long() {
     if (scan_single_char('l'))
       return true;
@@ -138,14 +158,13 @@ class dump_reader {
   }
 
   bool scan_char(char c_expected) {
-    char c;
-    in_ >> c;
-    if (in_.fail())
-      return false;
-    if (c != c_expected) {
-      in_.putback(c);
+    if (!in_.good() || peek_nonspace() == EOF) {
+      in_.setstate(std::ios::failbit);
       return false;
     }
+    if (in_.rdbuf()->sgetc() != c_expected)
+      return false;
+    in_.rdbuf()->sbumpc();
     return true;
   }
 
@@ -268,9 +287,16 @@ class dump_reader {
 
   int get_int() {
     int n = 0;
-    try {
-      n = boost::lexical_cast<int>(buf_);
-    } catch (const boost::bad_lexical_cast& exc) {
+    bool ok = !buf_.empty();
+    for (size_t i = 0; ok && i < buf_.size(); ++i) {
+      int digit = buf_[i] - '0';
+      ok = digit >= 0 && digit <= 9
+           && n <= (std::numeric_limits<int>::max() - digit) / 10;
+      if (!ok)
+        break;
+      n = 10 * n + digit;
+    }
+    if (!ok) {
       std::string msg = "value " + buf_ + " beyond int range";
       throw std::invalid_argument(msg);
     }
@@ -279,8 +305,12 @@ class dump_reader {
 
   double scan_double() {
     double x = 0;
+    const char* first = buf_.c_str();
+    const char* last = first + buf_.size();
     try {
-      x = boost::lexical_cast<double>(buf_);
+      if (buf_.empty() || parse_double(first, last, x) != last
+          || std::isinf(x))
+        throw boost::bad_lexical_cast();
       if (x == 0)
         validate_zero_buf(buf_);
     } catch (const boost::bad_lexical_cast& exc) {
@@ -290,55 +320,62 @@ class dump_reader {
     return x;
   }
 
+  static bool is_number_char(int c) {
+    return std::isdigit(c) || c == '.' || c == 'e' || c == 'E' || c == '-'
+           || c == '+';
+  }
+
   // scan number stores number or throws bad lexical cast exception
   void scan_number(bool negate_val) {
-    // must take longest first!
-    if (scan_chars("Inf")) {
-      scan_chars("inity");  // read past if there
-      stack_r_.push_back(negate_val ? -std::numeric_limits<double>::infinity()
-                                    : std::numeric_limits<double>::infinity());
-      return;
-    }
-    if (scan_chars("NaN", false)) {
-      stack_r_.push_back(std::numeric_limits<double>::quiet_NaN());
-      return;
+    std::streambuf* buf = in_.rdbuf();
+    int c = in_.good() ? buf->sgetc() : EOF;
+    if (!is_number_char(c)) {
+      // must take longest first!
+      if (scan_chars("Inf")) {
+        scan_chars("inity");  // read past if there
+        stack_r_.push_back(negate_val
+                               ? -std::numeric_limits<double>::infinity()
+                               : std::numeric_limits<double>::infinity());
+        return;
+      }
+      if (scan_chars("NaN", false)) {
+        stack_r_.push_back(std::numeric_limits<double>::quiet_NaN());
+        return;
+      }
+      c = in_.good() ? buf->sgetc() : EOF;
     }
 
-    char c;
+    // read the token straight from the stream buffer
     bool is_double = false;
     buf_.clear();
-    while (in_.get(c)) {
-      if (std::isdigit(c)) {  // before pre-scan || c == '-' || c == '+') {
-        buf_.push_back(c);
-      } else if (c == '.' || c == 'e' || c == 'E' || c == '-' || c == '+') {
+    while (c != EOF && is_number_char(c)) {
+      if (!std::isdigit(c))
         is_double = true;
-        buf_.push_back(c);
-      } else {
-        in_.putback(c);
-        break;
-      }
+      buf_.push_back(static_cast<char>(c));
+      c = buf->snextc();
     }
+    if (c == EOF)
+      in_.setstate(std::ios::eofbit);
+
     if (!is_double && stack_r_.size() == 0) {
       int n = get_int();
       stack_i_.push_back(negate_val ? -n : n);
-      scan_optional_long();
+      if (c == 'l' || c == 'L')
+        buf->sbumpc();
     } else {
-      for (size_t j = 0; j < stack_i_.size(); ++j)
-        stack_r_.push_back(static_cast<double>(stack_i_[j]));
-      stack_i_.clear();
+      if (!stack_i_.empty()) {
+        stack_r_.reserve(2 * stack_i_.size());
+        stack_r_.assign(stack_i_.begin(), stack_i_.end());
+        stack_i_.clear();
+      }
       double x = scan_double();
       stack_r_.push_back(negate_val ? -x : x);
     }
   }
 
   void scan_number() {
-    char c;
-    while (in_.get(c)) {
-      if (std::isspace(c))
-        continue;
-      in_.putback(c);
-      break;
-    }
+    if (in_.good())
+      peek_nonspace();
     bool negate_val = scan_char('-');
     if (!negate_val)
       scan_char('+');  // flush leading +
@@ -546,6 +583,31 @@ class dump_reader {
    */
   std::vector<double> double_values() { return stack_r_; }
 
+  /**
+   * Moves the integer values from the last item into the specified
+   * vector without copying them.  The reader's integer values are
+   * left empty.
+   *
+   * @param[out] values Integer values of last item.
+   */
+  void move_int_values(std::vector<int>& values) {
+    values = std::move(stack_i_);
+    stack_i_.clear();
+  }
+
+  /**
+   * Moves the floating point values from the last item into the
+   * specified vector without copying them.  The reader's floating
+   * point values are left empty, so the item no longer reads as
+   * floating point.
+   *
+   * @param[out] values Floating point values of last item.
+   */
+  void move_double_values(std::vector<double>& values) {
+    values = std::move(stack_r_);
+    stack_r_.clear();
+  }
+
   /**
    * Read the next value from the input stream, returning
    * <code>true</code> if successful and <code>false</code> if no
@@ -596,25 +658,7 @@ class dump_reader {
  */
 class dump : public stan::io::var_context {
  private:
-  std::map<std::string, std::pair<std::vector<double>, std::vector<size_t> > >
-      vars_r_;
-  std::map<std::string, std::pair<std::vector<int>, std::vector<size_t> > >
-      vars_i_;
-  std::vector<double> const empty_vec_r_;
-  std::vector<int> const empty_vec_i_;
-  std::vector<size_t> const empty_vec_ui_;
-  /**
-   * Return <code>true</code> if this dump contains the specified
-   * variable name is defined in the real values. This method
-   * returns <code>false</code> if the values are all integers.
-   *
-   * @param name Variable name to test.
-   * @return <code>true</code> if the variable exists in the
-   * real values of the dump.
-   */
-  bool contains_r_only(const std::string& name) const {
-    return vars_r_.find(name) != vars_r_.end();
-  }
+  var_index vars_;
 
  public:
   /**
@@ -628,14 +672,13 @@ class dump : public stan::io::var_context {
     dump_reader reader(in);
     while (reader.next()) {
       if (reader.is_int()) {
-        vars_i_[reader.name()]
-            = std::pair<std::vector<int>, std::vector<size_t> >(
-                reader.int_values(), reader.dims());
-
+        var_index::var& var = vars_.insert_i(reader.name());
+        reader.move_int_values(var.vals_i);
+        var.dims = reader.dims();
       } else {
-        vars_r_[reader.name()]
-            = std::pair<std::vector<double>, std::vector<size_t> >(
-                reader.double_values(), reader.dims());
+        var_index::var& var = vars_.insert_r(reader.name());
+        reader.move_double_values(var.vals_r);
+        var.dims = reader.dims();
       }
     }
   }
@@ -649,7 +692,7 @@ class dump : public stan::io::var_context {
    * @return <code>true</code> if the variable exists.
    */
   bool contains_r(const std::string& name) const {
-    return contains_r_only(name) || contains_i(name);
+    return vars_.contains_r(name);
   }
 
   /**
@@ -661,7 +704,7 @@ class dump : public stan::io::var_context {
    * array value.
    */
   bool contains_i(const std::string& name) const {
-    return vars_i_.find(name) != vars_i_.end();
+    return vars_.contains_i(name);
   }
 
   /**
@@ -672,17 +715,41 @@ class dump : public stan::io::var_context {
    * @return Values of variable.
    */
   std::vector<double> vals_r(const std::string& name) const {
-    if (contains_r_only(name)) {
-      return (vars_r_.find(name)->second).first;
-    } else if (contains_i(name)) {
-      std::vector<int> vec_int = (vars_i_.find(name)->second).first;
-      std::vector<double> vec_r(vec_int.size());
-      for (size_t ii = 0; ii < vec_int.size(); ii++) {
-        vec_r[ii] = vec_int[ii];
-      }
-      return vec_r;
-    }
-    return empty_vec_r_;
+    return vars_.vals_r(name);
+  }
+
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Real values are viewed in place; integer values
+   * are converted into a view that owns them.
+   *
+   * @param name Name of variable.
+   * @return View of values of variable.
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    return vars_.vals_r_view(name);
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name, without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of values.
+   */
+  vals_view<int> vals_i_view(const std::string& name) const {
+    return vars_.vals_i_view(name);
+  }
+
+  /**
+   * Look up the variable with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable.
+   */
+  var_entry lookup(const std::string& name) const {
+    return vars_.lookup(name);
   }
 
   /**
@@ -693,12 +760,7 @@ class dump : public stan::io::var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_r(const std::string& name) const {
-    if (contains_r_only(name)) {
-      return (vars_r_.find(name)->second).second;
-    } else if (contains_i(name)) {
-      return (vars_i_.find(name)->second).second;
-    }
-    return empty_vec_ui_;
+    return vars_.dims_r(name);
   }
 
   /**
@@ -709,10 +771,7 @@ class dump : public stan::io::var_context {
    * @return Values.
    */
   std::vector<int> vals_i(const std::string& name) const {
-    if (contains_i(name)) {
-      return (vars_i_.find(name)->second).first;
-    }
-    return empty_vec_i_;
+    return vars_.vals_i(name);
   }
 
   /**
@@ -723,10 +782,7 @@ class dump : public stan::io::var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_i(const std::string& name) const {
-    if (contains_i(name)) {
-      return (vars_i_.find(name)->second).second;
-    }
-    return empty_vec_ui_;
+    return vars_.dims_i(name);
   }
 
   /**
@@ -736,13 +792,7 @@ class dump : public stan::io::var_context {
    * @param names Vector to store the list of names in.
    */
   virtual void names_r(std::vector<std::string>& names) const {
-    names.resize(0);
-    for (std::map<std::string, std::pair<std::vector<double>,
-                                         std::vector<size_t> > >::const_iterator
-             it
-         = vars_r_.begin();
-         it != vars_r_.end(); ++it)
-      names.push_back((*it).first);
+    vars_.names_r(names);
   }
 
   /**
@@ -752,13 +802,7 @@ class dump : public stan::io::var_context {
    * @param names Vector to store the list of names in.
    */
   virtual void names_i(std::vector<std::string>& names) const {
-    names.resize(0);
-    for (std::map<std::string, std::pair<std::vector<int>,
-                                         std::vector<size_t> > >::const_iterator
-             it
-         = vars_i_.begin();
-         it != vars_i_.end(); ++it)
-      names.push_back((*it).first);
+    vars_.names_i(names);
   }
 
   /**
@@ -785,7 +829,7 @@ class dump : public stan::io::var_context {
    *   returns <code>false</code>.
    */
   bool remove(const std::string& name) {
-    return (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    return vars_.erase(name);
   }
 };
 
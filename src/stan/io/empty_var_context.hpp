@@ -68,6 +68,34 @@ class empty_var_context : public var_context {
     return std::vector<int>();
   }
 
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    return vals_view<double>();
+  }
+
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  vals_view<int> vals_i_view(const std::string& name) const {
+    return vals_view<int>();
+  }
+
+  /**
+   * Always returns an entry for a variable that is not defined.
+   *
+   * @param name Name of variable.
+   * @return entry that is not found
+   */
+  var_entry lookup(const std::string& name) const { return var_entry(); }
+
   /**
    * Return the dimensions of the specified floating point variable.
    * Returns an empty vector.
@@ -0,0 +1,194 @@
+#ifndef STAN_IO_INCLUDE_CACHE_HPP
+#define STAN_IO_INCLUDE_CACHE_HPP
+
+#include <stan/io/read_line.hpp>
+#include <stan/io/starts_with.hpp>
+#include <stan/io/trim_spaces.hpp>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * The text of a program file split at its <code>#include</code>
+ * statements, which is all <code>program_reader</code> needs to
+ * splice the file into a program and record its history.
+ *
+ * The file is a sequence of segments, each holding a run of ordinary
+ * lines, concatenated, followed by an include statement, except for
+ * the last segment, which has none.  Line numbers are relative to the
+ * start of the file, so the same source can be spliced in at any
+ * position of any program.
+ */
+struct program_source {
+  struct segment {
+    /**
+     * Ordinary lines, including their line terminators.
+     */
+    std::string text;
+
+    /**
+     * Number of ordinary lines in <code>text</code>.
+     */
+    int num_lines;
+
+    /**
+     * Line holding the include statement after the text, or empty
+     * for the last segment.
+     */
+    std::string include_line;
+
+    segment() : num_lines(0) {}
+  };
+
+  std::vector<segment> segments;
+
+  /**
+   * Split the program read from the specified stream.
+   *
+   * @param[in] in stream to read
+   * @return split program
+   */
+  static std::shared_ptr<const program_source> scan(std::istream& in) {
+    std::shared_ptr<program_source> source
+        = std::make_shared<program_source>();
+    segment seg;
+    while (true) {
+      std::string line = read_line(in);
+      if (line.empty()) {
+        source->segments.push_back(std::move(seg));
+        break;
+      } else if (starts_with("#include ", trim_spaces(line))) {
+        seg.include_line = std::move(line);
+        source->segments.push_back(std::move(seg));
+        seg = segment();
+      } else {
+        seg.text += line;
+        ++seg.num_lines;
+      }
+    }
+    return source;
+  }
+
+  /**
+   * Split the program in the file with the specified path.
+   *
+   * @param[in] path path of file
+   * @return split program or <code>nullptr</code> if the file can
+   * not be opened
+   */
+  static std::shared_ptr<const program_source> load(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in.good())
+      return nullptr;
+    return scan(in);
+  }
+};
+
+/**
+ * Cache of the included files read by <code>program_reader</code>,
+ * which can be shared by any number of readers, including readers
+ * constructed concurrently.
+ *
+ * Files are keyed on their path, and a cached file is only used while
+ * the file's modification time and size are the ones it was read
+ * with; otherwise it is read again.  A lookup of a cached file costs
+ * a <code>stat</code> call instead of reading and scanning the file.
+ * Modification times have a resolution of a second, so a file
+ * rewritten with the same size within a second of being cached is
+ * not noticed; call <code>clear</code> after editing files in place.
+ */
+class include_cache {
+ private:
+  struct entry {
+    time_t mtime;
+    off_t size;
+    std::shared_ptr<const program_source> source;
+  };
+
+  std::unordered_map<std::string, entry> files_;
+  std::size_t hits_;
+  std::size_t misses_;
+  mutable std::mutex mutex_;
+
+ public:
+  include_cache() : hits_(0), misses_(0) {}
+
+  /**
+   * Return the split program in the file with the specified path,
+   * from the cache if the file is unchanged since it was cached.
+   *
+   * @param[in] path path of file
+   * @return split program or <code>nullptr</code> if the file can
+   * not be opened
+   */
+  std::shared_ptr<const program_source> load(const std::string& path) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+      return program_source::load(path);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = files_.find(path);
+      if (it != files_.end() && it->second.mtime == info.st_mtime
+          && it->second.size == info.st_size) {
+        ++hits_;
+        return it->second.source;
+      }
+    }
+    std::shared_ptr<const program_source> source = program_source::load(path);
+    if (source == nullptr)
+      return source;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++misses_;
+    entry& e = files_[path];
+    e.mtime = info.st_mtime;
+    e.size = info.st_size;
+    e.source = source;
+    return source;
+  }
+
+  /**
+   * Remove all files from the cache.
+   */
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_.clear();
+  }
+
+  /**
+   * Return the number of files in the cache.
+   */
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.size();
+  }
+
+  /**
+   * Return the number of loads served from the cache.
+   */
+  std::size_t hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /**
+   * Return the number of loads that read a file into the cache.
+   */
+  std::size_t misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,408 @@
+#ifndef STAN_IO_JSON_DATA_HPP
+#define STAN_IO_JSON_DATA_HPP
+
+#include <stan/io/json_parser.hpp>
+#include <stan/io/validate_dims.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/io/var_index.hpp>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Handler for <code>json_parser</code> that collects the variables of
+ * a JSON data file as they are parsed.
+ *
+ * The file must be a single object whose members are the variables.
+ * A member is either a number or a rectangular array of numbers,
+ * nested to any depth.  The values are written straight into one
+ * contiguous buffer per variable in the order they are read, which
+ * for nested arrays is row-major, and put into the column-major
+ * order of <code>var_context</code> once the variable is complete.
+ * A variable is integer unless one of its values is not, in which
+ * case the values read so far are converted to doubles once.
+ *
+ * The strings <code>"NaN"</code>, <code>"Inf"</code>,
+ * <code>"Infinity"</code>, <code>"-Inf"</code> and
+ * <code>"-Infinity"</code> are read as the corresponding doubles.
+ */
+class json_data_handler {
+ private:
+  var_index& vars_;
+  int object_depth_;
+  std::string name_;
+  bool is_real_;
+  std::vector<int> vals_i_;
+  std::vector<double> vals_r_;
+  size_t level_;
+  size_t max_level_;
+  size_t rank_;
+  std::vector<size_t> counts_;
+  std::vector<size_t> dims_;
+  std::vector<bool> dims_known_;
+
+  void error(const std::string& what) const {
+    throw std::invalid_argument("variable " + name_ + ": " + what);
+  }
+
+  void begin_value() {
+    if (object_depth_ != 1)
+      throw std::invalid_argument(
+          "JSON data must be an object whose members are the variables");
+    if (level_ == 0)
+      return;
+    if (rank_ != 0 && level_ > rank_)
+      error("non-rectangular array");
+    ++counts_[level_ - 1];
+  }
+
+  void add_scalar() {
+    if (level_ == 0)
+      return;
+    if (rank_ == 0) {
+      if (max_level_ != level_)
+        error("non-rectangular array");
+      rank_ = level_;
+    } else if (rank_ != level_) {
+      error("non-rectangular array");
+    }
+  }
+
+  template <typename T>
+  static void to_column_major(std::vector<T>& vals,
+                              const std::vector<size_t>& dims) {
+    if (dims.size() < 2 || vals.size() < 2)
+      return;
+    size_t rank = dims.size();
+    std::vector<size_t> stride(rank, 1);
+    for (size_t k = 1; k < rank; ++k)
+      stride[k] = stride[k - 1] * dims[k - 1];
+    std::vector<T> column_major(vals.size());
+    std::vector<size_t> idx(rank, 0);
+    size_t col = 0;
+    for (size_t row = 0; row < vals.size(); ++row) {
+      column_major[col] = vals[row];
+      // advance the row-major odometer, last index fastest
+      for (size_t k = rank; k-- > 0;) {
+        if (++idx[k] < dims[k]) {
+          col += stride[k];
+          break;
+        }
+        col -= stride[k] * (dims[k] - 1);
+        idx[k] = 0;
+      }
+    }
+    vals.swap(column_major);
+  }
+
+  void finish_var() {
+    std::vector<size_t> dims;
+    if (max_level_ > 0) {
+      size_t rank = rank_ != 0 ? rank_ : max_level_;
+      dims.assign(dims_.begin(), dims_.begin() + rank);
+    }
+    if (vars_.contains_r(name_))
+      error("duplicate variable name");
+    if (is_real_) {
+      to_column_major(vals_r_, dims);
+      var_index::var& var = vars_.insert_r(name_);
+      var.vals_r.swap(vals_r_);
+      var.dims.swap(dims);
+    } else {
+      to_column_major(vals_i_, dims);
+      var_index::var& var = vars_.insert_i(name_);
+      var.vals_i.swap(vals_i_);
+      var.dims.swap(dims);
+    }
+  }
+
+ public:
+  explicit json_data_handler(var_index& vars)
+      : vars_(vars),
+        object_depth_(0),
+        is_real_(false),
+        level_(0),
+        max_level_(0),
+        rank_(0) {}
+
+  void start_object() {
+    if (object_depth_ != 0)
+      error("nested objects are not supported");
+    ++object_depth_;
+  }
+
+  void end_object() { --object_depth_; }
+
+  void key(const std::string& name) {
+    name_ = name;
+    is_real_ = false;
+    vals_i_.clear();
+    vals_r_.clear();
+    level_ = 0;
+    max_level_ = 0;
+    rank_ = 0;
+    counts_.clear();
+    dims_.clear();
+    dims_known_.clear();
+  }
+
+  void start_array() {
+    begin_value();
+    if (rank_ != 0 && level_ >= rank_)
+      error("non-rectangular array");
+    ++level_;
+    if (counts_.size() < level_) {
+      counts_.push_back(0);
+      dims_.push_back(0);
+      dims_known_.push_back(false);
+    }
+    counts_[level_ - 1] = 0;
+    if (level_ > max_level_)
+      max_level_ = level_;
+  }
+
+  void end_array() {
+    size_t n = counts_[level_ - 1];
+    if (!dims_known_[level_ - 1]) {
+      dims_[level_ - 1] = n;
+      dims_known_[level_ - 1] = true;
+    } else if (dims_[level_ - 1] != n) {
+      error("non-rectangular array");
+    }
+    --level_;
+    if (level_ == 0)
+      finish_var();
+  }
+
+  void int_value(int n) {
+    begin_value();
+    add_scalar();
+    if (is_real_)
+      vals_r_.push_back(n);
+    else
+      vals_i_.push_back(n);
+    if (level_ == 0)
+      finish_var();
+  }
+
+  void double_value(double x) {
+    begin_value();
+    add_scalar();
+    if (!is_real_) {
+      is_real_ = true;
+      vals_r_.reserve(2 * vals_i_.size());
+      vals_r_.assign(vals_i_.begin(), vals_i_.end());
+      vals_i_.clear();
+    }
+    vals_r_.push_back(x);
+    if (level_ == 0)
+      finish_var();
+  }
+
+  void string_value(const std::string& s) {
+    if (s == "NaN")
+      double_value(std::numeric_limits<double>::quiet_NaN());
+    else if (s == "Inf" || s == "Infinity")
+      double_value(std::numeric_limits<double>::infinity());
+    else if (s == "-Inf" || s == "-Infinity")
+      double_value(-std::numeric_limits<double>::infinity());
+    else
+      error("string values are not supported");
+  }
+
+  void bool_value(bool) { error("boolean values are not supported"); }
+
+  void null_value() { error("null values are not supported"); }
+};
+
+/**
+ * Represents named arrays with dimensions read from JSON.
+ *
+ * The input is a JSON object whose members are the variables, each a
+ * number or a rectangular array of numbers nested to any depth, for
+ * example
+ *
+ * <code>{ "N": 3, "y": [1.5, 2, "NaN"], "x": [[1, 2], [3, 4], [5, 6]] }</code>
+ *
+ * Nested arrays give the dimensions of the variable, outermost
+ * first, so <code>x</code> above has dimensions <code>(3, 2)</code>
+ * and <code>x[i][j]</code> is the JSON element <code>x[i-1][j-1]</code>.
+ * Values are stored in column-major order, like the other
+ * <code>var_context</code> implementations.
+ *
+ * <p>A variable is integer if every value is written as an integer
+ * that fits in an <code>int</code>, otherwise it is real.  Empty
+ * arrays are integer.  Infinite and not-a-number values may be
+ * written as the strings <code>"Infinity"</code>,
+ * <code>"-Infinity"</code> and <code>"NaN"</code> or as the bare
+ * words <code>Infinity</code>, <code>-Infinity</code> and
+ * <code>NaN</code>.
+ *
+ * <p>The input is read in a single pass with no intermediate document
+ * tree; see <code>json_parser</code>.
+ */
+class json_data : public stan::io::var_context {
+ private:
+  var_index vars_;
+
+ public:
+  /**
+   * Construct a JSON data object from the specified input stream.
+   *
+   * <b>Warning:</b> This method does not close the input stream.
+   *
+   * @param in Input stream from which to read.
+   * @throw std::invalid_argument if the input is not valid JSON or
+   *   not valid data
+   */
+  explicit json_data(std::istream& in) {
+    json_data_handler handler(vars_);
+    parse_json(in, handler);
+  }
+
+  /**
+   * Return <code>true</code> if the specified variable name is
+   * defined. This method returns <code>true</code> even if the values
+   * are all integers.
+   *
+   * @param name Variable name to test.
+   * @return <code>true</code> if the variable exists.
+   */
+  bool contains_r(const std::string& name) const {
+    return vars_.contains_r(name);
+  }
+
+  /**
+   * Return <code>true</code> if an integer valued array with the
+   * specified name is defined.
+   *
+   * @param name Variable name to test.
+   * @return <code>true</code> if the variable name has an integer
+   * array value.
+   */
+  bool contains_i(const std::string& name) const {
+    return vars_.contains_i(name);
+  }
+
+  /**
+   * Return the double values for the variable with the specified
+   * name or an empty vector if it is not defined.
+   *
+   * @param name Name of variable.
+   * @return Values of variable.
+   */
+  std::vector<double> vals_r(const std::string& name) const {
+    return vars_.vals_r(name);
+  }
+
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Real values are viewed in place; integer values
+   * are converted into a view that owns them.
+   *
+   * @param name Name of variable.
+   * @return View of values of variable.
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    return vars_.vals_r_view(name);
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name, without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of values.
+   */
+  vals_view<int> vals_i_view(const std::string& name) const {
+    return vars_.vals_i_view(name);
+  }
+
+  /**
+   * Look up the variable with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable.
+   */
+  var_entry lookup(const std::string& name) const {
+    return vars_.lookup(name);
+  }
+
+  /**
+   * Return the dimensions for the double variable with the specified
+   * name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_r(const std::string& name) const {
+    return vars_.dims_r(name);
+  }
+
+  /**
+   * Return the integer values for the variable with the specified
+   * name.
+   *
+   * @param name Name of variable.
+   * @return Values.
+   */
+  std::vector<int> vals_i(const std::string& name) const {
+    return vars_.vals_i(name);
+  }
+
+  /**
+   * Return the dimensions for the integer variable with the specified
+   * name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_i(const std::string& name) const {
+    return vars_.dims_i(name);
+  }
+
+  /**
+   * Return a list of the names of the floating point variables.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  virtual void names_r(std::vector<std::string>& names) const {
+    vars_.names_r(names);
+  }
+
+  /**
+   * Return a list of the names of the integer variables.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  virtual void names_i(std::vector<std::string>& names) const {
+    vars_.names_i(names);
+  }
+
+  /**
+   * Check variable dimensions against variable declaration.
+   *
+   * @param stage stan program processing stage
+   * @param name variable name
+   * @param base_type declared stan variable type
+   * @param dims_declared variable dimensions
+   * @throw std::runtime_error if mismatch between declared
+   *        dimensions and dimensions found in context.
+   */
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
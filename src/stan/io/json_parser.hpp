@@ -0,0 +1,367 @@
+#ifndef STAN_IO_JSON_PARSER_HPP
+#define STAN_IO_JSON_PARSER_HPP
+
+#include <stan/io/parse_double.hpp>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Single pass, SAX style parser for JSON read from an input stream.
+ *
+ * The parser reports what it reads to a handler as it goes, without
+ * building a document tree.  The handler must provide the methods
+ *
+ * <ul>
+ * <li><code>void start_object()</code></li>
+ * <li><code>void end_object()</code></li>
+ * <li><code>void key(const std::string&)</code></li>
+ * <li><code>void start_array()</code></li>
+ * <li><code>void end_array()</code></li>
+ * <li><code>void int_value(int)</code></li>
+ * <li><code>void double_value(double)</code></li>
+ * <li><code>void string_value(const std::string&)</code></li>
+ * <li><code>void bool_value(bool)</code></li>
+ * <li><code>void null_value()</code></li>
+ * </ul>
+ *
+ * Numbers written without a fraction or exponent that fit in an
+ * <code>int</code> are reported as integers and all other numbers as
+ * doubles.  As an extension to JSON, the bare words
+ * <code>NaN</code>, <code>Infinity</code> and <code>-Infinity</code>
+ * are read as doubles.
+ *
+ * The stream is read in blocks straight from its stream buffer.
+ *
+ * @tparam Handler type of handler
+ */
+template <typename Handler>
+class json_parser {
+ private:
+  std::istream& in_;
+  Handler& handler_;
+  std::vector<char> buf_;
+  size_t pos_;
+  size_t end_;
+  size_t line_;
+  size_t column_;
+  std::string token_;
+
+  bool fill() {
+    if (pos_ < end_)
+      return true;
+    end_ = in_.rdbuf()->sgetn(buf_.data(), buf_.size());
+    pos_ = 0;
+    return end_ > 0;
+  }
+
+  int peek() {
+    return fill() ? static_cast<unsigned char>(buf_[pos_]) : EOF;
+  }
+
+  int get() {
+    if (!fill())
+      return EOF;
+    int c = static_cast<unsigned char>(buf_[pos_++]);
+    if (c == '\n') {
+      ++line_;
+      column_ = 0;
+    } else {
+      ++column_;
+    }
+    return c;
+  }
+
+  void error(const std::string& what) {
+    std::stringstream msg;
+    msg << "Error in JSON parsing at line " << line_ << ", column "
+        << column_ << ": " << what;
+    throw std::invalid_argument(msg.str());
+  }
+
+  int peek_nonspace() {
+    int c = peek();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      get();
+      c = peek();
+    }
+    return c;
+  }
+
+  void expect(const char* word) {
+    for (const char* p = word; *p; ++p)
+      if (get() != *p)
+        error(std::string("expected ") + word);
+  }
+
+  void parse_string(std::string& s) {
+    s.clear();
+    get();  // opening quote
+    while (true) {
+      int c = get();
+      if (c == EOF)
+        error("unterminated string");
+      if (c == '"')
+        return;
+      if (c != '\\') {
+        s.push_back(static_cast<char>(c));
+        continue;
+      }
+      c = get();
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          s.push_back(static_cast<char>(c));
+          break;
+        case 'b':
+          s.push_back('\b');
+          break;
+        case 'f':
+          s.push_back('\f');
+          break;
+        case 'n':
+          s.push_back('\n');
+          break;
+        case 'r':
+          s.push_back('\r');
+          break;
+        case 't':
+          s.push_back('\t');
+          break;
+        case 'u': {
+          unsigned code = 0;
+          for (int i = 0; i < 4; ++i) {
+            int h = get();
+            code <<= 4;
+            if (h >= '0' && h <= '9')
+              code |= h - '0';
+            else if (h >= 'a' && h <= 'f')
+              code |= h - 'a' + 10;
+            else if (h >= 'A' && h <= 'F')
+              code |= h - 'A' + 10;
+            else
+              error("bad unicode escape in string");
+          }
+          // encode the basic multilingual plane as UTF-8
+          if (code < 0x80) {
+            s.push_back(static_cast<char>(code));
+          } else if (code < 0x800) {
+            s.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            s.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+          } else {
+            s.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            s.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+          }
+          break;
+        }
+        default:
+          error("bad escape in string");
+      }
+    }
+  }
+
+  void parse_number() {
+    token_.clear();
+    bool is_int = true;
+    int c = peek();
+    while (c != EOF
+           && ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.'
+               || c == 'e' || c == 'E')) {
+      if (c == '.' || c == 'e' || c == 'E')
+        is_int = false;
+      token_.push_back(static_cast<char>(get()));
+      c = peek();
+    }
+
+    if (token_ == "-" && c == 'I') {
+      expect("Infinity");
+      handler_.double_value(-std::numeric_limits<double>::infinity());
+      return;
+    }
+
+    const char* first = token_.c_str();
+    const char* last = first + token_.size();
+    if (is_int) {
+      const char* p = first + (*first == '-');
+      std::int64_t n = 0;
+      bool ok = p < last;
+      for (; ok && p < last; ++p) {
+        ok = *p >= '0' && *p <= '9';
+        n = 10 * n + (*p - '0');
+        if (n > std::numeric_limits<int>::max() + std::int64_t(1))
+          break;
+      }
+      if (!ok)
+        error("bad number " + token_);
+      if (*first == '-')
+        n = -n;
+      if (p == last && n >= std::numeric_limits<int>::min()
+          && n <= std::numeric_limits<int>::max()) {
+        handler_.int_value(static_cast<int>(n));
+        return;
+      }
+    }
+    double x;
+    if (parse_double(first, last, x) != last)
+      error("bad number " + token_);
+    if (x == std::numeric_limits<double>::infinity()
+        || x == -std::numeric_limits<double>::infinity())
+      error("number " + token_ + " beyond numeric range");
+    handler_.double_value(x);
+  }
+
+  void parse_value() {
+    int c = peek_nonspace();
+    switch (c) {
+      case '{':
+        parse_object();
+        break;
+      case '[':
+        parse_array();
+        break;
+      case '"':
+        parse_string(token_);
+        handler_.string_value(token_);
+        break;
+      case 't':
+        expect("true");
+        handler_.bool_value(true);
+        break;
+      case 'f':
+        expect("false");
+        handler_.bool_value(false);
+        break;
+      case 'n':
+        expect("null");
+        handler_.null_value();
+        break;
+      case 'N':
+        expect("NaN");
+        handler_.double_value(std::numeric_limits<double>::quiet_NaN());
+        break;
+      case 'I':
+        expect("Infinity");
+        handler_.double_value(std::numeric_limits<double>::infinity());
+        break;
+      case EOF:
+        error("unexpected end of input");
+        break;
+      default:
+        if (c == '-' || (c >= '0' && c <= '9'))
+          parse_number();
+        else
+          error(std::string("unexpected character '")
+                + static_cast<char>(c) + "'");
+    }
+  }
+
+  void parse_array() {
+    get();  // [
+    handler_.start_array();
+    if (peek_nonspace() == ']') {
+      get();
+      handler_.end_array();
+      return;
+    }
+    while (true) {
+      parse_value();
+      int c = peek_nonspace();
+      get();
+      if (c == ']')
+        break;
+      if (c == EOF)
+        error("unexpected end of input");
+      if (c != ',')
+        error("expected ',' or ']' in array");
+    }
+    handler_.end_array();
+  }
+
+  void parse_object() {
+    get();  // {
+    handler_.start_object();
+    if (peek_nonspace() == '}') {
+      get();
+      handler_.end_object();
+      return;
+    }
+    std::string key;
+    while (true) {
+      if (peek_nonspace() != '"')
+        error("expected string key in object");
+      parse_string(key);
+      handler_.key(key);
+      if (peek_nonspace() != ':')
+        error("expected ':' after key");
+      get();
+      parse_value();
+      int c = peek_nonspace();
+      get();
+      if (c == '}')
+        break;
+      if (c == EOF)
+        error("unexpected end of input");
+      if (c != ',')
+        error("expected ',' or '}' in object");
+    }
+    handler_.end_object();
+  }
+
+ public:
+  /**
+   * Construct a parser reading from the specified stream and
+   * reporting to the specified handler.
+   *
+   * @param in input stream
+   * @param handler handler for parse events
+   */
+  json_parser(std::istream& in, Handler& handler)
+      : in_(in),
+        handler_(handler),
+        buf_(1 << 16),
+        pos_(0),
+        end_(0),
+        line_(1),
+        column_(0) {}
+
+  /**
+   * Parse one JSON value from the stream, which may only be followed
+   * by whitespace.
+   *
+   * @throw std::invalid_argument if the input is not valid JSON; the
+   *   message gives the line and column of the error
+   */
+  void parse() {
+    parse_value();
+    if (peek_nonspace() != EOF)
+      error("extra characters after JSON value");
+  }
+};
+
+/**
+ * Parse JSON from the specified stream, reporting to the specified
+ * handler.
+ *
+ * @tparam Handler type of handler, see <code>json_parser</code>
+ * @param in input stream
+ * @param handler handler for parse events
+ * @throw std::invalid_argument if the input is not valid JSON
+ */
+template <typename Handler>
+void parse_json(std::istream& in, Handler& handler) {
+  json_parser<Handler> parser(in, handler);
+  parser.parse();
+}
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,104 @@
+#ifndef STAN_IO_MAPPED_FILE_HPP
+#define STAN_IO_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace stan {
+namespace io {
+
+/**
+ * Read-only view of the contents of a file.  On POSIX systems the file
+ * is memory mapped, so pages are only read when touched and nothing is
+ * copied; elsewhere the file is read into memory once.
+ *
+ * The contents are not null terminated.
+ */
+class mapped_file {
+ public:
+  /**
+   * Map the specified file.
+   *
+   * @param path path of the file
+   * @throw std::invalid_argument if the file can not be opened or
+   *   mapped
+   */
+  explicit mapped_file(const std::string& path)
+      : data_(nullptr), size_(0) {
+#ifdef _WIN32
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in)
+      throw std::invalid_argument("can not open file " + path);
+    buffer_.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      throw std::invalid_argument("can not open file " + path);
+    struct stat info;
+    if (::fstat(fd, &info) == -1) {
+      ::close(fd);
+      throw std::invalid_argument("can not read size of file " + path);
+    }
+    size_ = info.st_size;
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::invalid_argument("can not map file " + path);
+      }
+      ::madvise(addr, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file() {
+#ifndef _WIN32
+    if (data_ != nullptr)
+      ::munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  /**
+   * Return a pointer to the first character of the file.
+   *
+   * @return pointer to the contents; null if the file is empty
+   */
+  const char* data() const { return data_; }
+
+  /**
+   * Return the size of the file.
+   *
+   * @return number of characters in the file
+   */
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
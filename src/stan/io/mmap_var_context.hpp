@@ -0,0 +1,320 @@
+#ifndef STAN_IO_MMAP_VAR_CONTEXT_HPP
+#define STAN_IO_MMAP_VAR_CONTEXT_HPP
+
+#include <stan/io/binary_data_writer.hpp>
+#include <stan/io/mapped_file.hpp>
+#include <stan/io/validate_dims.hpp>
+#include <stan/io/var_context.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * A <code>var_context</code> backed by a memory mapped file in the
+ * binary data format written by <code>binary_data_writer</code>.
+ *
+ * Construction only reads the record headers to index the variables;
+ * values are read from the mapping when they are requested, so only
+ * the pages holding the variables a model actually uses are ever
+ * read from disk.
+ *
+ * <p>The file must stay unchanged while the context exists.
+ */
+class mmap_var_context : public var_context {
+ private:
+  struct entry {
+    std::uint32_t type;
+    std::vector<size_t> dims;
+    const char* data;
+    size_t size;
+  };
+
+  mapped_file file_;
+  std::unordered_map<std::string, entry> vars_;
+  std::vector<double> const empty_vec_r_;
+  std::vector<int> const empty_vec_i_;
+  std::vector<size_t> const empty_vec_ui_;
+
+  template <typename T>
+  static T read_raw(const char* p) {
+    T x;
+    std::memcpy(&x, p, sizeof(T));
+    return x;
+  }
+
+  static void check_size(const std::string& path, size_t available,
+                         size_t needed) {
+    if (needed > available)
+      throw std::invalid_argument("binary data file " + path
+                                  + " is truncated or corrupt");
+  }
+
+  void index(const std::string& path) {
+    const char* data = file_.data();
+    size_t size = file_.size();
+    check_size(path, size, binary_data_format::header_size);
+    if (std::memcmp(data, binary_data_format::magic(), 8) != 0)
+      throw std::invalid_argument(path + " is not a binary data file");
+    if (read_raw<std::uint32_t>(data + 8) != binary_data_format::version)
+      throw std::invalid_argument("binary data file " + path
+                                  + " has an unsupported version");
+    if (read_raw<std::uint32_t>(data + 12)
+        != binary_data_format::byte_order_mark)
+      throw std::invalid_argument("binary data file " + path
+                                  + " was written with another byte order");
+
+    size_t pos = binary_data_format::header_size;
+    while (pos < size) {
+      check_size(path, size - pos, 16);
+      std::uint32_t name_size = read_raw<std::uint32_t>(data + pos);
+      entry var;
+      var.type = read_raw<std::uint32_t>(data + pos + 4);
+      std::uint64_t rank = read_raw<std::uint64_t>(data + pos + 8);
+      pos += 16;
+      if (var.type != binary_data_format::int_type
+          && var.type != binary_data_format::real_type)
+        throw std::invalid_argument("binary data file " + path
+                                    + " has a variable of unknown type");
+      check_size(path, (size - pos) / 8, rank);
+      var.size = 1;
+      for (std::uint64_t k = 0; k < rank; ++k, pos += 8) {
+        var.dims.push_back(read_raw<std::uint64_t>(data + pos));
+        if (var.dims.back() != 0)
+          check_size(path, size / var.dims.back(), var.size);
+        var.size *= var.dims.back();
+      }
+      size_t name_bytes = name_size + binary_data_format::padding(name_size);
+      check_size(path, size - pos, name_bytes);
+      std::string name(data + pos, name_size);
+      pos += name_bytes;
+      size_t elem_size = var.type == binary_data_format::int_type
+                             ? sizeof(std::int32_t)
+                             : sizeof(double);
+      // var.size * elem_size can not wrap once it fits in the file
+      check_size(path, (size - pos) / elem_size, var.size);
+      size_t data_bytes = var.size * elem_size;
+      data_bytes += binary_data_format::padding(data_bytes);
+      check_size(path, size - pos, data_bytes);
+      var.data = data + pos;
+      pos += data_bytes;
+      if (!vars_.emplace(name, std::move(var)).second)
+        throw std::invalid_argument("binary data file " + path
+                                    + " has duplicate variable " + name);
+    }
+  }
+
+  const entry* find(const std::string& name) const {
+    auto it = vars_.find(name);
+    return it == vars_.end() ? nullptr : &it->second;
+  }
+
+ public:
+  /**
+   * Construct a context from the specified binary data file.
+   *
+   * @param path path of the file
+   * @throw std::invalid_argument if the file can not be mapped or is
+   *   not a valid binary data file
+   */
+  explicit mmap_var_context(const std::string& path) : file_(path) {
+    index(path);
+  }
+
+  /**
+   * Return <code>true</code> if the specified variable name is
+   * defined. This method returns <code>true</code> even if the values
+   * are all integers.
+   *
+   * @param name Variable name to test.
+   * @return <code>true</code> if the variable exists.
+   */
+  bool contains_r(const std::string& name) const {
+    return find(name) != nullptr;
+  }
+
+  /**
+   * Return <code>true</code> if an integer variable with the
+   * specified name is defined.
+   *
+   * @param name Variable name to test.
+   * @return <code>true</code> if the variable is an integer variable.
+   */
+  bool contains_i(const std::string& name) const {
+    const entry* var = find(name);
+    return var != nullptr && var->type == binary_data_format::int_type;
+  }
+
+  /**
+   * Return the values of the variable with the specified name as
+   * doubles, read from the mapping, or an empty vector if it is not
+   * defined.
+   *
+   * @param name Name of variable.
+   * @return Values of variable.
+   */
+  std::vector<double> vals_r(const std::string& name) const {
+    const entry* var = find(name);
+    if (var == nullptr)
+      return empty_vec_r_;
+    if (var->type == binary_data_format::real_type) {
+      const double* first = reinterpret_cast<const double*>(var->data);
+      return std::vector<double>(first, first + var->size);
+    }
+    const std::int32_t* first
+        = reinterpret_cast<const std::int32_t*>(var->data);
+    return std::vector<double>(first, first + var->size);
+  }
+
+  /**
+   * Return a view of the values of the variable with the specified
+   * name as doubles.  Real values are viewed in place in the mapping;
+   * integer values are converted into a view that owns them.
+   *
+   * @param name Name of variable.
+   * @return View of values of variable.
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    const entry* var = find(name);
+    if (var == nullptr)
+      return vals_view<double>();
+    if (var->type == binary_data_format::real_type)
+      return vals_view<double>(reinterpret_cast<const double*>(var->data),
+                               var->size);
+    return vals_view<double>(vals_r(name));
+  }
+
+  /**
+   * Return a view of the values of the integer variable with the
+   * specified name in place in the mapping, or an empty view if there
+   * is no such integer variable.
+   *
+   * @param name Name of variable.
+   * @return View of values.
+   */
+  vals_view<int> vals_i_view(const std::string& name) const {
+    const entry* var = find(name);
+    if (var == nullptr || var->type != binary_data_format::int_type)
+      return vals_view<int>();
+    return vals_view<int>(reinterpret_cast<const int*>(var->data), var->size);
+  }
+
+  /**
+   * Look up the variable with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable.
+   */
+  var_entry lookup(const std::string& name) const {
+    var_entry result;
+    const entry* var = find(name);
+    if (var == nullptr)
+      return result;
+    result.found = true;
+    result.is_int = var->type == binary_data_format::int_type;
+    if (result.is_int)
+      result.vals_i = vals_view<int>(reinterpret_cast<const int*>(var->data),
+                                     var->size);
+    else
+      result.vals_r = vals_view<double>(
+          reinterpret_cast<const double*>(var->data), var->size);
+    result.dims = vals_view<size_t>(var->dims);
+    return result;
+  }
+
+  /**
+   * Return the dimensions of the variable with the specified name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_r(const std::string& name) const {
+    const entry* var = find(name);
+    return var == nullptr ? empty_vec_ui_ : var->dims;
+  }
+
+  /**
+   * Return the values of the integer variable with the specified
+   * name, read from the mapping, or an empty vector if there is no
+   * such integer variable.
+   *
+   * @param name Name of variable.
+   * @return Values.
+   */
+  std::vector<int> vals_i(const std::string& name) const {
+    const entry* var = find(name);
+    if (var == nullptr || var->type != binary_data_format::int_type)
+      return empty_vec_i_;
+    const std::int32_t* first
+        = reinterpret_cast<const std::int32_t*>(var->data);
+    return std::vector<int>(first, first + var->size);
+  }
+
+  /**
+   * Return the dimensions of the integer variable with the specified
+   * name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_i(const std::string& name) const {
+    const entry* var = find(name);
+    return var != nullptr && var->type == binary_data_format::int_type
+               ? var->dims
+               : empty_vec_ui_;
+  }
+
+  /**
+   * Return a list of the names of the floating point variables.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  virtual void names_r(std::vector<std::string>& names) const {
+    names.resize(0);
+    for (const auto& var : vars_)
+      if (var.second.type == binary_data_format::real_type)
+        names.push_back(var.first);
+    std::sort(names.begin(), names.end());
+  }
+
+  /**
+   * Return a list of the names of the integer variables.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  virtual void names_i(std::vector<std::string>& names) const {
+    names.resize(0);
+    for (const auto& var : vars_)
+      if (var.second.type == binary_data_format::int_type)
+        names.push_back(var.first);
+    std::sort(names.begin(), names.end());
+  }
+
+  /**
+   * Check variable dimensions against variable declaration.
+   *
+   * @param stage stan program processing stage
+   * @param name variable name
+   * @param base_type declared stan variable type
+   * @param dims_declared variable dimensions
+   * @throw std::runtime_error if mismatch between declared
+   *        dimensions and dimensions found in context.
+   */
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
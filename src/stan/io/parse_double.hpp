@@ -0,0 +1,78 @@
+#ifndef STAN_IO_PARSE_DOUBLE_HPP
+#define STAN_IO_PARSE_DOUBLE_HPP
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace stan {
+namespace io {
+
+/**
+ * Parses a floating point number from the front of a character range,
+ * skipping leading blanks, and returns a pointer one past the last
+ * character consumed.  If no number can be parsed, the value is set
+ * to zero and <code>first</code> is returned.
+ *
+ * Uses <code>std::from_chars</code> when the standard library provides
+ * it for floating point types and <code>std::strtod</code> otherwise.
+ * In the latter case the range must be followed by a character that
+ * can not continue a number, such as a delimiter, newline or
+ * terminating null, so that <code>strtod</code> stops inside the
+ * caller's buffer.
+ *
+ * Both accept decimal and scientific notation as well as
+ * <code>inf</code>, <code>infinity</code> and <code>nan</code>, in any
+ * case and with an optional sign.
+ *
+ * @param first pointer to the first character
+ * @param last pointer one past the last character
+ * @param[out] x parsed value
+ * @return pointer one past the parsed number, or <code>first</code>
+ *   if no number was found
+ */
+inline const char* parse_double(const char* first, const char* last,
+                                double& x) {
+  const char* p = first;
+  while (p < last && (*p == ' ' || *p == '\t'))
+    ++p;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  if (p < last && *p == '+')
+    ++p;
+  std::from_chars_result result = std::from_chars(p, last, x);
+  if (result.ec == std::errc::invalid_argument) {
+    x = 0;
+    return first;
+  }
+  if (result.ec == std::errc::result_out_of_range) {
+    // overflow and underflow are rounded the way strtod rounds them
+    std::string text(p, result.ptr);
+    x = std::strtod(text.c_str(), nullptr);
+  }
+  return result.ptr;
+#else
+  // strtod would skip a newline and parse the next line of an empty
+  // field, so only hand it a range that starts like a number
+  if (p == last
+      || !(std::isdigit(static_cast<unsigned char>(*p)) || *p == '.'
+           || *p == '+' || *p == '-' || *p == 'i' || *p == 'I' || *p == 'n'
+           || *p == 'N')) {
+    x = 0;
+    return first;
+  }
+  char* end;
+  x = std::strtod(p, &end);
+  if (end == p)
+    return first;
+  return end;
+#endif
+}
+
+}  // namespace io
+}  // namespace stan
+#endif
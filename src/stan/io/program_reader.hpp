@@ -2,13 +2,14 @@
 #define STAN_IO_PROGRAM_READER_HPP
 
 #include <stan/io/ends_with.hpp>
+#include <stan/io/include_cache.hpp>
 #include <stan/io/read_line.hpp>
 #include <stan/io/starts_with.hpp>
 #include <stan/io/trim_spaces.hpp>
 #include <cstdio>
 #include <istream>
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <stdexcept>
@@ -76,7 +77,31 @@ class program_reader {
   program_reader(std::istream& in, const std::string& name,
                  const std::vector<std::string>& search_path) {
     int concat_line_num = 0;
-    read(in, name, search_path, concat_line_num);
+    read(in, name, search_path, concat_line_num, nullptr);
+  }
+
+  /**
+   * Construct a program reader from the specified stream derived
+   * from the specified name or path, and a sequence of paths to
+   * search for include files, taking included files from the
+   * specified cache.  Included files that are not in the cache, or
+   * have changed since they were cached, are read into it.  The
+   * program and its history are the same as if the included files
+   * were read from disk.
+   *
+   * <p>Calling this method does not close the specified input stream.
+   *
+   * @param[in] in stream from which to start reading
+   * @param[in] name name path or name attached to stream
+   * @param[in] search_path ordered sequence of directory names to
+   * search for included files
+   * @param[in,out] cache cache of included files
+   */
+  program_reader(std::istream& in, const std::string& name,
+                 const std::vector<std::string>& search_path,
+                 include_cache& cache) {
+    int concat_line_num = 0;
+    read(in, name, search_path, concat_line_num, &cache);
   }
 
   static std::string trim_comment(const std::string& line) {
@@ -216,75 +241,79 @@ class program_reader {
     return rest.substr(0, pos);  // pos past last char
   }
 
-  void read(std::istream& in, const std::string& path,
-            const std::vector<std::string>& search_path, int& concat_line_num,
-            bool is_nested, std::set<std::string>& visited_paths) {
+  /**
+   * Splice the specified split program, read from the specified path,
+   * into the program, recording its history and recursively splicing
+   * in the files it includes.  If a file is included recursively, the
+   * second include is ignored.
+   *
+   * @param[in] source split program
+   * @param[in] path name of source
+   * @param[in] search_path sequence of path names to search for
+   * include files
+   * @param[in,out] concat_line_num position in concatenated file
+   * to be updated
+   * @param[in] is_nested <code>true</code> if source is included
+   * @param[in,out] visited_paths paths of the sources being spliced
+   * @param[in] cache cache of included files or <code>nullptr</code>
+   * to read them from disk
+   * @throw std::runtime_error if an included file cannot be found
+   */
+  void splice(const program_source& source, const std::string& path,
+              const std::vector<std::string>& search_path,
+              int& concat_line_num, bool is_nested,
+              std::set<std::string>& visited_paths, include_cache* cache) {
     if (visited_paths.find(path) != visited_paths.end())
       return;  // avoids recursive visitation
     visited_paths.insert(path);
     history_.push_back(preproc_event(concat_line_num, 0, "start", path));
-    for (int line_num = 1;; ++line_num) {
-      std::string line = read_line(in);
-      if (line.empty()) {
-        // ends initial out of loop start event
-        if (!is_nested) {
-          // pad end concat_line_num of outermost file in order to properly
-          // report end-of-file parse error - else trace throws exception
-          history_.push_back(
-              preproc_event(concat_line_num + 2, line_num - 1, "end", path));
-        } else {
-          history_.push_back(
-              preproc_event(concat_line_num, line_num - 1, "end", path));
-        }
+    int line_num = 0;
+    for (const program_source::segment& seg : source.segments) {
+      program_ << seg.text;
+      concat_line_num += seg.num_lines;
+      line_num += seg.num_lines;
+      if (seg.include_line.empty())
         break;
-      } else if (starts_with("#include ", trim_spaces(line))) {
-        std::string incl_path = include_path(line);
+      ++line_num;
+      std::string incl_path = include_path(seg.include_line);
+      history_.push_back(
+          preproc_event(concat_line_num, line_num - 1, "include", incl_path));
+      bool found_path = false;
+      for (size_t i = 0; i < search_path.size(); ++i) {
+        std::string f
+            = (search_path[i].size() != 0 && !ends_with("/", search_path[i])
+               && !ends_with("\\", search_path[i]))
+                  ? search_path[i] + "/"
+                        + incl_path  // / will work under Windows
+                  : search_path[i] + incl_path;
+        std::shared_ptr<const program_source> included
+            = cache != nullptr ? cache->load(f) : program_source::load(f);
+        if (included == nullptr)
+          continue;
+        splice(*included, incl_path, search_path, concat_line_num, true,
+               visited_paths, cache);
         history_.push_back(
-            preproc_event(concat_line_num, line_num - 1, "include", incl_path));
-        bool found_path = false;
-        for (size_t i = 0; i < search_path.size(); ++i) {
-          std::string f
-              = (search_path[i].size() != 0 && !ends_with("/", search_path[i])
-                 && !ends_with("\\", search_path[i]))
-                    ? search_path[i] + "/"
-                          + incl_path  // / will work under Windows
-                    : search_path[i] + incl_path;
-
-          std::ifstream include_in(f.c_str());
-          try {
-            if (!include_in.good()) {
-              include_in.close();
-              continue;
-            }
-            read(include_in, incl_path, search_path, concat_line_num, true,
-                 visited_paths);
-          } catch (...) {
-            include_in.close();
-            throw;
-          }
-          include_in.close();
-          history_.push_back(
-              preproc_event(concat_line_num, line_num, "restart", path));
-          found_path = true;
-          break;
-        }
-        if (!found_path) {
-          std::ostringstream include_err_msg;
-
-          include_err_msg << "could not find include file " << incl_path
-                          << " in the following directories:\n";
+            preproc_event(concat_line_num, line_num, "restart", path));
+        found_path = true;
+        break;
+      }
+      if (!found_path) {
+        std::ostringstream include_err_msg;
 
-          for (size_t i = 0; i < search_path.size(); ++i) {
-            include_err_msg << "    " << search_path[i] << "\n";
-          }
+        include_err_msg << "could not find include file " << incl_path
+                        << " in the following directories:\n";
 
-          throw std::runtime_error(include_err_msg.str());
+        for (size_t i = 0; i < search_path.size(); ++i) {
+          include_err_msg << "    " << search_path[i] << "\n";
         }
-      } else {
-        ++concat_line_num;
-        program_ << line;
+
+        throw std::runtime_error(include_err_msg.str());
       }
     }
+    // pad end concat_line_num of outermost file in order to properly
+    // report end-of-file parse error - else trace throws exception
+    history_.push_back(preproc_event(concat_line_num + (is_nested ? 0 : 2),
+                                     line_num, "end", path));
     visited_paths.erase(path);  // allow multiple, just not nested
   }
 
@@ -292,9 +321,8 @@ class program_reader {
    * Read the rest of a program from the specified input stream in
    * the specified path, with the specified search path for
    * include files, and incrementing the specified concatenated
-   * line number.  This method is called recursively for included
-   * files.  If a file is included recursively, the second include
-   * is ignored.
+   * line number.  If a file is included recursively, the second
+   * include is ignored.
    *
    * @param[in] in stream from which to read
    * @param[in] path name of stream
@@ -302,12 +330,16 @@ class program_reader {
    * include files
    * @param[in,out] concat_line_num position in concatenated file
    * to be updated
+   * @param[in] cache cache of included files or <code>nullptr</code>
+   * to read them from disk
    * @throw std::runtime_error if an included file cannot be found
    */
   void read(std::istream& in, const std::string& path,
-            const std::vector<std::string>& search_path, int& concat_line_num) {
+            const std::vector<std::string>& search_path, int& concat_line_num,
+            include_cache* cache) {
     std::set<std::string> visited_paths;
-    read(in, path, search_path, concat_line_num, false, visited_paths);
+    splice(*program_source::scan(in), path, search_path, concat_line_num,
+           false, visited_paths, cache);
   }
 };
 
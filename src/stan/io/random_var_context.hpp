@@ -4,9 +4,9 @@
 #include <stan/io/var_context.hpp>
 #include <stan/io/validate_dims.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
-#include <algorithm>
 #include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace stan {
@@ -62,6 +62,9 @@ class random_var_context : public var_context {
     }
     dims_.erase(dims_.begin() + i, dims_.end());
     names_.erase(names_.begin() + i, names_.end());
+    index_.reserve(names_.size());
+    for (size_t n = 0; n < names_.size(); ++n)
+      index_.emplace(names_[n], n);
 
     if (init_zero) {
       for (size_t n = 0; n < num_unconstrained_; ++n)
@@ -96,7 +99,7 @@ class random_var_context : public var_context {
    * model.
    */
   bool contains_r(const std::string& name) const {
-    return std::find(names_.begin(), names_.end(), name) != names_.end();
+    return index_.count(name) > 0;
   }
 
   /**
@@ -108,11 +111,42 @@ class random_var_context : public var_context {
    *   var_context; an empty vector is returned otherwise
    */
   std::vector<double> vals_r(const std::string& name) const {
-    std::vector<std::string>::const_iterator loc
-        = std::find(names_.begin(), names_.end(), name);
-    if (loc == names_.end())
+    auto loc = index_.find(name);
+    if (loc == index_.end())
       return std::vector<double>();
-    return vals_r_[loc - names_.begin()];
+    return vals_r_[loc->second];
+  }
+
+  /**
+   * Returns a view of the values of the constrained variables.
+   *
+   * @param name Name of variable.
+   * @return view of the constrained values if the variable is in the
+   *   var_context; an empty view is returned otherwise
+   */
+  vals_view<double> vals_r_view(const std::string& name) const {
+    auto loc = index_.find(name);
+    if (loc == index_.end())
+      return vals_view<double>();
+    return vals_view<double>(vals_r_[loc->second]);
+  }
+
+  /**
+   * Look up the parameter with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name Name of variable.
+   * @return entry for the parameter
+   */
+  var_entry lookup(const std::string& name) const {
+    var_entry entry;
+    auto loc = index_.find(name);
+    if (loc == index_.end())
+      return entry;
+    entry.found = true;
+    entry.vals_r = vals_view<double>(vals_r_[loc->second]);
+    entry.dims = vals_view<size_t>(dims_[loc->second]);
+    return entry;
   }
 
   /**
@@ -123,11 +157,10 @@ class random_var_context : public var_context {
    *   is returned otherwise
    */
   std::vector<size_t> dims_r(const std::string& name) const {
-    std::vector<std::string>::const_iterator loc
-        = std::find(names_.begin(), names_.end(), name);
-    if (loc == names_.end())
+    auto loc = index_.find(name);
+    if (loc == index_.end())
       return std::vector<size_t>();
-    return dims_[loc - names_.begin()];
+    return dims_[loc->second];
   }
 
   /**
@@ -210,6 +243,10 @@ class random_var_context : public var_context {
    * Parameter names in the model
    */
   std::vector<std::string> names_;
+  /**
+   * Position of each parameter in <code>names_</code>
+   */
+  std::unordered_map<std::string, size_t> index_;
   /**
    * Dimensions of parameters in the model
    */
@@ -2,12 +2,21 @@
 #define STAN_IO_STAN_CSV_READER_HPP
 
 #include <boost/algorithm/string.hpp>
+#include <stan/io/mapped_file.hpp>
+#include <stan/io/parse_double.hpp>
 #include <stan/math/prim.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <istream>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -77,10 +86,399 @@ struct stan_csv {
   stan_csv_timing timing;
 };
 
+/**
+ * Selects part of the draws of a Stan CSV file: the named columns,
+ * in the order given, of every <code>row_stride</code>-th draw from
+ * <code>row_begin</code> up to but not including <code>row_end</code>.
+ * Draws are counted from zero over every draw line in the file,
+ * including saved warmup draws.  Columns are named as in the parsed
+ * header, so element 3 of <code>mu</code> is <code>mu[3]</code>.  An
+ * empty list of columns selects every column.
+ */
+struct stan_csv_selection {
+  std::vector<std::string> columns;
+  size_t row_begin;
+  size_t row_end;
+  size_t row_stride;
+
+  stan_csv_selection()
+      : row_begin(0),
+        row_end(std::numeric_limits<size_t>::max()),
+        row_stride(1) {}
+
+  /**
+   * Throws if the selection can not be applied.
+   *
+   * @throw std::invalid_argument if <code>row_stride</code> is 0
+   */
+  void validate() const {
+    if (row_stride == 0)
+      throw std::invalid_argument("row_stride must be positive");
+  }
+
+  /**
+   * Return true if the specified draw is selected.
+   *
+   * @param row draw index
+   * @return true if the draw is selected
+   */
+  bool selects_row(size_t row) const {
+    return row >= row_begin && row < row_end
+           && (row - row_begin) % row_stride == 0;
+  }
+
+  /**
+   * Return the number of selected draws out of the specified number.
+   *
+   * @param num_rows number of draws
+   * @return number of selected draws
+   */
+  size_t num_selected_rows(size_t num_rows) const {
+    size_t end = std::min(row_end, num_rows);
+    if (end <= row_begin)
+      return 0;
+    return (end - row_begin + row_stride - 1) / row_stride;
+  }
+};
+
+/**
+ * Everything in a Stan CSV file except the draws, plus the offset of
+ * every draw line in the stream.  Built with one pass over the file by
+ * <code>stan_csv_reader::index</code> so that selections of the draws
+ * can be read repeatedly, seeking straight to the selected lines.
+ */
+struct stan_csv_index {
+  stan_csv_metadata metadata;
+  std::vector<std::string> header;
+  stan_csv_adaptation adaptation;
+  stan_csv_timing timing;
+  std::vector<std::streamoff> row_offsets;
+};
+
 /**
  * Reads from a Stan output csv file.
  */
 class stan_csv_reader {
+ private:
+  /**
+   * Reads the elapsed time from a timing comment, which has the form
+   * <code>#  Elapsed Time: 0.1898 seconds (Warm-up)</code> or
+   * <code>#                0.1808 seconds (Sampling)</code>.
+   *
+   * @param line timing comment
+   * @return elapsed time in seconds
+   */
+  static double read_elapsed_time(const std::string& line) {
+    int left = 17;
+    int right = line.find(" seconds");
+    double time;
+    std::stringstream(line.substr(left, right - left)) >> time;
+    return time;
+  }
+
+  /**
+   * Adds the elapsed time of a timing comment to the timing info;
+   * other comments are ignored.
+   *
+   * @param first pointer to the first character of the comment
+   * @param last pointer one past the last character of the comment
+   * @param[in,out] timing elapsed times
+   */
+  static void read_timing_comment(const char* first, const char* last,
+                                  stan_csv_timing& timing) {
+    std::string line(first, last);
+    if (line.find("(Warm-up)") != std::string::npos)
+      timing.warmup += read_elapsed_time(line);
+    else if (line.find("(Sampling)") != std::string::npos)
+      timing.sampling += read_elapsed_time(line);
+  }
+
+  /**
+   * Calls <code>f(first, last, offset)</code> for every line left in
+   * the stream, where <code>[first, last)</code> holds the line without
+   * its newline and <code>offset</code> is the position of the line
+   * relative to where reading started.  The stream is read in large
+   * blocks and lines are found with <code>memchr</code>.  The
+   * character following every line is a newline or null.  Stops early
+   * if <code>f</code> returns false.
+   *
+   * @tparam F type of line callback
+   * @param[in,out] in input stream
+   * @param f line callback
+   * @return false if the callback stopped the iteration
+   */
+  template <typename F>
+  static bool for_each_line(std::istream& in, const F& f) {
+    const size_t block_size = 1 << 22;
+    std::vector<char> buffer;
+    size_t pending = 0;
+    std::streamoff position = 0;
+
+    while (true) {
+      // keep one extra byte for a terminating null after the last line
+      buffer.resize(pending + block_size + 1);
+      in.read(buffer.data() + pending, block_size);
+      size_t end = pending + in.gcount();
+      bool done = !in;
+      buffer[end] = '\0';
+
+      const char* data = buffer.data();
+      size_t begin = 0;
+      while (begin < end) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(data + begin, '\n', end - begin));
+        if (newline == nullptr && !done)
+          break;
+        const char* line_end = newline ? newline : data + end;
+        const char* line_last = line_end;
+        if (line_last > data + begin && *(line_last - 1) == '\r')
+          --line_last;
+        if (!f(data + begin, line_last, position + std::streamoff(begin)))
+          return false;
+        begin = line_end - data + 1;
+      }
+      if (done)
+        return true;
+
+      pending = begin < end ? end - begin : 0;
+      position += end - pending;
+      if (pending > 0)
+        std::memmove(buffer.data(), data + begin, pending);
+    }
+  }
+
+  /**
+   * Resolves column names against the header.  The result pairs each
+   * selected column of the file with its column in the output, sorted
+   * by file column so fields can be picked up in one left to right
+   * scan of a line.
+   *
+   * @param header column names of the file
+   * @param columns names of the selected columns
+   * @return pairs of file column and output column
+   * @throw std::invalid_argument if a column is not in the header
+   */
+  static std::vector<std::pair<int, int>> resolve_columns(
+      const std::vector<std::string>& header,
+      const std::vector<std::string>& columns) {
+    std::vector<std::pair<int, int>> fields;
+    for (size_t n = 0; n < columns.size(); ++n) {
+      auto it = std::find(header.begin(), header.end(), columns[n]);
+      if (it == header.end())
+        throw std::invalid_argument("column " + columns[n]
+                                    + " not found in header");
+      fields.emplace_back(it - header.begin(), n);
+    }
+    std::sort(fields.begin(), fields.end());
+    return fields;
+  }
+
+  /**
+   * Parses the selected fields of a draw line into a row of the draws.
+   * Fields before the last selected one are skipped without
+   * conversion and the rest of the line is not scanned at all.
+   *
+   * @param first pointer to the first character of the line
+   * @param last pointer one past the last character of the line
+   * @param fields pairs of file column and output column, sorted by
+   *   file column
+   * @param[in,out] draws draws
+   * @param row row of the draws to write
+   * @return false if the line has fewer fields than selected
+   */
+  static bool read_fields(const char* first, const char* last,
+                          const std::vector<std::pair<int, int>>& fields,
+                          Eigen::MatrixXd& draws, int row) {
+    const char* field = first;
+    int col = 0;
+    for (size_t k = 0; k < fields.size();) {
+      const char* comma = static_cast<const char*>(
+          std::memchr(field, ',', last - field));
+      const char* field_end = comma ? comma : last;
+      for (; k < fields.size() && fields[k].first == col; ++k)
+        parse_double(field, field_end, draws(row, fields[k].second));
+      if (comma == nullptr)
+        return k == fields.size();
+      field = comma + 1;
+      ++col;
+    }
+    return true;
+  }
+
+  /**
+   * Parses every field of a draw line into a row of the draws.
+   *
+   * @param first pointer to the first character of the line
+   * @param last pointer one past the last character of the line
+   * @param[in,out] draws draws; the number of columns is the expected
+   *   number of fields
+   * @param row row of the draws to write
+   * @return number of fields in the line
+   */
+  static int read_all_fields(const char* first, const char* last,
+                             Eigen::MatrixXd& draws, int row) {
+    const char* field = first;
+    int cols = draws.cols();
+    int col = 0;
+    while (true) {
+      const char* comma = static_cast<const char*>(
+          std::memchr(field, ',', last - field));
+      if (col < cols)
+        parse_double(field, comma ? comma : last, draws(row, col));
+      ++col;
+      if (comma == nullptr)
+        return col;
+      field = comma + 1;
+    }
+  }
+
+  /**
+   * Processes one line of the draws section.  Timing comments are
+   * added to <code>timing</code>, other comments and blank lines are
+   * skipped, draws that are not selected are skipped without
+   * conversion and every selected draw is parsed into the next row of
+   * <code>draws</code>, growing it if it is full.
+   *
+   * The character following the line must be a newline or null so
+   * number parsing stops within the buffer.
+   *
+   * @param first pointer to the first character of the line
+   * @param last pointer one past the last character of the line
+   * @param fields pairs of file column and output column for the
+   *   selected columns; empty to read every column
+   * @param selection selected draws
+   * @param[in,out] draws draws read so far
+   * @param[in,out] line_index number of draw lines seen so far
+   * @param[in,out] rows number of draws read so far
+   * @param[in,out] cols number of columns; -1 before the first draw
+   * @param[in] expected_rows number of rows to allocate for the first
+   *   draw
+   * @param[in,out] timing elapsed times
+   * @param[out] out output stream for error messages
+   * @return false if the number of columns does not match the first
+   *   draw
+   */
+  static bool read_sample_line(const char* first, const char* last,
+                               const std::vector<std::pair<int, int>>& fields,
+                               const stan_csv_selection& selection,
+                               Eigen::MatrixXd& draws, size_t& line_index,
+                               int& rows, int& cols, size_t expected_rows,
+                               stan_csv_timing& timing, std::ostream* out) {
+    if (first == last)
+      return true;
+
+    if (*first == '#') {
+      read_timing_comment(first, last, timing);
+      return true;
+    }
+
+    if (!selection.selects_row(line_index++))
+      return true;
+
+    if (cols == -1) {
+      cols = fields.empty() ? std::count(first, last, ',') + 1
+                            : selection.columns.size();
+      draws.resize(std::max<size_t>(expected_rows, 1), cols);
+    }
+    if (rows == draws.rows())
+      draws.conservativeResize(2 * rows, cols);
+
+    int found;
+    if (fields.empty())
+      found = read_all_fields(first, last, draws, rows);
+    else if (read_fields(first, last, fields, draws, rows))
+      found = cols;
+    else
+      found = std::count(first, last, ',') + 1;
+    if (found != cols) {
+      if (out)
+        *out << "Error: expected " << cols << " columns, but found " << found
+             << " instead for row " << rows + 1 << std::endl;
+      return false;
+    }
+    rows++;
+    return true;
+  }
+
+  /**
+   * Calls <code>f(first, last, terminated)</code> for every line in a
+   * range of characters, where <code>[first, last)</code> holds the
+   * line without its newline or carriage return and
+   * <code>terminated</code> is false for a last line that does not end
+   * in a newline.
+   *
+   * @tparam F type of line callback
+   * @param first pointer to the first character
+   * @param last pointer one past the last character
+   * @param f line callback
+   */
+  template <typename F>
+  static void for_each_line(const char* first, const char* last,
+                            const F& f) {
+    while (first < last) {
+      const char* newline
+          = static_cast<const char*>(std::memchr(first, '\n', last - first));
+      const char* line_end = newline ? newline : last;
+      const char* line_last = line_end;
+      if (line_last > first && *(line_last - 1) == '\r')
+        --line_last;
+      f(first, line_last, newline != nullptr);
+      first = line_end + 1;
+    }
+  }
+
+  /**
+   * Returns a pointer to the first draw of a Stan CSV file held in
+   * memory, which is the first line after the header that is neither
+   * a comment nor blank.
+   *
+   * @param first pointer to the first character of the file
+   * @param last pointer one past the last character of the file
+   * @return pointer to the first draw, or <code>last</code> if there
+   *   are no draws
+   */
+  static const char* find_draws(const char* first, const char* last) {
+    bool seen_header = false;
+    const char* draws = last;
+    for_each_line(first, last, [&](const char* line, const char* line_last,
+                                   bool) {
+      if (draws != last || line == line_last || *line == '#')
+        return;
+      if (seen_header)
+        draws = line;
+      seen_header = true;
+    });
+    return draws;
+  }
+
+  /**
+   * Splits a range of characters into chunks of about the specified
+   * size that start at the beginning of a line.
+   *
+   * @param first pointer to the first character
+   * @param last pointer one past the last character
+   * @param chunk_size minimum number of characters in a chunk
+   * @return chunk boundaries, starting with <code>first</code> and
+   *   ending with <code>last</code>
+   */
+  static std::vector<const char*> split_lines(const char* first,
+                                              const char* last,
+                                              size_t chunk_size) {
+    std::vector<const char*> bounds(1, first);
+    const char* begin = first;
+    while (static_cast<size_t>(last - begin) > chunk_size) {
+      const char* newline = static_cast<const char*>(
+          std::memchr(begin + chunk_size, '\n', last - begin - chunk_size));
+      if (newline == nullptr)
+        break;
+      begin = newline + 1;
+      bounds.push_back(begin);
+    }
+    if (bounds.back() != last)
+      bounds.push_back(last);
+    return bounds;
+  }
+
  public:
   stan_csv_reader() {}
   ~stan_csv_reader() {}
@@ -261,73 +659,83 @@ class stan_csv_reader {
       return true;
   }
 
+  /**
+   * Reads the draws following the header and adaptation info into
+   * <code>samples</code>, accumulating the elapsed times from the
+   * timing comments into <code>timing</code>.
+   *
+   * The stream is read in large blocks.  Lines and fields are located
+   * with <code>memchr</code> and every field is converted in place,
+   * straight into the column major matrix, without building a string
+   * per line or per field.  Comment lines other than the timing
+   * comments and blank lines are skipped.
+   *
+   * The matrix is allocated for <code>expected_rows</code> draws up
+   * front (for instance, the number implied by the metadata) and grown
+   * geometrically if there are more, so when the hint is right the
+   * draws are written exactly once.
+   *
+   * @param[in,out] in input stream positioned at the first draw
+   * @param[out] samples draws, one row per draw; unchanged on failure
+   * @param[in,out] timing elapsed times
+   * @param[out] out output stream for error messages
+   * @param[in] expected_rows number of rows to allocate up front
+   * @return false if the stream is not positioned at a draw or the
+   *   number of columns varies between rows
+   */
   static bool read_samples(std::istream& in, Eigen::MatrixXd& samples,
-                           stan_csv_timing& timing, std::ostream* out) {
-    std::stringstream ss;
-    std::string line;
-
-    int rows = 0;
-    int cols = -1;
+                           stan_csv_timing& timing, std::ostream* out,
+                           size_t expected_rows = 0) {
+    return read_samples(in, std::vector<std::pair<int, int>>(),
+                        stan_csv_selection(), samples, timing, out,
+                        expected_rows);
+  }
 
+  /**
+   * Reads the selected columns of the selected draws following the
+   * header and adaptation info into <code>samples</code>.  Fields of
+   * unselected columns and lines of unselected draws are skipped
+   * without numeric conversion.
+   *
+   * @param[in,out] in input stream positioned at the first draw
+   * @param[in] fields pairs of file column and output column for the
+   *   selected columns, sorted by file column; empty for every column
+   * @param[in] selection selected draws; its columns must match
+   *   <code>fields</code>
+   * @param[out] samples draws, one row per draw; unchanged on failure
+   * @param[in,out] timing elapsed times
+   * @param[out] out output stream for error messages
+   * @param[in] expected_rows number of rows to allocate up front
+   * @return false if the stream is not positioned at a draw or a row
+   *   has the wrong number of columns
+   * @throw std::invalid_argument if the row stride is 0
+   */
+  static bool read_samples(std::istream& in,
+                           const std::vector<std::pair<int, int>>& fields,
+                           const stan_csv_selection& selection,
+                           Eigen::MatrixXd& samples, stan_csv_timing& timing,
+                           std::ostream* out, size_t expected_rows = 0) {
+    selection.validate();
     if (in.peek() == '#' || in.good() == false)
       return false;
 
-    while (in.good()) {
-      bool comment_line = (in.peek() == '#');
-      bool empty_line = (in.peek() == '\n');
-
-      std::getline(in, line);
-
-      if (empty_line)
-        continue;
-      if (!line.length())
-        break;
-
-      if (comment_line) {
-        if (line.find("(Warm-up)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double warmup;
-          std::stringstream(line.substr(left, right - left)) >> warmup;
-          timing.warmup += warmup;
-        } else if (line.find("(Sampling)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double sampling;
-          std::stringstream(line.substr(left, right - left)) >> sampling;
-          timing.sampling += sampling;
-        }
-      } else {
-        ss << line << '\n';
-        int current_cols = std::count(line.begin(), line.end(), ',') + 1;
-        if (cols == -1) {
-          cols = current_cols;
-        } else if (cols != current_cols) {
-          if (out)
-            *out << "Error: expected " << cols << " columns, but found "
-                 << current_cols << " instead for row " << rows + 1
-                 << std::endl;
-          return false;
-        }
-        rows++;
-      }
-
-      in.peek();
-    }
-
-    ss.seekg(std::ios_base::beg);
+    Eigen::MatrixXd draws;
+    size_t line_index = 0;
+    int rows = 0;
+    int cols = -1;
+    bool ok = for_each_line(
+        in, [&](const char* first, const char* last, std::streamoff) {
+          return read_sample_line(first, last, fields, selection, draws,
+                                  line_index, rows, cols, expected_rows,
+                                  timing, out);
+        });
+    if (!ok)
+      return false;
 
     if (rows > 0) {
-      samples.resize(rows, cols);
-      for (int row = 0; row < rows; row++) {
-        std::getline(ss, line);
-        std::stringstream ls(line);
-        for (int col = 0; col < cols; col++) {
-          std::getline(ls, line, ',');
-          boost::trim(line);
-          std::stringstream(line) >> samples(row, col);
-        }
-      }
+      if (draws.rows() != rows)
+        draws.conservativeResize(rows, cols);
+      samples.swap(draws);
     }
     return true;
   }
@@ -339,6 +747,23 @@ class stan_csv_reader {
    * @param[out] out output stream to send messages
    */
   static stan_csv parse(std::istream& in, std::ostream* out) {
+    return parse(in, out, stan_csv_selection());
+  }
+
+  /**
+   * Parses the file, keeping only the selected columns and draws.  The
+   * header of the result lists the selected columns in the order they
+   * were requested.
+   *
+   * @param[in] in input stream to parse
+   * @param[out] out output stream to send messages
+   * @param[in] selection selected columns and draws
+   * @throw std::invalid_argument if the row stride is 0, the header
+   *   can not be read or a selected column is not in it
+   */
+  static stan_csv parse(std::istream& in, std::ostream* out,
+                        const stan_csv_selection& selection) {
+    selection.validate();
     stan_csv data;
 
     if (!read_metadata(in, data.metadata, out)) {
@@ -360,13 +785,294 @@ class stan_csv_reader {
     data.timing.warmup = 0;
     data.timing.sampling = 0;
 
-    if (!read_samples(in, data.samples, data.timing, out)) {
+    std::vector<std::pair<int, int>> fields
+        = resolve_columns(data.header, selection.columns);
+    if (!selection.columns.empty())
+      data.header = selection.columns;
+
+    size_t thin = std::max<size_t>(data.metadata.thin, 1);
+    size_t expected_rows = (data.metadata.num_samples + thin - 1) / thin;
+    if (data.metadata.save_warmup)
+      expected_rows += (data.metadata.num_warmup + thin - 1) / thin;
+    expected_rows = selection.num_selected_rows(expected_rows);
+
+    if (!read_samples(in, fields, selection, data.samples, data.timing, out,
+                      expected_rows)) {
       if (out)
         *out << "Warning: non-fatal error reading samples" << std::endl;
     }
 
     return data;
   }
+
+  /**
+   * Reads everything but the draws and records the offset of every
+   * draw line, in one pass over the stream.  Draws are located but not
+   * converted.  The stream must support <code>tellg</code>.
+   *
+   * @param[in] in input stream to index
+   * @param[out] out output stream to send messages
+   * @return index of the file
+   * @throw std::invalid_argument if the header can not be read
+   */
+  static stan_csv_index index(std::istream& in, std::ostream* out) {
+    stan_csv_index index;
+
+    if (!read_metadata(in, index.metadata, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading metadata" << std::endl;
+    }
+
+    if (!read_header(in, index.header, out)) {
+      if (out)
+        *out << "Error: error reading header" << std::endl;
+      throw std::invalid_argument("Error with header of input file in index");
+    }
+
+    if (!read_adaptation(in, index.adaptation, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading adaptation data" << std::endl;
+    }
+
+    if (in.peek() == '#' || in.good() == false)
+      return index;
+
+    std::streamoff start = in.tellg();
+    for_each_line(in, [&](const char* first, const char* last,
+                          std::streamoff offset) {
+      if (first == last)
+        return true;
+      if (*first == '#')
+        read_timing_comment(first, last, index.timing);
+      else
+        index.row_offsets.push_back(start + offset);
+      return true;
+    });
+    return index;
+  }
+
+  /**
+   * Reads the selected columns and draws of an indexed file, seeking
+   * straight to the selected draw lines, so the cost is proportional
+   * to the selected data rather than the size of the file.  Fields of
+   * unselected columns are skipped without numeric conversion.
+   *
+   * @param[in,out] in input stream the index was built from
+   * @param[in] index index of the stream
+   * @param[in] selection selected columns and draws
+   * @param[out] out output stream to send messages
+   * @return selected draws with the metadata, header of the selected
+   *   columns, adaptation and timing info of the file
+   * @throw std::invalid_argument if the row stride is 0, a selected
+   *   column is not in the header or a selected draw has too few
+   *   columns
+   */
+  static stan_csv read(std::istream& in, const stan_csv_index& index,
+                       const stan_csv_selection& selection,
+                       std::ostream* out) {
+    selection.validate();
+    stan_csv data;
+    data.metadata = index.metadata;
+    data.adaptation = index.adaptation;
+    data.timing = index.timing;
+
+    std::vector<std::pair<int, int>> fields;
+    if (selection.columns.empty()) {
+      data.header = index.header;
+      for (size_t n = 0; n < index.header.size(); ++n)
+        fields.emplace_back(n, n);
+    } else {
+      data.header = selection.columns;
+      fields = resolve_columns(index.header, selection.columns);
+    }
+
+    size_t num_rows = index.row_offsets.size();
+    data.samples.resize(selection.num_selected_rows(num_rows),
+                        data.header.size());
+
+    in.clear();
+    std::string line;
+    size_t next_row = num_rows;
+    for (int row = 0; row < data.samples.rows(); ++row) {
+      size_t n = selection.row_begin + row * selection.row_stride;
+      if (n != next_row)
+        in.seekg(index.row_offsets[n]);
+      std::getline(in, line);
+      next_row = n + 1;
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (!read_fields(line.data(), line.data() + line.size(), fields,
+                       data.samples, row)) {
+        std::stringstream msg;
+        msg << "Error: too few columns for row " << n + 1;
+        if (out)
+          *out << msg.str() << std::endl;
+        throw std::invalid_argument(msg.str());
+      }
+    }
+    return data;
+  }
+
+  /**
+   * Parses a Stan CSV file held in memory.
+   *
+   * The draws are split into chunks on line boundaries.  The draws in
+   * every chunk are counted in parallel, the matrix of draws is
+   * allocated once, and then the chunks are parsed in parallel
+   * straight into their rows, so no draw is copied after it has been
+   * converted.  Every draw must have as many columns as the header.
+   *
+   * @param[in] first pointer to the first character of the file
+   * @param[in] last pointer one past the last character of the file
+   * @param[out] out output stream to send messages
+   * @return parsed file
+   * @throw std::invalid_argument if the header can not be read
+   */
+  static stan_csv parse(const char* first, const char* last,
+                        std::ostream* out) {
+    const char* draws_first = find_draws(first, last);
+    std::stringstream in(std::string(first, draws_first));
+    stan_csv data;
+
+    if (!read_metadata(in, data.metadata, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading metadata" << std::endl;
+    }
+
+    if (!read_header(in, data.header, out)) {
+      if (out)
+        *out << "Error: error reading header" << std::endl;
+      throw std::invalid_argument("Error with header of input file in parse");
+    }
+
+    if (!read_adaptation(in, data.adaptation, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading adaptation data" << std::endl;
+    }
+
+    std::vector<const char*> bounds = split_lines(draws_first, last, 1 << 22);
+    size_t num_chunks = bounds.size() - 1;
+    std::vector<int> chunk_rows(num_chunks + 1, 0);
+    std::vector<stan_csv_timing> chunk_timing(num_chunks);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chunks, 1),
+        [&](const tbb::blocked_range<size_t>& r) {
+          for (size_t c = r.begin(); c < r.end(); ++c)
+            for_each_line(bounds[c], bounds[c + 1],
+                          [&](const char* line, const char* line_last, bool) {
+                            if (line == line_last)
+                              return;
+                            if (*line == '#')
+                              read_timing_comment(line, line_last,
+                                                  chunk_timing[c]);
+                            else
+                              ++chunk_rows[c + 1];
+                          });
+        });
+    for (size_t c = 0; c < num_chunks; ++c) {
+      chunk_rows[c + 1] += chunk_rows[c];
+      data.timing.warmup += chunk_timing[c].warmup;
+      data.timing.sampling += chunk_timing[c].sampling;
+    }
+
+    int cols = data.header.size();
+    Eigen::MatrixXd draws(chunk_rows[num_chunks], cols);
+    std::vector<int> bad_row(num_chunks, -1);
+    std::vector<int> bad_cols(num_chunks, 0);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chunks, 1),
+        [&](const tbb::blocked_range<size_t>& r) {
+          for (size_t c = r.begin(); c < r.end(); ++c) {
+            int row = chunk_rows[c];
+            for_each_line(
+                bounds[c], bounds[c + 1],
+                [&](const char* line, const char* line_last, bool terminated) {
+                  if (line == line_last || *line == '#' || bad_row[c] != -1)
+                    return;
+                  int found;
+                  if (terminated) {
+                    found = read_all_fields(line, line_last, draws, row);
+                  } else {
+                    // number parsing needs a delimiter after the last field
+                    std::string copy(line, line_last);
+                    found = read_all_fields(
+                        copy.c_str(), copy.c_str() + copy.size(), draws, row);
+                  }
+                  if (found != cols) {
+                    bad_row[c] = row;
+                    bad_cols[c] = found;
+                  }
+                  ++row;
+                });
+          }
+        });
+
+    for (size_t c = 0; c < num_chunks; ++c) {
+      if (bad_row[c] != -1) {
+        if (out) {
+          *out << "Error: expected " << cols << " columns, but found "
+               << bad_cols[c] << " instead for row " << bad_row[c] + 1
+               << std::endl;
+          *out << "Warning: non-fatal error reading samples" << std::endl;
+        }
+        return data;
+      }
+    }
+    data.samples.swap(draws);
+    return data;
+  }
+
+  /**
+   * Parses the Stan CSV files of several chains concurrently.  Every
+   * file is memory mapped and parsed with
+   * <code>parse(const char*, const char*, std::ostream*)</code>, which
+   * in turn parses chunks of each file in parallel, so a fit loads in
+   * about the time it takes to parse its largest file.  Messages are
+   * written to <code>out</code> file by file, in order.
+   *
+   * The result can be moved into <code>stan::mcmc::chains</code>
+   * without copying the draws.
+   *
+   * @param[in] paths paths of the files, one per chain
+   * @param[out] out output stream to send messages
+   * @return parsed files, in the order of <code>paths</code>
+   * @throw std::invalid_argument if a file can not be read, its header
+   *   can not be read, or its header does not match the first file's
+   */
+  static std::vector<stan_csv> parse_files(
+      const std::vector<std::string>& paths, std::ostream* out) {
+    size_t num_files = paths.size();
+    std::vector<stan_csv> data(num_files);
+    std::vector<std::stringstream> messages(num_files);
+    std::vector<std::string> errors(num_files);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_files, 1),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t n = r.begin(); n < r.end(); ++n) {
+                          try {
+                            mapped_file file(paths[n]);
+                            data[n] = parse(file.data(),
+                                            file.data() + file.size(),
+                                            &messages[n]);
+                          } catch (const std::exception& e) {
+                            errors[n] = e.what();
+                          }
+                        }
+                      });
+
+    for (size_t n = 0; n < num_files; ++n) {
+      if (out)
+        *out << messages[n].str();
+      if (!errors[n].empty())
+        throw std::invalid_argument(paths[n] + ": " + errors[n]);
+    }
+    for (size_t n = 1; n < num_files; ++n) {
+      if (data[n].header != data[0].header)
+        throw std::invalid_argument("header of " + paths[n]
+                                    + " does not match header of "
+                                    + paths[0]);
+    }
+    return data;
+  }
 };
 
 }  // namespace io
@@ -0,0 +1,110 @@
+#ifndef STAN_IO_VALS_VIEW_HPP
+#define STAN_IO_VALS_VIEW_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Read-only, contiguous view of the values of a variable in a
+ * <code>var_context</code>, returned by
+ * <code>var_context::vals_r_view</code> and
+ * <code>var_context::vals_i_view</code>.
+ *
+ * A view either refers to values stored in the context, in which case
+ * it is valid as long as the context is alive and the variable is not
+ * changed or removed, or owns a copy of the values when the context
+ * had to build them, for instance to convert integers to doubles.
+ * Either way the values are in column-major order.
+ *
+ * @tparam T type of values
+ */
+template <typename T>
+class vals_view {
+ private:
+  std::vector<T> owned_;
+  const T* data_;
+  size_t size_;
+
+ public:
+  /**
+   * Construct an empty view.
+   */
+  vals_view() : data_(nullptr), size_(0) {}
+
+  /**
+   * Construct a view of values owned by someone else.
+   *
+   * @param data pointer to the first value
+   * @param size number of values
+   */
+  vals_view(const T* data, size_t size) : data_(data), size_(size) {}
+
+  /**
+   * Construct a view of values stored in a vector owned by someone
+   * else.
+   *
+   * @param values values
+   */
+  explicit vals_view(const std::vector<T>& values)
+      : data_(values.data()), size_(values.size()) {}
+
+  /**
+   * Construct a view that owns the specified values.
+   *
+   * @param values values, moved into the view
+   */
+  explicit vals_view(std::vector<T>&& values)
+      : owned_(std::move(values)), data_(owned_.data()), size_(owned_.size()) {}
+
+  vals_view(const vals_view& other)
+      : owned_(other.owned_),
+        data_(other.owns() ? owned_.data() : other.data_),
+        size_(other.size_) {}
+
+  vals_view(vals_view&& other)
+      : owned_(std::move(other.owned_)),
+        data_(other.data_),
+        size_(other.size_) {}
+
+  vals_view& operator=(vals_view other) {
+    owned_.swap(other.owned_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  /**
+   * Return <code>true</code> if the view owns a copy of the values
+   * rather than referring to values in the context.
+   *
+   * @return <code>true</code> if the values are owned by the view
+   */
+  bool owns() const { return !owned_.empty(); }
+
+  const T* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const T* begin() const { return data_; }
+
+  const T* end() const { return data_ + size_; }
+
+  const T& operator[](size_t n) const { return data_[n]; }
+
+  /**
+   * Return a copy of the values.
+   *
+   * @return values
+   */
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
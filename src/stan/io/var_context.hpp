@@ -1,6 +1,8 @@
 #ifndef STAN_IO_VAR_CONTEXT_HPP
 #define STAN_IO_VAR_CONTEXT_HPP
 
+#include <stan/io/vals_view.hpp>
+#include <stan/io/var_entry.hpp>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -95,6 +97,70 @@ class var_context {
    */
   virtual std::vector<size_t> dims_i(const std::string& name) const = 0;
 
+  /**
+   * Return a view of the floating point values for the variable of
+   * the specified name in last-index-major order, or an empty view if
+   * the variable is not defined.  Integer values are cast to floating
+   * point values.
+   *
+   * <p>Contexts that store the values contiguously override this to
+   * return a view of their storage without copying.  The default
+   * returns a view owning the result of <code>vals_r</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the named variable.
+   */
+  virtual vals_view<double> vals_r_view(const std::string& name) const {
+    return vals_view<double>(vals_r(name));
+  }
+
+  /**
+   * Return a view of the integer values for the variable of the
+   * specified name in last-index-major order, or an empty view if
+   * the variable is not defined.
+   *
+   * <p>Contexts that store the values contiguously override this to
+   * return a view of their storage without copying.  The default
+   * returns a view owning the result of <code>vals_i</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the integer values of the named variable.
+   */
+  virtual vals_view<int> vals_i_view(const std::string& name) const {
+    return vals_view<int>(vals_i(name));
+  }
+
+  /**
+   * Look up the variable of the specified name, returning whether it
+   * is defined, whether it is an integer variable, its dimensions and
+   * views of its values.
+   *
+   * <p>Contexts override this to answer with a single lookup of the
+   * name.  The default combines <code>contains_i</code>,
+   * <code>contains_r</code> and the accessors, so it copies the values
+   * of contexts that do not override the views; callers that only
+   * need the dimensions should use <code>dims_r</code> or
+   * <code>dims_i</code>.
+   *
+   * @param name Name of variable.
+   * @return Entry for the variable; not found if it is not defined.
+   */
+  virtual var_entry lookup(const std::string& name) const {
+    var_entry entry;
+    if (contains_i(name)) {
+      entry.is_int = true;
+      entry.vals_i = vals_i_view(name);
+      entry.dims = vals_view<size_t>(dims_i(name));
+    } else if (contains_r(name)) {
+      entry.vals_r = vals_r_view(name);
+      entry.dims = vals_view<size_t>(dims_r(name));
+    } else {
+      return entry;
+    }
+    entry.found = true;
+    return entry;
+  }
+
   /**
    * Fill a list of the names of the floating point variables in
    * the context.
@@ -0,0 +1,54 @@
+#ifndef STAN_IO_VAR_ENTRY_HPP
+#define STAN_IO_VAR_ENTRY_HPP
+
+#include <stan/io/vals_view.hpp>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Result of looking up a variable in a <code>var_context</code> with
+ * <code>var_context::lookup</code>: whether the variable is defined,
+ * whether it is an integer variable, its dimensions and its values,
+ * all found with a single lookup.
+ *
+ * Only the values of the variable's own type are set: an integer
+ * variable has its values in <code>vals_i</code> and an empty
+ * <code>vals_r</code>; use <code>real_vals</code> to read either kind
+ * as doubles.  As with the views themselves, an entry refers to the
+ * context it came from and is only valid while the context is.
+ */
+struct var_entry {
+  bool found;
+  bool is_int;
+  vals_view<double> vals_r;
+  vals_view<int> vals_i;
+  vals_view<size_t> dims;
+
+  /**
+   * Construct an entry for a variable that is not defined.
+   */
+  var_entry() : found(false), is_int(false) {}
+
+  /**
+   * Return <code>true</code> if the variable is defined.
+   */
+  explicit operator bool() const { return found; }
+
+  /**
+   * Return the values as doubles.  Real values are viewed as they
+   * are; integer values are converted into a view that owns them.
+   *
+   * @return view of the values
+   */
+  vals_view<double> real_vals() const {
+    if (!is_int)
+      return vals_r;
+    return vals_view<double>(std::vector<double>(vals_i.begin(), vals_i.end()));
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,201 @@
+#ifndef STAN_IO_VAR_INDEX_HPP
+#define STAN_IO_VAR_INDEX_HPP
+
+#include <stan/io/var_entry.hpp>
+#include <stan/io/vals_view.hpp>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Storage for the variables of a <code>var_context</code>, indexed by
+ * name in a hash table.
+ *
+ * Real and integer variables share one table, so every query about a
+ * name, including whether it is an integer variable, takes a single
+ * hash lookup, and each name is stored once, as the key of its
+ * variable.  The accessors follow the <code>var_context</code>
+ * conventions, so contexts can forward to them: integer variables are
+ * also visible to the real accessors, converted to doubles, and
+ * unknown names give empty results.
+ *
+ * Names are listed in sorted order, as they are by contexts that keep
+ * their variables in a <code>std::map</code>.
+ */
+class var_index {
+ public:
+  /**
+   * A variable: values of its type in column-major order and its
+   * dimensions.
+   */
+  struct var {
+    bool is_int;
+    std::vector<double> vals_r;
+    std::vector<int> vals_i;
+    std::vector<size_t> dims;
+
+    var() : is_int(false) {}
+  };
+
+ private:
+  std::unordered_map<std::string, var> vars_;
+
+  template <typename F>
+  void sorted_names(std::vector<std::string>& names, F select) const {
+    names.resize(0);
+    for (const auto& v : vars_)
+      if (select(v.second))
+        names.push_back(v.first);
+    std::sort(names.begin(), names.end());
+  }
+
+ public:
+  /**
+   * Return the variable with the specified name, or
+   * <code>nullptr</code> if there is none.
+   *
+   * @param name name of variable
+   * @return pointer to variable or <code>nullptr</code>
+   */
+  const var* find(const std::string& name) const {
+    auto it = vars_.find(name);
+    return it == vars_.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * Return a new, empty real variable with the specified name,
+   * replacing any variable of that name.
+   *
+   * @param name name of variable
+   * @return variable to fill in
+   */
+  var& insert_r(const std::string& name) {
+    var& v = vars_[name];
+    v = var();
+    return v;
+  }
+
+  /**
+   * Return a new, empty integer variable with the specified name,
+   * replacing any variable of that name.
+   *
+   * @param name name of variable
+   * @return variable to fill in
+   */
+  var& insert_i(const std::string& name) {
+    var& v = insert_r(name);
+    v.is_int = true;
+    return v;
+  }
+
+  /**
+   * Remove the variable with the specified name.
+   *
+   * @param name name of variable
+   * @return <code>true</code> if there was such a variable
+   */
+  bool erase(const std::string& name) { return vars_.erase(name) > 0; }
+
+  /**
+   * Reserve space for the specified number of variables.
+   *
+   * @param n number of variables
+   */
+  void reserve(size_t n) { vars_.reserve(n); }
+
+  size_t size() const { return vars_.size(); }
+
+  bool contains_r(const std::string& name) const {
+    return find(name) != nullptr;
+  }
+
+  bool contains_i(const std::string& name) const {
+    const var* v = find(name);
+    return v != nullptr && v->is_int;
+  }
+
+  std::vector<double> vals_r(const std::string& name) const {
+    const var* v = find(name);
+    if (v == nullptr)
+      return std::vector<double>();
+    if (v->is_int)
+      return std::vector<double>(v->vals_i.begin(), v->vals_i.end());
+    return v->vals_r;
+  }
+
+  std::vector<int> vals_i(const std::string& name) const {
+    const var* v = find(name);
+    return v != nullptr && v->is_int ? v->vals_i : std::vector<int>();
+  }
+
+  std::vector<size_t> dims_r(const std::string& name) const {
+    const var* v = find(name);
+    return v != nullptr ? v->dims : std::vector<size_t>();
+  }
+
+  std::vector<size_t> dims_i(const std::string& name) const {
+    const var* v = find(name);
+    return v != nullptr && v->is_int ? v->dims : std::vector<size_t>();
+  }
+
+  vals_view<double> vals_r_view(const std::string& name) const {
+    return lookup(name).real_vals();
+  }
+
+  vals_view<int> vals_i_view(const std::string& name) const {
+    const var* v = find(name);
+    return v != nullptr && v->is_int ? vals_view<int>(v->vals_i)
+                                     : vals_view<int>();
+  }
+
+  /**
+   * Look up the variable with the specified name, viewing its values
+   * and dimensions in place.
+   *
+   * @param name name of variable
+   * @return entry for the variable
+   */
+  var_entry lookup(const std::string& name) const {
+    var_entry entry;
+    const var* v = find(name);
+    if (v == nullptr)
+      return entry;
+    entry.found = true;
+    entry.is_int = v->is_int;
+    if (v->is_int)
+      entry.vals_i = vals_view<int>(v->vals_i);
+    else
+      entry.vals_r = vals_view<double>(v->vals_r);
+    entry.dims = vals_view<size_t>(v->dims);
+    return entry;
+  }
+
+  /**
+   * Fill the specified vector with the sorted names of the real
+   * variables.
+   *
+   * @param names vector to store the names in
+   */
+  void names_r(std::vector<std::string>& names) const {
+    sorted_names(names, [](const var& v) { return !v.is_int; });
+  }
+
+  /**
+   * Fill the specified vector with the sorted names of the integer
+   * variables.
+   *
+   * @param names vector to store the names in
+   */
+  void names_i(std::vector<std::string>& names) const {
+    sorted_names(names, [](const var& v) { return v.is_int; });
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
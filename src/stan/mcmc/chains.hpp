@@ -5,6 +5,8 @@
 #include <stan/math/prim.hpp>
 #include <stan/analyze/mcmc/compute_effective_sample_size.hpp>
 #include <stan/analyze/mcmc/compute_potential_scale_reduction.hpp>
+#include <stan/analyze/mcmc/compute_split_rank_normalized_ess.hpp>
+#include <stan/analyze/mcmc/compute_split_rank_normalized_rhat.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -51,6 +53,21 @@ class chains {
   Eigen::Matrix<Eigen::MatrixXd, Dynamic, 1> samples_;
   Eigen::VectorXi warmup_;
 
+  void check_header(const stan::io::stan_csv& stan_csv) const {
+    if (stan_csv.header.size() != num_params())
+      throw std::invalid_argument(
+          "add(stan_csv): number of columns in"
+          " sample does not match chains");
+    for (int i = 0; i < num_params(); i++) {
+      if (param_names_[i] != stan_csv.header[i]) {
+        std::stringstream ss;
+        ss << "add(stan_csv): header " << param_names_[i]
+           << " does not match chain's header (" << stan_csv.header[i] << ")";
+        throw std::invalid_argument(ss.str());
+      }
+    }
+  }
+
   static double mean(const Eigen::VectorXd& x) {
     return (x.array() / x.size()).sum();
   }
@@ -206,45 +223,25 @@ class chains {
   }
 
   /**
-   * Return the split potential scale reduction (split R hat)
-   * for the specified parameter.
+   * Points into the kept draws of every chain for the specified
+   * parameter without copying them.  Storage is column major, so the
+   * kept draws of a parameter are contiguous within each chain.
    *
-   * Current implementation takes the minimum number of samples
-   * across chains as the number of samples per chain.
-   *
-   * @param VectorXd
-   * @param Dynamic
-   * @param samples
-   *
-   * @return
+   * @param[in] index parameter index
+   * @param[out] draws pointers to the first kept draw of each chain
+   * @param[out] sizes number of kept draws of each chain
    */
-  double split_potential_scale_reduction(
-      const Eigen::Matrix<Eigen::VectorXd, Dynamic, 1>& samples) const {
-    int chains = samples.size();
-    int n_samples = samples(0).size();
-    for (int chain = 1; chain < chains; chain++) {
-      n_samples = std::min(n_samples, static_cast<int>(samples(chain).size()));
-    }
-    if (n_samples % 2 == 1)
-      n_samples--;
-    int n = n_samples / 2;
-
-    Eigen::VectorXd split_chain_mean(2 * chains);
-    Eigen::VectorXd split_chain_var(2 * chains);
-
-    for (int chain = 0; chain < chains; chain++) {
-      split_chain_mean(2 * chain) = mean(samples(chain).topRows(n));
-      split_chain_mean(2 * chain + 1) = mean(samples(chain).bottomRows(n));
-
-      split_chain_var(2 * chain) = variance(samples(chain).topRows(n));
-      split_chain_var(2 * chain + 1) = variance(samples(chain).bottomRows(n));
+  void kept_draws(const int index, std::vector<const double*>& draws,
+                  std::vector<size_t>& sizes) const {
+    int n_chains = num_chains();
+    draws.resize(n_chains);
+    sizes.resize(n_chains);
+    for (int chain = 0; chain < n_chains; ++chain) {
+      int n_kept_samples = num_kept_samples(chain);
+      draws[chain]
+          = samples_(chain).col(index).bottomRows(n_kept_samples).data();
+      sizes[chain] = n_kept_samples;
     }
-
-    double var_between = n * variance(split_chain_mean);
-    double var_within = mean(split_chain_var);
-
-    // rewrote [(n-1)*W/n + B/n]/W as (n-1+ B/W)/n
-    return sqrt((var_between / var_within + n - 1) / n);
   }
 
  public:
@@ -257,6 +254,22 @@ class chains {
       add(stan_csv);
   }
 
+  /**
+   * Construct chains from parsed Stan CSV files, one chain per file,
+   * moving the draws in without copying them.
+   *
+   * @param stan_csvs parsed files with matching headers, for instance
+   *   from <code>stan::io::stan_csv_reader::parse_files</code>
+   * @throw std::invalid_argument if the headers do not match
+   */
+  explicit chains(std::vector<stan::io::stan_csv>&& stan_csvs)
+      : chains(stan_csvs.empty() ? std::vector<std::string>()
+                                 : stan_csvs[0].header) {
+    for (auto& stan_csv : stan_csvs)
+      if (stan_csv.samples.rows() > 0)
+        add(std::move(stan_csv));
+  }
+
   inline int num_chains() const { return samples_.size(); }
 
   inline int num_params() const { return param_names_.size(); }
@@ -368,23 +381,43 @@ class chains {
   }
 
   void add(const stan::io::stan_csv& stan_csv) {
-    if (stan_csv.header.size() != num_params())
-      throw std::invalid_argument(
-          "add(stan_csv): number of columns in"
-          " sample does not match chains");
-    for (int i = 0; i < num_params(); i++) {
-      if (param_names_[i] != stan_csv.header[i]) {
-        std::stringstream ss;
-        ss << "add(stan_csv): header " << param_names_[i]
-           << " does not match chain's header (" << stan_csv.header[i] << ")";
-        throw std::invalid_argument(ss.str());
-      }
-    }
+    check_header(stan_csv);
     add(stan_csv.samples);
     if (stan_csv.metadata.save_warmup)
       set_warmup(num_chains() - 1, stan_csv.metadata.num_warmup);
   }
 
+  /**
+   * Add the draws of a parsed Stan CSV file as a new chain, moving
+   * them in without copying.  The draws of <code>stan_csv</code> are
+   * left empty.
+   *
+   * @param stan_csv parsed file
+   * @throw std::invalid_argument if the header does not match or the
+   * number of columns of the draws does not match the chains
+   */
+  void add(stan::io::stan_csv&& stan_csv) {
+    check_header(stan_csv);
+    if (stan_csv.samples.rows() == 0)
+      return;
+    if (stan_csv.samples.cols() != num_params())
+      throw std::invalid_argument(
+          "add(sample): number of columns in"
+          " sample does not match chains");
+    int n = num_chains();
+    Eigen::Matrix<Eigen::MatrixXd, Dynamic, 1> samples(n + 1);
+    Eigen::VectorXi warmup(n + 1);
+    for (int i = 0; i < n; i++) {
+      samples(i).swap(samples_(i));
+      warmup(i) = warmup_(i);
+    }
+    samples(n).swap(stan_csv.samples);
+    warmup(n)
+        = stan_csv.metadata.save_warmup ? stan_csv.metadata.num_warmup : 0;
+    samples_.swap(samples);
+    warmup_.swap(warmup);
+  }
+
   Eigen::VectorXd samples(const int chain, const int index) const {
     return samples_(chain).col(index).bottomRows(num_kept_samples(chain));
   }
@@ -562,16 +595,9 @@ class chains {
 
   // FIXME: reimplement using autocorrelation.
   double effective_sample_size(const int index) const {
-    int n_chains = num_chains();
-    std::vector<const double*> draws(n_chains);
-    std::vector<size_t> sizes(n_chains);
-    int n_kept_samples = 0;
-    for (int chain = 0; chain < n_chains; ++chain) {
-      n_kept_samples = num_kept_samples(chain);
-      draws[chain]
-          = samples_(chain).col(index).bottomRows(n_kept_samples).data();
-      sizes[chain] = n_kept_samples;
-    }
+    std::vector<const double*> draws;
+    std::vector<size_t> sizes;
+    kept_draws(index, draws, sizes);
     return analyze::compute_effective_sample_size(draws, sizes);
   }
 
@@ -580,16 +606,9 @@ class chains {
   }
 
   double split_effective_sample_size(const int index) const {
-    int n_chains = num_chains();
-    std::vector<const double*> draws(n_chains);
-    std::vector<size_t> sizes(n_chains);
-    int n_kept_samples = 0;
-    for (int chain = 0; chain < n_chains; ++chain) {
-      n_kept_samples = num_kept_samples(chain);
-      draws[chain]
-          = samples_(chain).col(index).bottomRows(n_kept_samples).data();
-      sizes[chain] = n_kept_samples;
-    }
+    std::vector<const double*> draws;
+    std::vector<size_t> sizes;
+    kept_draws(index, draws, sizes);
     return analyze::compute_split_effective_sample_size(draws, sizes);
   }
 
@@ -598,23 +617,53 @@ class chains {
   }
 
   double split_potential_scale_reduction(const int index) const {
-    int n_chains = num_chains();
-    std::vector<const double*> draws(n_chains);
-    std::vector<size_t> sizes(n_chains);
-    int n_kept_samples = 0;
-    for (int chain = 0; chain < n_chains; ++chain) {
-      n_kept_samples = num_kept_samples(chain);
-      draws[chain]
-          = samples_(chain).col(index).bottomRows(n_kept_samples).data();
-      sizes[chain] = n_kept_samples;
-    }
-
+    std::vector<const double*> draws;
+    std::vector<size_t> sizes;
+    kept_draws(index, draws, sizes);
     return analyze::compute_split_potential_scale_reduction(draws, sizes);
   }
 
   double split_potential_scale_reduction(const std::string& name) const {
     return split_potential_scale_reduction(index(name));
   }
+
+  /**
+   * Return the rank-normalized split potential scale reduction for
+   * the bulk and the tails of the specified parameter.
+   *
+   * @param index parameter index
+   * @return pair of bulk and tail split R hat
+   */
+  std::pair<double, double> split_rank_normalized_rhat(const int index) const {
+    std::vector<const double*> draws;
+    std::vector<size_t> sizes;
+    kept_draws(index, draws, sizes);
+    return analyze::compute_split_rank_normalized_rhat(draws, sizes);
+  }
+
+  std::pair<double, double> split_rank_normalized_rhat(
+      const std::string& name) const {
+    return split_rank_normalized_rhat(index(name));
+  }
+
+  /**
+   * Return the bulk and tail effective sample size of the specified
+   * parameter, computed from the rank-normalized split chains.
+   *
+   * @param index parameter index
+   * @return pair of bulk and tail effective sample size
+   */
+  std::pair<double, double> split_rank_normalized_ess(const int index) const {
+    std::vector<const double*> draws;
+    std::vector<size_t> sizes;
+    kept_draws(index, draws, sizes);
+    return analyze::compute_split_rank_normalized_ess(draws, sizes);
+  }
+
+  std::pair<double, double> split_rank_normalized_ess(
+      const std::string& name) const {
+    return split_rank_normalized_ess(index(name));
+  }
 };
 
 }  // namespace mcmc
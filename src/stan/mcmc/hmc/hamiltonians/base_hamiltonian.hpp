@@ -3,10 +3,10 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
-#include <stan/model/gradient.hpp>
-#include <stan/model/log_prob_propto.hpp>
+#include <stan/model/gradient_workspace.hpp>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 
@@ -51,7 +51,7 @@ class base_hamiltonian {
 
   void update_potential(Point& z, callbacks::logger& logger) {
     try {
-      z.V = -stan::model::log_prob_propto<true>(model_, z.q);
+      z.V = -workspace_.log_prob_propto<true>(model_, z.q);
     } catch (const std::exception& e) {
       this->write_error_msg_(e, logger);
       z.V = std::numeric_limits<double>::infinity();
@@ -59,10 +59,15 @@ class base_hamiltonian {
   }
 
   void update_potential_gradient(Point& z, callbacks::logger& logger) {
+    std::stringstream msgs;
+    z.g.resize(z.q.size());
     try {
-      stan::model::gradient(model_, z.q, z.V, z.g, logger);
-      z.V = -z.V;
+      z.V = -workspace_.log_prob_grad<true, true>(model_, z.q, z.g, &msgs);
+      if (msgs.str().length() > 0)
+        logger.info(msgs);
     } catch (const std::exception& e) {
+      if (msgs.str().length() > 0)
+        logger.info(msgs);
       this->write_error_msg_(e, logger);
       z.V = std::numeric_limits<double>::infinity();
     }
@@ -79,6 +84,7 @@ class base_hamiltonian {
 
  protected:
   const Model& model_;
+  stan::model::gradient_workspace workspace_;
 
   void write_error_msg_(const std::exception& e, callbacks::logger& logger) {
     logger.error(
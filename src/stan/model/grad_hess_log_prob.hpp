@@ -1,19 +1,48 @@
 #ifndef STAN_MODEL_GRAD_HESS_LOG_PROB_HPP
 #define STAN_MODEL_GRAD_HESS_LOG_PROB_HPP
 
+#include <stan/math/rev.hpp>
+#include <stan/model/gradient_workspace.hpp>
 #include <stan/model/log_prob_grad.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
 #include <iostream>
 #include <vector>
 
 namespace stan {
 namespace model {
 
+/**
+ * Finite difference stencils for differentiating the gradient in
+ * <code>grad_hess_log_prob</code>.
+ */
+enum hessian_stencil {
+  /**
+   * Fourth order central differences, with four gradient evaluations
+   * per dimension at steps of one and two times 1e-3.
+   */
+  four_point,
+  /**
+   * Second order central differences, with two gradient evaluations
+   * per dimension at steps of 1e-5; half the cost of
+   * <code>four_point</code> and less accurate.
+   */
+  two_point
+};
+
 /**
  * Evaluate the log-probability, its gradient, and its Hessian
  * at params_r. This default version computes the Hessian
  * numerically by finite-differencing the gradient, at a cost of
  * O(params_r.size()^2).
  *
+ * Each dimension needs its own gradient evaluations at points
+ * perturbed along that dimension.  The dimensions are differentiated
+ * with <code>internal::parallel_for_each</code>, each worker reusing
+ * one <code>gradient_workspace</code> and scratch vectors.  Each
+ * dimension's finite difference is computed by a single worker, and
+ * the result is symmetrized after all dimensions are done, so the
+ * Hessian does not depend on the number of threads.
+ *
  * @tparam propto True if calculation is up to proportion
  * (double-only terms dropped).
  * @tparam jacobian_adjust_transform True if the log absolute
@@ -27,6 +56,7 @@ namespace model {
  * @param[out] hessian Vector to write gradient to. hessian[i*D + j]
  * gives the element at the ith row and jth column of the Hessian
  * (where D=params_r.size()).
+ * @param[in] stencil finite difference stencil
  * @param[in, out] msgs Stream to which print statements in Stan
  * programs are written, default is 0
  */
@@ -35,40 +65,101 @@ double grad_hess_log_prob(const M& model, std::vector<double>& params_r,
                           std::vector<int>& params_i,
                           std::vector<double>& gradient,
                           std::vector<double>& hessian,
-                          std::ostream* msgs = 0) {
-  static const double epsilon = 1e-3;
-  static const double half_epsilon = 0.5 * epsilon;
-  static const int order = 4;
-  static const double perturbations[order]
-      = {-2 * epsilon, -1 * epsilon, epsilon, 2 * epsilon};
-  static const double coefficients[order]
+                          hessian_stencil stencil, std::ostream* msgs = 0) {
+  static const double four_point_epsilon = 1e-3;
+  static const double four_point_perturbations[4]
+      = {-2 * four_point_epsilon, -1 * four_point_epsilon, four_point_epsilon,
+         2 * four_point_epsilon};
+  static const double four_point_coefficients[4]
       = {1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0};
-  static const double half_epsilon_coeff[order]
-      = {half_epsilon * coefficients[0], half_epsilon * coefficients[1],
-         half_epsilon * coefficients[2], half_epsilon * coefficients[3]};
+  static const double two_point_epsilon = 1e-5;
+  static const double two_point_perturbations[2]
+      = {-two_point_epsilon, two_point_epsilon};
+  static const double two_point_coefficients[2] = {-0.5, 0.5};
+
+  const bool four = stencil == four_point;
+  const int order = four ? 4 : 2;
+  const double* perturbations
+      = four ? four_point_perturbations : two_point_perturbations;
+  const double* coefficients
+      = four ? four_point_coefficients : two_point_coefficients;
+  // each dimension's difference contributes half to both the row and
+  // the column of the symmetric Hessian
+  const double half_inv_epsilon
+      = 0.5 / (four ? four_point_epsilon : two_point_epsilon);
+
   double result = log_prob_grad<propto, jacobian_adjust_transform>(
       model, params_r, params_i, gradient, msgs);
-  hessian.assign(params_r.size() * params_r.size(), 0);
-  std::vector<double> temp_grad(params_r.size());
-  std::vector<double> perturbed_params(params_r.begin(), params_r.end());
-  for (size_t d = 0; d < params_r.size(); ++d) {
-    const int row_iter = d * params_r.size();
-    for (int i = 0; i < order; ++i) {
-      perturbed_params[d] = params_r[d] + perturbations[i];
-      log_prob_grad<propto, jacobian_adjust_transform>(model, perturbed_params,
-                                                       params_i, temp_grad);
-      for (size_t dd = 0; dd < params_r.size(); ++dd) {
-        const double increment = half_epsilon_coeff[i] * temp_grad[dd];
-        const int col_iter = dd * params_r.size();
-        hessian[dd + row_iter] += increment;
-        hessian[d + col_iter] += increment;
-      }
-    }
-    perturbed_params[d] = params_r[d];
-  }
+
+  const size_t num_params = params_r.size();
+  Eigen::Map<const Eigen::VectorXd> x(params_r.data(), num_params);
+  // column d holds the finite difference of the gradient along d
+  Eigen::MatrixXd differences(num_params, num_params);
+  struct scratch {
+    gradient_workspace workspace;
+    Eigen::VectorXd perturbed;
+    Eigen::VectorXd temp_grad;
+  };
+  internal::parallel_for_each(
+      num_params,
+      [&] {
+        return scratch{gradient_workspace(), x, Eigen::VectorXd(num_params)};
+      },
+      [&](size_t d, scratch& s) {
+        differences.col(d).setZero();
+        try {
+          for (int i = 0; i < order; ++i) {
+            s.perturbed(d) = x(d) + perturbations[i];
+            s.workspace
+                .template log_prob_grad<propto, jacobian_adjust_transform>(
+                    model, s.perturbed, s.temp_grad);
+            differences.col(d)
+                += (half_inv_epsilon * coefficients[i]) * s.temp_grad;
+          }
+        } catch (...) {
+          s.perturbed(d) = x(d);
+          throw;
+        }
+        s.perturbed(d) = x(d);
+      });
+
+  hessian.resize(num_params * num_params);
+  Eigen::Map<Eigen::MatrixXd> H(hessian.data(), num_params, num_params);
+  H = differences + differences.transpose();
   return result;
 }
 
+/**
+ * Evaluate the log-probability, its gradient, and its Hessian
+ * at params_r, computing the Hessian with the
+ * <code>four_point</code> stencil.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[out] gradient Vector to write gradient to.
+ * @param[out] hessian Vector to write gradient to. hessian[i*D + j]
+ * gives the element at the ith row and jth column of the Hessian
+ * (where D=params_r.size()).
+ * @param[in, out] msgs Stream to which print statements in Stan
+ * programs are written, default is 0
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double grad_hess_log_prob(const M& model, std::vector<double>& params_r,
+                          std::vector<int>& params_i,
+                          std::vector<double>& gradient,
+                          std::vector<double>& hessian,
+                          std::ostream* msgs = 0) {
+  return grad_hess_log_prob<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, gradient, hessian, four_point, msgs);
+}
+
 }  // namespace model
 }  // namespace stan
 #endif
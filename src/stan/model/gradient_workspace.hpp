@@ -0,0 +1,122 @@
+#ifndef STAN_MODEL_GRADIENT_WORKSPACE_HPP
+#define STAN_MODEL_GRADIENT_WORKSPACE_HPP
+
+#include <stan/math/rev.hpp>
+#include <ostream>
+#include <stdexcept>
+
+namespace stan {
+namespace model {
+
+/**
+ * Reusable workspace for evaluating the log density of a model and its
+ * gradient with reverse-mode automatic differentiation, for
+ * algorithms that evaluate the same model over and over.
+ *
+ * Unlike <code>log_prob_grad</code> and <code>gradient</code>, the
+ * evaluations take the parameters and write the gradient through
+ * <code>Eigen::Ref</code>, so no copies of either are made, and the
+ * vector of autodiff parameters is kept between calls instead of
+ * being allocated for each one.  Each evaluation runs in a nested
+ * autodiff context: the gradient only chains the nested part of the
+ * stack and the memory it used is recovered by rewinding the arena to
+ * where the evaluation started, which keeps the arena's blocks for the
+ * next call and leaves anything already on the stack untouched.
+ *
+ * A workspace must only be used by one thread at a time, on the
+ * autodiff stack of that thread.
+ */
+class gradient_workspace {
+ private:
+  Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1> params_;
+
+  void set_params(const Eigen::Ref<const Eigen::VectorXd>& params_r) {
+    params_.resize(params_r.size());
+    for (int i = 0; i < params_r.size(); ++i)
+      params_.coeffRef(i) = params_r.coeff(i);
+  }
+
+ public:
+  /**
+   * Return the log density of the specified model at the specified
+   * unconstrained parameters, writing its gradient into the specified
+   * vector.
+   *
+   * @tparam propto True if calculation is up to proportion
+   * (double-only terms dropped).
+   * @tparam jacobian_adjust_transform True if the log absolute
+   * Jacobian determinant of inverse parameter transforms is added to
+   * the log probability.
+   * @tparam M Class of model.
+   * @param[in] model Model.
+   * @param[in] params_r Real-valued parameters.
+   * @param[out] gradient Vector into which the gradient is written;
+   * must be the size of the parameters.
+   * @param[in,out] msgs
+   * @return log density
+   * @throw std::invalid_argument if the gradient is not the size of
+   * the parameters
+   */
+  template <bool propto, bool jacobian_adjust_transform, class M>
+  double log_prob_grad(const M& model,
+                       const Eigen::Ref<const Eigen::VectorXd>& params_r,
+                       Eigen::Ref<Eigen::VectorXd> gradient,
+                       std::ostream* msgs = 0) {
+    if (gradient.size() != params_r.size())
+      throw std::invalid_argument(
+          "gradient_workspace: gradient must be the size of the parameters");
+    stan::math::start_nested();
+    try {
+      set_params(params_r);
+      stan::math::var lp
+          = model.template log_prob<propto, jacobian_adjust_transform>(
+              params_, msgs);
+      double val = lp.val();
+      lp.grad();
+      for (int i = 0; i < gradient.size(); ++i)
+        gradient.coeffRef(i) = params_.coeff(i).adj();
+      stan::math::recover_memory_nested();
+      return val;
+    } catch (const std::exception& e) {
+      stan::math::recover_memory_nested();
+      throw;
+    }
+  }
+
+  /**
+   * Return the log density of the specified model at the specified
+   * unconstrained parameters, dropping constant terms, without
+   * computing the gradient.
+   *
+   * @tparam jacobian_adjust_transform True if the log absolute
+   * Jacobian determinant of inverse parameter transforms is added to
+   * the log probability.
+   * @tparam M Class of model.
+   * @param[in] model Model.
+   * @param[in] params_r Real-valued parameters.
+   * @param[in,out] msgs
+   * @return log density up to a constant
+   */
+  template <bool jacobian_adjust_transform, class M>
+  double log_prob_propto(const M& model,
+                         const Eigen::Ref<const Eigen::VectorXd>& params_r,
+                         std::ostream* msgs = 0) {
+    stan::math::start_nested();
+    try {
+      set_params(params_r);
+      double val = model
+                       .template log_prob<true, jacobian_adjust_transform>(
+                           params_, msgs)
+                       .val();
+      stan::math::recover_memory_nested();
+      return val;
+    } catch (const std::exception& e) {
+      stan::math::recover_memory_nested();
+      throw;
+    }
+  }
+};
+
+}  // namespace model
+}  // namespace stan
+#endif
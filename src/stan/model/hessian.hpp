@@ -2,12 +2,18 @@
 #define STAN_MODEL_HESSIAN_HPP
 
 #include <stan/math/mix.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
 #include <stan/model/model_functional.hpp>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace stan {
 namespace model {
 
+class model_base;
+
 template <class M>
 void hessian(const M& model, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
              double& f, Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_f,
@@ -17,6 +23,115 @@ void hessian(const M& model, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
                                             f, grad_f, hess_f);
 }
 
+/**
+ * Trait for models whose log density can be evaluated with
+ * <code>fvar<var></code> scalars, as needed for autodiff Hessians.
+ * Models generated by stanc can; <code>model_base</code> only
+ * declares the <code>double</code> and <code>var</code> overloads.
+ *
+ * @tparam M Class of model.
+ */
+template <class M>
+struct has_autodiff_hessian
+    : std::integral_constant<
+          bool,
+          !std::is_same<typename std::decay<M>::type, model_base>::value> {};
+
+namespace internal {
+
+template <bool propto, bool jacobian_adjust_transform, class M>
+void hessian(const M& model, const Eigen::VectorXd& x, double& f,
+             Eigen::VectorXd& grad_f, Eigen::MatrixXd& hess_f,
+             std::ostream* msgs, std::true_type) {
+  using stan::math::fvar;
+  using stan::math::var;
+  const int num_params = x.size();
+  grad_f.resize(num_params);
+  hess_f.resize(num_params, num_params);
+  if (num_params == 0) {
+    Eigen::VectorXd params_r = x;
+    f = model.template log_prob<propto, jacobian_adjust_transform>(params_r,
+                                                                   msgs);
+    return;
+  }
+
+  typedef Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> fvar_vector;
+  internal::parallel_for_each(
+      num_params, [&] { return fvar_vector(num_params); },
+      [&](size_t d, fvar_vector& x_fvar) {
+        stan::math::start_nested();
+        try {
+          for (int i = 0; i < num_params; ++i)
+            x_fvar(i) = fvar<var>(x(i), i == static_cast<int>(d));
+          fvar<var> fx
+              = model.template log_prob<propto, jacobian_adjust_transform>(
+                  x_fvar, d == 0 ? msgs : 0);
+          stan::math::grad(fx.d_.vi_);
+          if (d == 0)
+            f = fx.val_.val();
+          grad_f(d) = fx.d_.val();
+          for (int i = 0; i < num_params; ++i)
+            hess_f(i, d) = x_fvar(i).val_.adj();
+        } catch (...) {
+          stan::math::recover_memory_nested();
+          throw;
+        }
+        stan::math::recover_memory_nested();
+      });
+}
+
+template <bool propto, bool jacobian_adjust_transform, class M>
+void hessian(const M& model, const Eigen::VectorXd& x, double& f,
+             Eigen::VectorXd& grad_f, Eigen::MatrixXd& hess_f,
+             std::ostream* msgs, std::false_type) {
+  throw std::invalid_argument(
+      "autodiff Hessians require a model class generated by stanc;"
+      " model_base does not support fvar<var> log densities");
+}
+
+}  // namespace internal
+
+/**
+ * Compute the log density, its gradient and its Hessian at the
+ * specified unconstrained parameters exactly, using forward-over-
+ * reverse automatic differentiation.
+ *
+ * Column <code>d</code> of the Hessian is the gradient of the
+ * directional derivative of the log density along dimension
+ * <code>d</code>, computed with one <code>fvar<var></code> evaluation
+ * and one reverse pass in a nested autodiff context.  Unlike the
+ * overload above, the log density is the one selected by
+ * <code>propto</code> and <code>jacobian_adjust_transform</code>.
+ *
+ * The columns are computed with <code>internal::parallel_for_each</code>.
+ * Messages are only written by the evaluation for the first column.
+ * If any evaluation throws, the exception of the first failing column
+ * is rethrown.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] x Unconstrained parameters.
+ * @param[out] f Log density.
+ * @param[out] grad_f Gradient of the log density.
+ * @param[out] hess_f Hessian of the log density.
+ * @param[in,out] msgs
+ * @throw std::invalid_argument if the model class does not support
+ * autodiff Hessians (see <code>has_autodiff_hessian</code>)
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void hessian(const M& model, const Eigen::VectorXd& x, double& f,
+             Eigen::VectorXd& grad_f, Eigen::MatrixXd& hess_f,
+             std::ostream* msgs = 0) {
+  internal::hessian<propto, jacobian_adjust_transform>(
+      model, x, f, grad_f, hess_f, msgs,
+      std::integral_constant<bool, has_autodiff_hessian<M>::value>());
+}
+
 }  // namespace model
 }  // namespace stan
 #endif
@@ -0,0 +1,159 @@
+#ifndef STAN_MODEL_LOG_PROB_GRAD_BATCH_HPP
+#define STAN_MODEL_LOG_PROB_GRAD_BATCH_HPP
+
+#include <stan/math/rev.hpp>
+#include <stan/model/gradient_workspace.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <exception>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+namespace model {
+
+namespace internal {
+
+/**
+ * Call <code>f(i, scratch)</code> for every index <code>i</code> in
+ * <code>[0, n)</code>, where <code>scratch</code> is working space
+ * returned by <code>make_scratch()</code> once per range of indices and
+ * reused by every index in the range.
+ *
+ * When Stan is built with <code>STAN_THREADS</code> the ranges run in
+ * parallel on the TBB thread pool.  Each worker runs on its own
+ * thread-local autodiff stack, creating it if the thread has none, so
+ * <code>f</code> may use reverse-mode autodiff as long as it recovers
+ * the memory it uses, for instance in a nested context.  Without
+ * threads there is a single autodiff stack and the indices run in
+ * order on the calling thread.  As long as <code>f</code> only writes
+ * the results of index <code>i</code> to slots of its own, the results
+ * do not depend on the number of threads.
+ *
+ * An exception thrown for one index does not stop the others; once
+ * every index has run, the exception of the first failing index is
+ * rethrown.
+ *
+ * @tparam S Type of the functor making the working space.
+ * @tparam F Type of the functor called for each index.
+ * @param[in] n Number of indices.
+ * @param[in] make_scratch Functor returning working space.
+ * @param[in] f Functor called with each index and working space.
+ */
+template <typename S, typename F>
+void parallel_for_each(size_t n, const S& make_scratch, const F& f) {
+  std::vector<std::exception_ptr> errors(n);
+  auto run = [&](size_t begin, size_t end) {
+    auto&& scratch = make_scratch();
+    for (size_t i = begin; i < end; ++i) {
+      try {
+        f(i, scratch);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n, 1),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                      stan::math::ChainableStack thread_tape;
+                      run(r.begin(), r.end());
+                    });
+#else
+  run(0, n);
+#endif
+
+  for (size_t i = 0; i < n; ++i)
+    if (errors[i])
+      std::rethrow_exception(errors[i]);
+}
+
+/**
+ * Call <code>f(i)</code> for every index <code>i</code> in
+ * <code>[0, n)</code>, in parallel as described for the overload
+ * with working space.
+ *
+ * @tparam F Type of the functor called for each index.
+ * @param[in] n Number of indices.
+ * @param[in] f Functor called with each index.
+ */
+template <typename F>
+void parallel_for_each(size_t n, const F& f) {
+  parallel_for_each(n, [] { return 0; }, [&](size_t i, int) { f(i); });
+}
+
+}  // namespace internal
+
+/**
+ * Compute the log density and its gradient at each of the specified
+ * points using reverse-mode automatic differentiation, writing the
+ * results into the specified preallocated outputs.
+ *
+ * Points are the columns of <code>points</code>; the log density at
+ * column <code>j</code> is written to <code>lp[j]</code> and its
+ * gradient to column <code>j</code> of <code>gradients</code>.  The
+ * columns are evaluated with <code>internal::parallel_for_each</code>,
+ * each worker reusing one <code>gradient_workspace</code>, so the
+ * results do not depend on the number of threads.
+ *
+ * Messages written by the model are buffered per point and written
+ * to <code>msgs</code> in column order.  If evaluation throws at any
+ * point, the exception of the first such column is rethrown once all
+ * points have been evaluated.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] points Unconstrained parameters, one point per column.
+ * @param[out] lp Vector into which the log densities are written.
+ * @param[out] gradients Matrix into which the gradients are written,
+ * one per column.
+ * @param[in,out] msgs
+ * @throw std::invalid_argument if the outputs do not match the number
+ * and size of the points
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void log_prob_grad_batch(const M& model,
+                         const Eigen::Ref<const Eigen::MatrixXd>& points,
+                         Eigen::Ref<Eigen::VectorXd> lp,
+                         Eigen::Ref<Eigen::MatrixXd> gradients,
+                         std::ostream* msgs = 0) {
+  const size_t num_points = points.cols();
+  if (static_cast<size_t>(lp.size()) != num_points
+      || gradients.rows() != points.rows()
+      || static_cast<size_t>(gradients.cols()) != num_points)
+    throw std::invalid_argument(
+        "log_prob_grad_batch: outputs must have one entry per point and "
+        "gradients the size of the points");
+
+  std::vector<std::stringstream> point_msgs(msgs != 0 ? num_points : 0);
+  std::exception_ptr error;
+  try {
+    internal::parallel_for_each(
+        num_points, [] { return gradient_workspace(); },
+        [&](size_t j, gradient_workspace& workspace) {
+          lp[j] = workspace.log_prob_grad<propto, jacobian_adjust_transform>(
+              model, points.col(j), gradients.col(j),
+              msgs != 0 ? &point_msgs[j] : 0);
+        });
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  if (msgs != 0)
+    for (size_t j = 0; j < num_points; ++j)
+      *msgs << point_msgs[j].str();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace model
+}  // namespace stan
+#endif
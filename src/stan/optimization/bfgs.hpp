@@ -2,8 +2,7 @@
 #define STAN_OPTIMIZATION_BFGS_HPP
 
 #include <stan/math/prim.hpp>
-#include <stan/model/log_prob_propto.hpp>
-#include <stan/model/log_prob_grad.hpp>
+#include <stan/model/gradient_workspace.hpp>
 #include <stan/optimization/bfgs_linesearch.hpp>
 #include <stan/optimization/bfgs_update.hpp>
 #include <stan/optimization/lbfgs_update.hpp>
@@ -293,29 +292,21 @@ template <class M>
 class ModelAdaptor {
  private:
   M &_model;
-  std::vector<int> _params_i;
   std::ostream *_msgs;
-  std::vector<double> _x, _g;
+  stan::model::gradient_workspace _workspace;
   size_t _fevals;
+  size_t _vevals;
 
  public:
   ModelAdaptor(M &model, const std::vector<int> &params_i, std::ostream *msgs)
-      : _model(model), _params_i(params_i), _msgs(msgs), _fevals(0) {}
+      : _model(model), _msgs(msgs), _fevals(0), _vevals(0) {}
 
   size_t fevals() const { return _fevals; }
+  size_t value_evals() const { return _vevals; }
   int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x, double &f) {
-    using Eigen::Dynamic;
-    using Eigen::Matrix;
-    using stan::math::index_type;
-    using stan::model::log_prob_propto;
-    typedef typename index_type<Matrix<double, Dynamic, 1> >::type idx_t;
-
-    _x.resize(x.size());
-    for (idx_t i = 0; i < x.size(); i++)
-      _x[i] = x[i];
-
+    _vevals++;
     try {
-      f = -log_prob_propto<false>(_model, _x, _params_i, _msgs);
+      f = -_workspace.log_prob_propto<false>(_model, x, _msgs);
     } catch (const std::exception &e) {
       if (_msgs)
         (*_msgs) << e.what() << std::endl;
@@ -334,37 +325,25 @@ class ModelAdaptor {
   }
   int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x, double &f,
                  Eigen::Matrix<double, Eigen::Dynamic, 1> &g) {
-    using Eigen::Dynamic;
-    using Eigen::Matrix;
-    using stan::math::index_type;
-    using stan::model::log_prob_grad;
-    typedef typename index_type<Matrix<double, Dynamic, 1> >::type idx_t;
-
-    _x.resize(x.size());
-    for (idx_t i = 0; i < x.size(); i++)
-      _x[i] = x[i];
-
     _fevals++;
 
+    g.resize(x.size());
     try {
-      f = -log_prob_grad<true, false>(_model, _x, _params_i, _g, _msgs);
+      f = -_workspace.log_prob_grad<true, false>(_model, x, g, _msgs);
     } catch (const std::exception &e) {
       if (_msgs)
         (*_msgs) << e.what() << std::endl;
       return 1;
     }
 
-    g.resize(_g.size());
-    for (size_t i = 0; i < _g.size(); i++) {
-      if (!std::isfinite(_g[i])) {
-        if (_msgs)
-          *_msgs << "Error evaluating model log probability: "
-                    "Non-finite gradient."
-                 << std::endl;
-        return 3;
-      }
-      g[i] = -_g[i];
+    if (!g.allFinite()) {
+      if (_msgs)
+        *_msgs << "Error evaluating model log probability: "
+                  "Non-finite gradient."
+               << std::endl;
+      return 3;
     }
+    g = -g;
 
     if (std::isfinite(f)) {
       return 0;
@@ -410,6 +389,7 @@ class BFGSLineSearch : public BFGSMinimizer<ModelAdaptor<M>, QNUpdateType,
   }
 
   size_t grad_evals() { return _adaptor.fevals(); }
+  size_t value_evals() { return _adaptor.value_evals(); }
   double logp() { return -(this->curr_f()); }
   double grad_norm() { return this->curr_g().norm(); }
   void grad(std::vector<double> &g) {
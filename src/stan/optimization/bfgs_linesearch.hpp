@@ -6,6 +6,9 @@
 #include <cstdlib>
 #include <string>
 #include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace stan {
 namespace optimization {
@@ -104,8 +107,175 @@ Scalar CubicInterp(const Scalar &x0, const Scalar &f0, const Scalar &df0,
   return x0 + CubicInterp(df0, x1 - x0, f1 - f0, df1, loX - x0, hiX - x0);
 }
 
+/**
+ * Find the minimum of the quadratic function which interpolates the
+ * function value and derivative at x0 and the function value at x1.
+ *
+ * @param x0 First point
+ * @param f0 First function value, f(x0)
+ * @param df0 First derivative value, f'(x0)
+ * @param x1 Second point
+ * @param f1 Second function value, f(x1)
+ **/
+template <typename Scalar>
+Scalar QuadraticInterp(const Scalar &x0, const Scalar &f0, const Scalar &df0,
+                       const Scalar &x1, const Scalar &f1) {
+  const Scalar t1 = x1 - x0;
+  return x0 - df0 * t1 * t1 / (2 * (f1 - f0 - df0 * t1));
+}
+
+/**
+ * Find the local minimum of the cubic function which interpolates the
+ * function value and derivative at x0 and the function values at x1
+ * and x2.
+ *
+ * @param x0 First point
+ * @param f0 First function value, f(x0)
+ * @param df0 First derivative value, f'(x0)
+ * @param x1 Second point
+ * @param f1 Second function value, f(x1)
+ * @param x2 Third point
+ * @param f2 Third function value, f(x2)
+ **/
+template <typename Scalar>
+Scalar CubicInterp(const Scalar &x0, const Scalar &f0, const Scalar &df0,
+                   const Scalar &x1, const Scalar &f1, const Scalar &x2,
+                   const Scalar &f2) {
+  // f(x0 + t) = f0 + df0 t + b t^2 + c t^3
+  const Scalar t1 = x1 - x0;
+  const Scalar t2 = x2 - x0;
+  const Scalar r1 = (f1 - f0 - df0 * t1) / (t1 * t1);
+  const Scalar r2 = (f2 - f0 - df0 * t2) / (t2 * t2);
+  const Scalar c = (r1 - r2) / (t1 - t2);
+  const Scalar b = r1 - c * t1;
+  if (c == 0)
+    return x0 - df0 / (2 * b);
+  return x0 + (-b + std::sqrt(b * b - 3 * c * df0)) / (3 * c);
+}
+
+namespace internal {
+/**
+ * Trait for functors which can evaluate the function without its
+ * gradient, as <code>ret = func(x, f)</code>.
+ **/
+template <typename FunctorType, typename Scalar, typename XType,
+          typename = void>
+struct has_value_only : std::false_type {};
+
+template <typename FunctorType, typename Scalar, typename XType>
+struct has_value_only<
+    FunctorType, Scalar, XType,
+    decltype(void(std::declval<int &>() = std::declval<FunctorType &>()(
+                      std::declval<const XType &>(),
+                      std::declval<Scalar &>())))> : std::true_type {};
+
+template <typename FunctorType, typename Scalar, typename XType>
+int evaluate_value(FunctorType &func, const XType &x, Scalar &f, XType &g,
+                   std::true_type) {
+  return func(x, f);
+}
+
+template <typename FunctorType, typename Scalar, typename XType>
+int evaluate_value(FunctorType &func, const XType &x, Scalar &f, XType &g,
+                   std::false_type) {
+  return func(x, f, g);
+}
+}  // namespace internal
+
+/**
+ * The trial points of a line search, keyed on step size, so that no
+ * point is evaluated twice and a gradient is only computed when the
+ * line search needs it.
+ *
+ * Trials which only test sufficient decrease are evaluated without
+ * the gradient if the functor supports <code>ret = func(x, f)</code>;
+ * the gradient is computed, and recorded, if the point then needs it.
+ * Trials at a step size already evaluated reuse the recorded value and
+ * gradient.
+ **/
+template <typename Scalar, typename XType>
+class LSEvaluationCache {
+ private:
+  struct trial {
+    Scalar alpha;
+    Scalar f;
+    XType g;
+    bool has_grad;
+    int ret;
+  };
+  std::vector<trial> _trials;
+  size_t _valueEvals, _gradEvals, _hits;
+
+ public:
+  LSEvaluationCache() : _valueEvals(0), _gradEvals(0), _hits(0) {}
+
+  /**
+   * Evaluate the function, and the gradient if requested, at the point
+   * x0 + alpha p.
+   *
+   * @param func Function which is being minimized.
+   * @param x0 Starting point of the line search.
+   * @param p Search direction.
+   * @param alpha Step size.
+   * @param x Trial point, set to x0 + alpha p.
+   * @param f Function value at the trial point.
+   * @param g Gradient at the trial point, only set if
+   * <code>need_grad</code> is true.
+   * @param need_grad Whether the gradient is needed.
+   * @return Zero if the evaluation succeeded, otherwise the functor's
+   * non-zero return code.
+   **/
+  template <typename FunctorType>
+  int evaluate(FunctorType &func, const XType &x0, const XType &p,
+               const Scalar &alpha, XType &x, Scalar &f, XType &g,
+               bool need_grad) {
+    x.noalias() = x0 + alpha * p;
+    trial *t = 0;
+    for (size_t i = 0; i < _trials.size(); ++i)
+      if (_trials[i].alpha == alpha)
+        t = &_trials[i];
+    if (t != 0 && (t->ret != 0 || t->has_grad || !need_grad)) {
+      ++_hits;
+      f = t->f;
+      if (t->has_grad)
+        g = t->g;
+      return t->ret;
+    }
+    if (t == 0) {
+      _trials.push_back(trial());
+      t = &_trials.back();
+      t->alpha = alpha;
+    }
+    if (need_grad || !internal::has_value_only<FunctorType, Scalar,
+                                               XType>::value) {
+      ++_gradEvals;
+      t->ret = func(x, t->f, t->g);
+      t->has_grad = true;
+      g = t->g;
+    } else {
+      ++_valueEvals;
+      t->ret = internal::evaluate_value(
+          func, x, t->f, g,
+          internal::has_value_only<FunctorType, Scalar, XType>());
+      t->has_grad = false;
+    }
+    f = t->f;
+    return t->ret;
+  }
+
+  size_t value_evals() const { return _valueEvals; }
+  size_t grad_evals() const { return _gradEvals; }
+  size_t hits() const { return _hits; }
+};
+
 /**
  * An internal utility function for implementing WolfeLineSearch()
+ *
+ * A bracket end with an unknown derivative, passed as NaN, is
+ * interpolated from the other end and the previous such end, if any.
+ * Trials are evaluated through the cache; a trial following two which
+ * failed the sufficient decrease test is evaluated without the gradient
+ * until it passes the test.
  **/
 template <typename FunctorType, typename Scalar, typename XType>
 int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
@@ -113,9 +283,13 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
                const Scalar &dfp, const Scalar &c1dfp, const Scalar &c2dfp,
                const XType &p, Scalar alo, Scalar aloF, Scalar aloDFp,
                Scalar ahi, Scalar ahiF, Scalar ahiDFp,
-               const Scalar &min_range) {
+               const Scalar &min_range,
+               LSEvaluationCache<Scalar, XType> &cache) {
   Scalar d1, d2, newDFp;
   int itNum(0);
+  int failures = 0;
+  // The previous high end, when it is known by its value only
+  Scalar prev(0), prevF(std::numeric_limits<Scalar>::quiet_NaN());
 
   while (1) {
     itNum++;
@@ -125,6 +299,14 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
 
     if (itNum % 5 == 0) {
       alpha = 0.5 * (alo + ahi);
+    } else if (std::isnan(ahiDFp)) {
+      alpha = std::isnan(prevF)
+                  ? QuadraticInterp(alo, aloF, aloDFp, ahi, ahiF)
+                  : CubicInterp(alo, aloF, aloDFp, ahi, ahiF, prev, prevF);
+      if (!std::isfinite(alpha)
+          || alpha < std::min(alo, ahi) + 0.01 * std::fabs(alo - ahi)
+          || alpha > std::max(alo, ahi) - 0.01 * std::fabs(alo - ahi))
+        alpha = 0.5 * (alo + ahi);
     } else {
       // Perform cubic interpolation to determine next point to try
       d1 = aloDFp + ahiDFp - 3 * (aloF - ahiF) / (alo - ahi);
@@ -139,19 +321,37 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
         alpha = 0.5 * (alo + ahi);
     }
 
-    newX = x + alpha * p;
-    while (func(newX, newF, newDF)) {
+    // After two trials failing sufficient decrease in a row, the next
+    // is likely to fail too and is evaluated without the gradient
+    const bool with_grad
+        = failures < 2
+          || !internal::has_value_only<FunctorType, Scalar, XType>::value;
+    bool sufficient = false;
+    while (true) {
+      if (cache.evaluate(func, x, p, alpha, newX, newF, newDF, with_grad)
+          == 0) {
+        sufficient = !(newF > (f + alpha * c1dfp) || newF >= aloF);
+        if (!sufficient
+            || cache.evaluate(func, x, p, alpha, newX, newF, newDF, true)
+                   == 0)
+          break;
+      }
       alpha = 0.5 * (alpha + std::min(alo, ahi));
       if (std::fabs(std::min(alo, ahi) - alpha) < min_range)
         return 1;
-      newX = x + alpha * p;
     }
-    newDFp = newDF.dot(p);
-    if (newF > (f + alpha * c1dfp) || newF >= aloF) {
+    failures = sufficient ? 0 : failures + 1;
+    if (!sufficient) {
+      if (std::isnan(ahiDFp)) {
+        prev = ahi;
+        prevF = ahiF;
+      }
       ahi = alpha;
       ahiF = newF;
-      ahiDFp = newDFp;
+      ahiDFp = with_grad ? newDF.dot(p)
+                         : std::numeric_limits<Scalar>::quiet_NaN();
     } else {
+      newDFp = newDF.dot(p);
       if (std::fabs(newDFp) <= -c2dfp)
         break;
       if (newDFp * (ahi - alo) >= 0) {
@@ -159,6 +359,7 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
         ahiF = aloF;
         ahiDFp = aloDFp;
       }
+      prevF = std::numeric_limits<Scalar>::quiet_NaN();
       alo = alpha;
       aloF = newF;
       aloDFp = newDFp;
@@ -167,6 +368,21 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
   return 0;
 }
 
+/**
+ * An internal utility function for implementing WolfeLineSearch()
+ **/
+template <typename FunctorType, typename Scalar, typename XType>
+int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
+               FunctorType &func, const XType &x, const Scalar &f,
+               const Scalar &dfp, const Scalar &c1dfp, const Scalar &c2dfp,
+               const XType &p, Scalar alo, Scalar aloF, Scalar aloDFp,
+               Scalar ahi, Scalar ahiF, Scalar ahiDFp,
+               const Scalar &min_range) {
+  LSEvaluationCache<Scalar, XType> cache;
+  return WolfLSZoom(alpha, newX, newF, newDF, func, x, f, dfp, c1dfp, c2dfp,
+                    p, alo, aloF, aloDFp, ahi, ahiF, ahiDFp, min_range, cache);
+}
+
 /**
  * Perform a line search which finds an approximate solution to:
  * \f[
@@ -216,6 +432,13 @@ int WolfLSZoom(Scalar &alpha, XType &newX, Scalar &newF, XType &newDF,
  * @param maxLSRestarts Maximum number of times line search will
  * restart with \f$ f() \f$ failing.
  *
+ * Trials are recorded in an <code>LSEvaluationCache</code>, so that no
+ * step size is evaluated twice.  If the functor also supports
+ * <code>ret = func(x, f)</code>, trials made while zooming in on a
+ * bracket after two trials failing the sufficient decrease test are
+ * first evaluated without the gradient, which is only computed if they
+ * pass the test; the final point always comes with its gradient.
+ *
  * @return Returns zero on success, non-zero otherwise.
  **/
 template <typename FunctorType, typename Scalar, typename XType>
@@ -237,6 +460,7 @@ int WolfeLineSearch(FunctorType &func, Scalar &alpha, XType &x1, Scalar &f1,
   Scalar newDFp;
 
   int retCode = 0, nits = 0, lsRestarts = 0, ret;
+  LSEvaluationCache<Scalar, XType> cache;
 
   while (1) {
     if (nits >= maxLSIts) {
@@ -244,8 +468,7 @@ int WolfeLineSearch(FunctorType &func, Scalar &alpha, XType &x1, Scalar &f1,
       break;
     }
 
-    x1.noalias() = x0 + alpha1 * p;
-    ret = func(x1, f1, gradx1);
+    ret = cache.evaluate(func, x0, p, alpha1, x1, f1, gradx1, true);
     if (ret != 0) {
       if (lsRestarts >= maxLSRestarts) {
         retCode = 1;
@@ -262,7 +485,8 @@ int WolfeLineSearch(FunctorType &func, Scalar &alpha, XType &x1, Scalar &f1,
     if ((f1 > f0 + alpha * c1dfp) || (f1 >= prevF && nits > 0)) {
       retCode
           = WolfLSZoom(alpha, x1, f1, gradx1, func, x0, f0, dfp, c1dfp, c2dfp,
-                       p, alpha0, prevF, prevDFp, alpha1, f1, newDFp, 1e-16);
+                       p, alpha0, prevF, prevDFp, alpha1, f1, newDFp, 1e-16,
+                       cache);
       break;
     }
     if (std::fabs(newDFp) <= -c2dfp) {
@@ -272,7 +496,8 @@ int WolfeLineSearch(FunctorType &func, Scalar &alpha, XType &x1, Scalar &f1,
     if (newDFp >= 0) {
       retCode
           = WolfLSZoom(alpha, x1, f1, gradx1, func, x0, f0, dfp, c1dfp, c2dfp,
-                       p, alpha1, f1, newDFp, alpha0, prevF, prevDFp, 1e-16);
+                       p, alpha1, f1, newDFp, alpha0, prevF, prevDFp, 1e-16,
+                       cache);
       break;
     }
 
@@ -0,0 +1,191 @@
+#ifndef STAN_OPTIMIZATION_COMPACT_LBFGS_UPDATE_HPP
+#define STAN_OPTIMIZATION_COMPACT_LBFGS_UPDATE_HPP
+
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <algorithm>
+
+namespace stan {
+namespace optimization {
+/**
+ * Implement a limited memory version of the BFGS update with the
+ * compact representation of Byrd, Nocedal and Schnabel (1994).  This
+ * computes the same search directions as <code>LBFGSUpdate</code> and
+ * can be used in its place.
+ *
+ * The last m state and gradient differences are kept as the columns
+ * of two D x m column-major matrices S and Y, used as ring buffers,
+ * together with the m x m inner products S' Y and Y' Y, which are
+ * updated with each new pair.  The inverse Hessian approximation is
+ *
+ *   H = gamma I + [S, gamma Y] M [S, gamma Y]',
+ *
+ * with the 2m x 2m middle matrix M built from the triangular part of
+ * S' Y, so the search direction takes four matrix-vector products
+ * with S or Y (S' g, Y' g, S p and Y q) and O(m^2) work on small
+ * matrices, instead of the two-loop recursion's 4m separate dot
+ * products and vector updates.  For large D the products stream over
+ * contiguous memory and are bound by memory bandwidth.
+ **/
+template <typename Scalar = double, int DimAtCompile = Eigen::Dynamic>
+class CompactLBFGSUpdate {
+ public:
+  typedef Eigen::Matrix<Scalar, DimAtCompile, 1> VectorT;
+  typedef Eigen::Matrix<Scalar, DimAtCompile, DimAtCompile> HessianT;
+  typedef Eigen::Matrix<Scalar, DimAtCompile, Eigen::Dynamic> HistoryT;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> SmallMatrixT;
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> SmallVectorT;
+
+  explicit CompactLBFGSUpdate(size_t L = 5)
+      : _capacity(L), _start(0), _size(0) {}
+
+  /**
+   * Set the number of inverse Hessian updates to keep, keeping the
+   * most recent ones.
+   *
+   * @param L New size of buffer.
+   **/
+  void set_history_size(size_t L) {
+    size_t keep = std::min(L, _size);
+    HistoryT S(_S.rows(), L), Y(_Y.rows(), L);
+    SmallMatrixT SY(L, L), YY(L, L);
+    for (size_t i = 0; i < keep; ++i) {
+      size_t from = column(_size - keep + i);
+      S.col(i) = _S.col(from);
+      Y.col(i) = _Y.col(from);
+      for (size_t j = 0; j < keep; ++j) {
+        size_t from_j = column(_size - keep + j);
+        SY(i, j) = _SY(from, from_j);
+        YY(i, j) = _YY(from, from_j);
+      }
+    }
+    _S.swap(S);
+    _Y.swap(Y);
+    _SY.swap(SY);
+    _YY.swap(YY);
+    _capacity = L;
+    _start = 0;
+    _size = keep;
+  }
+
+  /**
+   * Add a new set of update vectors to the history.
+   *
+   * @param yk Difference between the current and previous gradient vector.
+   * @param sk Difference between the current and previous state vector.
+   * @param reset Whether to reset the approximation, forgetting about
+   * previous values.
+   * @return In the case of a reset, returns the optimal scaling of the
+   * initial Hessian
+   * approximation which is useful for predicting step-sizes.
+   **/
+  inline Scalar update(const VectorT &yk, const VectorT &sk,
+                       bool reset = false) {
+    Scalar skyk = yk.dot(sk);
+
+    Scalar B0fact;
+    if (reset) {
+      B0fact = yk.squaredNorm() / skyk;
+      _start = 0;
+      _size = 0;
+    } else {
+      B0fact = 1.0;
+    }
+    if (_capacity == 0)
+      return B0fact;
+    if (_S.rows() != sk.size() || static_cast<size_t>(_S.cols()) != _capacity) {
+      _S.resize(sk.size(), _capacity);
+      _Y.resize(sk.size(), _capacity);
+      _SY.resize(_capacity, _capacity);
+      _YY.resize(_capacity, _capacity);
+      _start = 0;
+      _size = 0;
+    }
+
+    // New updates overwrite the oldest column once the buffer is full
+    size_t k;
+    if (_size < _capacity) {
+      k = column(_size);
+      ++_size;
+    } else {
+      k = _start;
+      _start = (_start + 1) % _capacity;
+    }
+    _S.col(k) = sk;
+    _Y.col(k) = yk;
+    _gammak = skyk / yk.squaredNorm();
+
+    // Columns in use are the leading ones until the buffer is full
+    const size_t n = _size;
+    _SY.col(k).head(n).noalias() = _S.leftCols(n).transpose() * yk;
+    _SY.row(k).head(n).noalias() = sk.transpose() * _Y.leftCols(n);
+    _YY.col(k).head(n).noalias() = _Y.leftCols(n).transpose() * yk;
+    _YY.row(k).head(n) = _YY.col(k).head(n).transpose();
+
+    return B0fact;
+  }
+
+  /**
+   * Compute the search direction based on the current (inverse) Hessian
+   * approximation and given gradient.
+   *
+   * @param[out] pk The negative product of the inverse Hessian and gradient
+   * direction gk.
+   * @param[in] gk Gradient direction.
+   **/
+  inline void search_direction(VectorT &pk, const VectorT &gk) const {
+    const size_t n = _size;
+    if (n == 0) {
+      pk.noalias() = -gk;
+      return;
+    }
+
+    // Products with the history, in storage order
+    SmallVectorT Sg = _S.leftCols(n).transpose() * gk;
+    SmallVectorT Yg = _Y.leftCols(n).transpose() * gk;
+
+    // Small matrices and vectors in chronological order
+    SmallMatrixT R(n, n), YY(n, n);
+    SmallVectorT a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+      size_t ci = column(i);
+      a(i) = Sg(ci);
+      b(i) = Yg(ci);
+      for (size_t j = 0; j < n; ++j) {
+        size_t cj = column(j);
+        R(i, j) = _SY(ci, cj);
+        YY(i, j) = _YY(ci, cj);
+      }
+    }
+    SmallVectorT d = R.diagonal();
+    auto Rt = R.template triangularView<Eigen::Upper>();
+
+    // q = -R^{-1} S' g,  p = R^{-T} ((D + gamma Y'Y) R^{-1} S' g - gamma Y' g)
+    SmallVectorT Ra = Rt.solve(a);
+    SmallVectorT p = d.cwiseProduct(Ra) + _gammak * (YY * Ra) - _gammak * b;
+    Rt.transpose().solveInPlace(p);
+    SmallVectorT q = -_gammak * Ra;
+
+    // Scatter back to storage order for the products with S and Y
+    SmallVectorT ps(_S.cols()), qs(_S.cols());
+    for (size_t i = 0; i < n; ++i) {
+      ps(column(i)) = p(i);
+      qs(column(i)) = q(i);
+    }
+    pk.noalias() = -_gammak * gk;
+    pk.noalias() -= _S.leftCols(n) * ps.head(n);
+    pk.noalias() -= _Y.leftCols(n) * qs.head(n);
+  }
+
+ protected:
+  // Storage column of the i-th oldest update
+  size_t column(size_t i) const { return (_start + i) % _capacity; }
+
+  HistoryT _S, _Y;
+  SmallMatrixT _SY, _YY;
+  size_t _capacity, _start, _size;
+  Scalar _gammak;
+};
+}  // namespace optimization
+}  // namespace stan
+
+#endif
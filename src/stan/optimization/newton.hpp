@@ -2,8 +2,13 @@
 #define STAN_OPTIMIZATION_NEWTON_HPP
 
 #include <stan/model/grad_hess_log_prob.hpp>
-#include <stan/model/log_prob_grad.hpp>
+#include <stan/model/gradient_workspace.hpp>
+#include <stan/model/hessian.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace stan {
@@ -12,6 +17,22 @@ namespace optimization {
 typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> matrix_d;
 typedef Eigen::Matrix<double, Eigen::Dynamic, 1> vector_d;
 
+/**
+ * How <code>newton_step</code> computes the Hessian.
+ */
+enum newton_hessian {
+  /**
+   * Finite differences of the gradient, with
+   * <code>stan::model::grad_hess_log_prob</code>.
+   */
+  finite_diff_hessian,
+  /**
+   * Exact, with forward-over-reverse autodiff, with
+   * <code>stan::model::hessian</code>.
+   */
+  autodiff_hessian
+};
+
 // Negates any positive eigenvalues in H so that H is negative
 // definite, and then solves Hu = g and stores the result into
 // g. Avoids problems due to non-log-concave distributions.
@@ -26,26 +47,153 @@ inline void make_negative_definite_and_solve(matrix_d& H, vector_d& g) {
   g = eigenvectors * eigenprojections;
 }
 
+/**
+ * Compute the Cholesky factorization of A + tau I for the smallest
+ * tau in the sequence 0 (or, if A has nonpositive diagonal elements,
+ * the shift making its smallest diagonal element beta), 2 tau, 4 tau,
+ * ... at least beta, for which it is positive definite, where beta is
+ * 1e-3 times the largest absolute diagonal element of A.
+ *
+ * This is the modified Cholesky factorization by adding a multiple of
+ * the identity (Nocedal and Wright, Algorithm 3.3).  Each attempt costs
+ * one Cholesky factorization, about a twenty-seventh of an eigen
+ * decomposition of the same matrix.
+ *
+ * @param[in] A symmetric matrix
+ * @param[out] llt Cholesky factorization of A + tau I
+ * @return shift tau
+ */
+inline double shifted_cholesky(const matrix_d& A, Eigen::LLT<matrix_d>& llt) {
+  double max_diagonal = A.diagonal().cwiseAbs().maxCoeff();
+  double beta = max_diagonal > 0 ? 1e-3 * max_diagonal : 1e-3;
+  double min_diagonal = A.diagonal().minCoeff();
+  double tau = min_diagonal > 0 ? 0 : beta - min_diagonal;
+  matrix_d shifted = A;
+  while (true) {
+    shifted.diagonal() = A.diagonal().array() + tau;
+    llt.compute(shifted);
+    if (llt.info() == Eigen::Success)
+      return tau;
+    tau = std::max(2 * tau, beta);
+  }
+}
+
+/**
+ * Approximately solve the trust region subproblem of maximizing
+ * g' p - p' A p / 2 subject to ||p|| <= radius, where A is the negative
+ * of the Hessian of the log density and g its gradient, by solving
+ * (A + lambda I) p = g.
+ *
+ * The smallest shift lambda is the one found by
+ * <code>shifted_cholesky</code>; if that step is longer than the
+ * radius, lambda is increased with the Newton iterations of Moré and
+ * Sorensen on the secular equation 1 / ||p(lambda)|| = 1 / radius, each
+ * costing a Cholesky factorization, until the step is within a tenth
+ * of the radius, and the step is then scaled back to the radius.
+ *
+ * @param[in] A negative Hessian of the log density
+ * @param[in] g gradient of the log density
+ * @param[in] radius trust region radius
+ * @param[out] p step
+ * @return shift lambda
+ */
+inline double trust_region_solve(const matrix_d& A, const vector_d& g,
+                                 double radius, vector_d& p) {
+  Eigen::LLT<matrix_d> llt;
+  double lambda = shifted_cholesky(A, llt);
+  p = llt.solve(g);
+  matrix_d shifted = A;
+  for (int i = 0; i < 10 && p.norm() > 1.1 * radius; ++i) {
+    double p_norm = p.norm();
+    double q_norm = llt.matrixL().solve(p).norm();
+    lambda += (p_norm / q_norm) * (p_norm / q_norm) * (p_norm - radius)
+              / radius;
+    shifted.diagonal() = A.diagonal().array() + lambda;
+    llt.compute(shifted);
+    p = llt.solve(g);
+  }
+  if (p.norm() > radius)
+    p *= radius / p.norm();
+  return lambda;
+}
+
+/**
+ * Compute the log density, its gradient and its Hessian at the
+ * specified parameters, for a Newton step.
+ *
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Unconstrained parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in] hessian_method how to compute the Hessian
+ * @param[out] g gradient of the log density
+ * @param[out] H Hessian of the log density
+ * @return log density
+ * @throw std::domain_error if the gradient or Hessian is not finite
+ */
+template <typename M>
+double newton_derivatives(M& model, std::vector<double>& params_r,
+                          std::vector<int>& params_i,
+                          newton_hessian hessian_method, vector_d& g,
+                          matrix_d& H) {
+  H.resize(params_r.size(), params_r.size());
+  g.resize(params_r.size());
+  double f0;
+  if (hessian_method == autodiff_hessian) {
+    Eigen::Map<const vector_d> x(params_r.data(), params_r.size());
+    stan::model::hessian<true, false>(model, x, f0, g, H);
+  } else {
+    std::vector<double> gradient;
+    std::vector<double> hessian;
+    f0 = stan::model::grad_hess_log_prob<true, false>(
+        model, params_r, params_i, gradient, hessian);
+    for (size_t i = 0; i < hessian.size(); i++) {
+      H(i) = hessian[i];
+    }
+    for (size_t i = 0; i < gradient.size(); i++)
+      g(i) = gradient[i];
+  }
+  if (!g.allFinite())
+    throw std::domain_error("The gradient of the log density is not finite");
+  if (!H.allFinite())
+    throw std::domain_error("The Hessian of the log density is not finite");
+  return f0;
+}
+
+/**
+ * Take a Newton step from the specified parameters, replacing them
+ * with the new parameters, and return the log density at the new
+ * parameters.  The step is found with a backtracking line search
+ * along the Newton direction, computed with the Hessian's positive
+ * eigenvalues negated.  Line search trials only evaluate the log
+ * density.
+ *
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in,out] params_r Unconstrained parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in] hessian_method how to compute the Hessian
+ * @param[in,out] output_stream
+ * @return log density at the new parameters
+ * @throw std::invalid_argument if an autodiff Hessian is requested for
+ * a model class that does not support it
+ * @throw std::domain_error if the gradient or Hessian is not finite
+ */
 template <typename M>
 double newton_step(M& model, std::vector<double>& params_r,
-                   std::vector<int>& params_i,
+                   std::vector<int>& params_i, newton_hessian hessian_method,
                    std::ostream* output_stream = 0) {
-  std::vector<double> gradient;
-  std::vector<double> hessian;
-
-  double f0 = stan::model::grad_hess_log_prob<true, false>(
-      model, params_r, params_i, gradient, hessian);
-  matrix_d H(params_r.size(), params_r.size());
-  for (size_t i = 0; i < hessian.size(); i++) {
-    H(i) = hessian[i];
-  }
-  vector_d g(params_r.size());
-  for (size_t i = 0; i < gradient.size(); i++)
-    g(i) = gradient[i];
+  matrix_d H;
+  vector_d g;
+  double f0
+      = newton_derivatives(model, params_r, params_i, hessian_method, g, H);
   make_negative_definite_and_solve(H, g);
   //         H.ldlt().solveInPlace(g);
 
   std::vector<double> new_params_r(params_r.size());
+  Eigen::Map<const vector_d> new_params(new_params_r.data(),
+                                        new_params_r.size());
+  stan::model::gradient_workspace workspace;
   double step_size = 2;
   double min_step_size = 1e-50;
   double f1 = -1e100;
@@ -58,8 +206,7 @@ double newton_step(M& model, std::vector<double>& params_r,
     for (size_t i = 0; i < params_r.size(); i++)
       new_params_r[i] = params_r[i] - step_size * g[i];
     try {
-      f1 = stan::model::log_prob_grad<true, false>(model, new_params_r,
-                                                   params_i, gradient);
+      f1 = workspace.log_prob_propto<false>(model, new_params);
     } catch (std::exception& e) {
       // FIXME:  this is not a good way to handle a general exception
       f1 = -1e100;
@@ -71,6 +218,104 @@ double newton_step(M& model, std::vector<double>& params_r,
   return f1;
 }
 
+/**
+ * Take a trust region Newton step from the specified parameters,
+ * replacing them with the new parameters, and return the log density
+ * at the new parameters.
+ *
+ * Instead of an eigen decomposition of the Hessian and a line search,
+ * the step maximizes the quadratic model of the log density within the
+ * trust region, with the Hessian made negative definite by the
+ * modified Cholesky factorization of <code>trust_region_solve</code>.
+ * Trial points only evaluate the log density.  A trial step is
+ * accepted if the log density increases by at least a ten-thousandth
+ * of the increase predicted by the model; the radius is shrunk to a
+ * quarter of the step if the prediction was poor (ratio below a
+ * quarter), and doubled if it was good (ratio above three quarters) and
+ * the step reached the boundary.  Rejected steps are retried with the
+ * shrunk radius, reusing the Hessian, until the radius falls below
+ * 1e-12, in which case the parameters are left unchanged.
+ *
+ * The radius is carried from step to step by the caller; an infinite
+ * radius lets the first step be a full Newton step.
+ *
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in,out] params_r Unconstrained parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in,out] radius trust region radius
+ * @param[in] hessian_method how to compute the Hessian
+ * @param[in,out] output_stream
+ * @return log density at the new parameters
+ * @throw std::invalid_argument if an autodiff Hessian is requested for
+ * a model class that does not support it
+ * @throw std::domain_error if the gradient or Hessian is not finite
+ */
+template <typename M>
+double newton_trust_region_step(M& model, std::vector<double>& params_r,
+                                std::vector<int>& params_i, double& radius,
+                                newton_hessian hessian_method
+                                = finite_diff_hessian,
+                                std::ostream* output_stream = 0) {
+  static const double min_radius = 1e-12;
+  static const double eta = 1e-4;
+  matrix_d H;
+  vector_d g;
+  double f0
+      = newton_derivatives(model, params_r, params_i, hessian_method, g, H);
+  matrix_d A = -H;
+
+  Eigen::Map<const vector_d> x(params_r.data(), params_r.size());
+  vector_d new_params(params_r.size());
+  vector_d p;
+  stan::model::gradient_workspace workspace;
+  while (radius >= min_radius) {
+    trust_region_solve(A, g, radius, p);
+    double p_norm = p.norm();
+    double predicted = g.dot(p) - 0.5 * p.dot(A * p);
+    if (!(predicted > 0))
+      return f0;
+    new_params = x + p;
+    double f1;
+    try {
+      f1 = workspace.log_prob_propto<false>(model, new_params);
+    } catch (std::exception& e) {
+      f1 = -std::numeric_limits<double>::infinity();
+    }
+    double rho = std::isnan(f1) ? -1 : (f1 - f0) / predicted;
+
+    if (rho < 0.25)
+      radius = 0.25 * p_norm;
+    else if (rho > 0.75 && p_norm >= 0.99 * radius)
+      radius *= 2;
+    if (rho > eta) {
+      for (size_t i = 0; i < params_r.size(); i++)
+        params_r[i] = new_params[i];
+      return f1;
+    }
+  }
+  return f0;
+}
+
+/**
+ * Take a Newton step from the specified parameters, with the Hessian
+ * computed by finite differences.
+ *
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in,out] params_r Unconstrained parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in,out] output_stream
+ * @return log density at the new parameters
+ */
+template <typename M>
+double newton_step(M& model, std::vector<double>& params_r,
+                   std::vector<int>& params_i,
+                   std::ostream* output_stream = 0) {
+  return newton_step(model, params_r, params_i, finite_diff_hessian,
+                     output_stream);
+}
+
 }  // namespace optimization
 }  // namespace stan
 #endif
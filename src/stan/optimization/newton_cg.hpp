@@ -0,0 +1,349 @@
+#ifndef STAN_OPTIMIZATION_NEWTON_CG_HPP
+#define STAN_OPTIMIZATION_NEWTON_CG_HPP
+
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/model/hessian_times_vector.hpp>
+#include <stan/optimization/bfgs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace optimization {
+
+template <typename Scalar = double>
+class TrustRegionOptions {
+ public:
+  TrustRegionOptions() {
+    radius0 = 1.0;
+    maxRadius = 1e+10;
+    minRadius = 1e-12;
+    eta = 1e-4;
+    maxForcing = 0.1;
+    maxCGIts = 0;
+  }
+  /**
+   * Initial trust region radius.
+   */
+  Scalar radius0;
+  /**
+   * Largest trust region radius.
+   */
+  Scalar maxRadius;
+  /**
+   * Smallest trust region radius before giving up.
+   */
+  Scalar minRadius;
+  /**
+   * Smallest ratio of actual to predicted decrease for a step to be
+   * accepted.
+   */
+  Scalar eta;
+  /**
+   * Largest conjugate gradient residual tolerance, relative to the
+   * gradient norm.
+   */
+  Scalar maxForcing;
+  /**
+   * Most conjugate gradient iterations per step, or 0 for the number
+   * of parameters.
+   */
+  size_t maxCGIts;
+};
+
+/**
+ * Truncated Newton (Newton-CG) trust region minimizer of the negative
+ * log density of a model, which never forms the Hessian.
+ *
+ * Each step approximately minimizes the quadratic model of the
+ * objective inside the trust region with Steihaug's conjugate gradient
+ * method, which only needs products of the Hessian with vectors; those
+ * are computed exactly with <code>stan::model::hessian_times_vector</code>
+ * at a few times the cost of a gradient.  Conjugate gradient stops once
+ * the residual falls below
+ * <code>min(maxForcing, sqrt(||g||)) ||g||</code>, giving superlinear
+ * convergence, or when it meets negative curvature or the trust region
+ * boundary, in which case the step is taken to the boundary.  The step
+ * is accepted if the actual decrease is at least <code>eta</code> times
+ * the decrease predicted by the quadratic model, and the radius is
+ * shrunk or grown by how well the model predicted it.  Memory is O(D)
+ * and each conjugate gradient iteration costs one Hessian-vector
+ * product.
+ *
+ * The log density is evaluated up to a constant and without the
+ * Jacobian adjustment, as for the other optimizers.  The termination
+ * codes and convergence options are those of the BFGS optimizers,
+ * except that there is no relative gradient test and
+ * <code>TERM_LSFAIL</code> means the trust region collapsed or a
+ * Hessian-vector product threw or was not finite, which is reported
+ * to the message stream.  Hessian-
+ * vector products need <code>fvar<var></code> log densities, so
+ * <code>model_base</code> is not supported (see
+ * <code>stan::model::has_autodiff_hessian</code>).
+ *
+ * @tparam M Class of model.
+ */
+template <typename M>
+class NewtonCG {
+ public:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1> VectorT;
+
+ private:
+  M &_model;
+  std::ostream *_msgs;
+  ModelAdaptor<M> _func;
+  VectorT _xk, _xk_1, _gk, _gk_1, _pk, _hv;
+  double _fk, _fk_1;
+  double _radius;
+  size_t _itNum, _cgIts, _hvEvals;
+  std::string _note;
+
+  // Objective Hessian (of the negative log density) times v, into _hv.
+  // Returns false if the product throws or is not finite.
+  bool hessian_times(const VectorT &x, const VectorT &v) {
+    ++_hvEvals;
+    double lp;
+    try {
+      stan::model::hessian_times_vector<true, false>(_model, x, v, lp, _hv,
+                                                     _msgs);
+    } catch (const std::exception &e) {
+      if (_msgs)
+        *_msgs << "Error evaluating Hessian-vector product: " << e.what()
+               << std::endl;
+      return false;
+    }
+    if (!_hv.allFinite()) {
+      if (_msgs)
+        *_msgs << "Error evaluating Hessian-vector product: "
+               << "the product is not finite" << std::endl;
+      return false;
+    }
+    _hv = -_hv;
+    return true;
+  }
+
+  // Positive tau with ||z + tau d|| = radius.
+  static double to_boundary(const VectorT &z, const VectorT &d,
+                            double radius) {
+    double dd = d.squaredNorm();
+    double zd = z.dot(d);
+    double zz = z.squaredNorm();
+    double disc
+        = std::sqrt(std::max(0.0, zd * zd + dd * (radius * radius - zz)));
+    return (disc - zd) / dd;
+  }
+
+  /**
+   * Steihaug conjugate gradient for the trust region subproblem at the
+   * current iterate, writing the step to <code>_pk</code>.
+   *
+   * @return decrease of the objective predicted by the quadratic
+   * model, or NaN if a Hessian-vector product failed
+   */
+  double solve_subproblem(bool &hit_boundary) {
+    const size_t num_params = _xk.size();
+    const size_t max_its = _tr_opts.maxCGIts > 0
+                               ? std::min(_tr_opts.maxCGIts, num_params)
+                               : num_params;
+    const double g_norm = _gk.norm();
+    const double tol
+        = std::min(_tr_opts.maxForcing, std::sqrt(g_norm)) * g_norm;
+
+    VectorT z = VectorT::Zero(num_params);
+    VectorT bz = VectorT::Zero(num_params);
+    VectorT r = _gk;
+    VectorT d = -r;
+    double rr = r.squaredNorm();
+    hit_boundary = false;
+    _cgIts = 0;
+    while (_cgIts < max_its && std::sqrt(rr) > tol) {
+      ++_cgIts;
+      if (!hessian_times(_xk, d)) {
+        _note = "Hessian-vector product failed";
+        return std::numeric_limits<double>::quiet_NaN();
+      }
+      double dbd = d.dot(_hv);
+      if (!(dbd > 0)) {
+        double tau = to_boundary(z, d, _radius);
+        z += tau * d;
+        bz += tau * _hv;
+        hit_boundary = true;
+        _note = "Negative curvature";
+        break;
+      }
+      double alpha = rr / dbd;
+      if ((z + alpha * d).norm() >= _radius) {
+        double tau = to_boundary(z, d, _radius);
+        z += tau * d;
+        bz += tau * _hv;
+        hit_boundary = true;
+        break;
+      }
+      z += alpha * d;
+      bz += alpha * _hv;
+      r += alpha * _hv;
+      double rr_next = r.squaredNorm();
+      d = -r + (rr_next / rr) * d;
+      rr = rr_next;
+    }
+    _pk = z;
+    return -(_gk.dot(z) + 0.5 * z.dot(bz));
+  }
+
+ public:
+  ConvergenceOptions<> _conv_opts;
+  TrustRegionOptions<> _tr_opts;
+
+  NewtonCG(M &model, const std::vector<double> &params_r,
+           const std::vector<int> &params_i, std::ostream *msgs = 0)
+      : _model(model), _msgs(msgs), _func(model, params_i, msgs) {
+    initialize(params_r);
+  }
+
+  void initialize(const std::vector<double> &params_r) {
+    _xk.resize(params_r.size());
+    for (size_t i = 0; i < params_r.size(); i++)
+      _xk[i] = params_r[i];
+    if (_func(_xk, _fk, _gk))
+      throw std::runtime_error("Error evaluating initial Newton-CG point.");
+    _xk_1 = _xk;
+    _gk_1 = _gk;
+    _fk_1 = _fk;
+    _pk = VectorT::Zero(_xk.size());
+    _radius = _tr_opts.radius0;
+    _itNum = 0;
+    _cgIts = 0;
+    _hvEvals = 0;
+    _note = "";
+  }
+
+  const double &curr_f() const { return _fk; }
+  const VectorT &curr_x() const { return _xk; }
+  const VectorT &curr_g() const { return _gk; }
+  const double &prev_f() const { return _fk_1; }
+  double prev_step_size() const { return (_xk - _xk_1).norm(); }
+  double radius() const { return _radius; }
+  size_t iter_num() const { return _itNum; }
+  size_t cg_iters() const { return _cgIts; }
+  size_t grad_evals() { return _func.fevals(); }
+  size_t hessian_vector_evals() const { return _hvEvals; }
+  const std::string &note() const { return _note; }
+
+  double logp() const { return -_fk; }
+  double grad_norm() const { return _gk.norm(); }
+  void params_r(std::vector<double> &x) const {
+    x.resize(_xk.size());
+    for (int i = 0; i < _xk.size(); i++)
+      x[i] = _xk[i];
+  }
+
+  std::string get_code_string(int retCode) {
+    switch (retCode) {
+      case TERM_SUCCESS:
+        return std::string("Successful step completed");
+      case TERM_ABSF:
+        return std::string(
+            "Convergence detected: absolute change "
+            "in objective function was below tolerance");
+      case TERM_RELF:
+        return std::string(
+            "Convergence detected: relative change "
+            "in objective function was below tolerance");
+      case TERM_ABSGRAD:
+        return std::string(
+            "Convergence detected: "
+            "gradient norm is below tolerance");
+      case TERM_ABSX:
+        return std::string(
+            "Convergence detected: "
+            "absolute parameter change was below tolerance");
+      case TERM_MAXIT:
+        return std::string(
+            "Maximum number of iterations hit, "
+            "may not be at an optima");
+      case TERM_LSFAIL:
+        return std::string(
+            "Trust region step failed to achieve a sufficient "
+            "decrease, no more progress can be made");
+      default:
+        return std::string("Unknown termination code");
+    }
+  }
+
+  /**
+   * Take one trust region step, shrinking the region until a step is
+   * accepted.
+   *
+   * @return <code>TERM_SUCCESS</code> if more progress can be made,
+   * otherwise a termination code
+   */
+  int step() {
+    _itNum++;
+    _note = "";
+    VectorT x_new, g_new;
+    double f_new;
+    while (true) {
+      bool hit_boundary;
+      double predicted = solve_subproblem(hit_boundary);
+      if (std::isnan(predicted))
+        return TERM_LSFAIL;
+      if (!(predicted > 0))
+        return TERM_ABSGRAD;
+      x_new = _xk + _pk;
+      double rho = -std::numeric_limits<double>::infinity();
+      if (_func(x_new, f_new, g_new) == 0)
+        rho = (_fk - f_new) / predicted;
+
+      double step_norm = _pk.norm();
+      if (rho < 0.25)
+        _radius = 0.25 * step_norm;
+      else if (rho > 0.75 && hit_boundary)
+        _radius = std::min(2 * _radius, _tr_opts.maxRadius);
+      if (rho > _tr_opts.eta)
+        break;
+      if (_radius < _tr_opts.minRadius)
+        return TERM_LSFAIL;
+      if (_note.empty())
+        _note = "Trust region shrunk";
+    }
+
+    _xk_1.swap(_xk);
+    _xk.swap(x_new);
+    _gk_1.swap(_gk);
+    _gk.swap(g_new);
+    _fk_1 = _fk;
+    _fk = f_new;
+
+    if (std::fabs(_fk_1 - _fk) < _conv_opts.tolAbsF)
+      return TERM_ABSF;
+    if (_gk.norm() < _conv_opts.tolAbsGrad)
+      return TERM_ABSGRAD;
+    if (prev_step_size() < _conv_opts.tolAbsX)
+      return TERM_ABSX;
+    if (_itNum >= _conv_opts.maxIts)
+      return TERM_MAXIT;
+    if (std::fabs(_fk_1 - _fk)
+            / std::max(std::fabs(_fk_1),
+                       std::max(std::fabs(_fk), _conv_opts.fScale))
+        < _conv_opts.tolRelF * std::numeric_limits<double>::epsilon())
+      return TERM_RELF;
+    return TERM_SUCCESS;
+  }
+
+  int minimize(std::vector<double> &params_r) {
+    int retcode;
+    initialize(params_r);
+    while (!(retcode = step()))
+      continue;
+    this->params_r(params_r);
+    return retcode;
+  }
+};
+
+}  // namespace optimization
+}  // namespace stan
+#endif
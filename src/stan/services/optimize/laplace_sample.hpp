@@ -0,0 +1,246 @@
+#ifndef STAN_SERVICES_OPTIMIZE_LAPLACE_SAMPLE_HPP
+#define STAN_SERVICES_OPTIMIZE_LAPLACE_SAMPLE_HPP
+
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/model/hessian.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
+#include <stan/services/error_codes.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace optimize {
+
+/**
+ * Draws from the Laplace approximation to the posterior at a mode:
+ * the normal distribution on the unconstrained scale centered at the
+ * mode with covariance the inverse of the negative Hessian of the log
+ * density there.
+ *
+ * The Hessian is computed once, by finite differences of the gradient
+ * with <code>stan::model::grad_hess_log_prob</code> or exactly with
+ * <code>stan::model::hessian</code>, and its negative is Cholesky
+ * factorized as <code>L L'</code>.  Each draw is
+ * <code>mode + L'^{-1} z</code> with <code>z</code> standard normal,
+ * the triangular solves being done for a block of draws at a time.
+ * The log density is evaluated with the Jacobian adjustment if and
+ * only if <code>jacobian</code> is true, which should match how the
+ * mode was found (the optimizers leave it out).
+ *
+ * Draw <code>k</code> (counting from 0) uses its own copy of the
+ * random number generator for <code>chain</code>, advanced by
+ * <code>k * 2^30</code> draws, for both <code>z</code> and the
+ * generated quantities, so the output does not depend on the number
+ * of threads and all streams stay within the <code>2^50</code> draws
+ * that <code>create_rng</code> leaves between chains.  Within a block
+ * the normal draws, log densities and <code>write_array</code> calls
+ * are made with <code>stan::model::internal::parallel_for_each</code>,
+ * concurrently only when Stan is built with threads, as models with
+ * ODE or algebraic solvers use nested autodiff even for doubles.
+ * Messages and errors of each draw are passed to the logger in draw
+ * order, and, as for MCMC output, generated quantities that fail to
+ * evaluate are written as NaN.
+ *
+ * The output has the columns <code>log_p__</code>, the log density of
+ * the draw, <code>log_g__</code>, the log density of the normal
+ * approximation up to a constant, and the constrained parameters, so
+ * the draws can be importance weighted by the difference.
+ *
+ * @tparam jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model A model implementation
+ * @param[in] model Input model (with data already instantiated)
+ * @param[in] mode var context with the mode on the constrained scale
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] num_draws number of draws, at most 2^20
+ * @param[in] autodiff_hessian indicates whether the Hessian is computed
+ *   exactly with autodiff rather than by finite differences; requires a
+ *   model class generated by stanc rather than model_base
+ * @param[in] refresh how often to write progress to the logger
+ * @param[in,out] interrupt callback to be called every block of draws
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] sample_writer output for the draws
+ * @return error_codes::OK if successful, error_codes::CONFIG for a bad
+ *   number of draws or an unsupported autodiff Hessian,
+ *   error_codes::DATAERR if the mode can not be transformed and
+ *   error_codes::SOFTWARE if the negative Hessian at the mode is not
+ *   positive definite
+ */
+template <bool jacobian = false, class Model>
+int laplace_sample(Model& model, const stan::io::var_context& mode,
+                   unsigned int random_seed, unsigned int chain,
+                   int num_draws, bool autodiff_hessian, int refresh,
+                   callbacks::interrupt& interrupt, callbacks::logger& logger,
+                   callbacks::writer& sample_writer) {
+  static const std::uintmax_t DISCARD_STRIDE = std::uintmax_t(1) << 30;
+  static const int MAX_DRAWS = 1 << 20;
+  static const int BLOCK_SIZE = 256;
+
+  if (num_draws < 1 || num_draws > MAX_DRAWS) {
+    logger.error("The number of draws must be between 1 and 1048576.");
+    return error_codes::CONFIG;
+  }
+  if (autodiff_hessian && !stan::model::has_autodiff_hessian<Model>::value) {
+    logger.error(
+        "Autodiff Hessians are not supported for this model class;"
+        " use finite differences.");
+    return error_codes::CONFIG;
+  }
+
+  std::vector<int> disc_vector;
+  std::vector<double> cont_vector;
+  try {
+    std::stringstream msg;
+    model.transform_inits(mode, disc_vector, cont_vector, &msg);
+    if (msg.str().length() > 0)
+      logger.info(msg);
+  } catch (const std::exception& e) {
+    logger.error("Error transforming the mode to the unconstrained scale:");
+    logger.error(e.what());
+    return error_codes::DATAERR;
+  }
+  const int num_params = cont_vector.size();
+
+  double lp;
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd hessian;
+  try {
+    std::stringstream msg;
+    if (autodiff_hessian) {
+      Eigen::VectorXd x
+          = Eigen::Map<Eigen::VectorXd>(cont_vector.data(), num_params);
+      stan::model::hessian<true, jacobian>(model, x, lp, grad, hessian, &msg);
+    } else {
+      std::vector<double> g, h;
+      lp = stan::model::grad_hess_log_prob<true, jacobian>(
+          model, cont_vector, disc_vector, g, h, &msg);
+      grad = Eigen::Map<Eigen::VectorXd>(g.data(), num_params);
+      hessian = Eigen::Map<Eigen::MatrixXd>(h.data(), num_params, num_params);
+    }
+    if (msg.str().length() > 0)
+      logger.info(msg);
+  } catch (const std::exception& e) {
+    logger.error("Error evaluating the Hessian at the mode:");
+    logger.error(e.what());
+    return error_codes::SOFTWARE;
+  }
+  std::stringstream mode_msg;
+  mode_msg << "Log density at the mode = " << lp
+           << ", gradient norm = " << grad.norm();
+  logger.info(mode_msg);
+
+  Eigen::LLT<Eigen::MatrixXd> llt(-hessian);
+  if (!hessian.allFinite() || llt.info() != Eigen::Success) {
+    logger.error(
+        "The Hessian at the mode is not negative definite, so the"
+        " Laplace approximation is not defined there.");
+    return error_codes::SOFTWARE;
+  }
+
+  std::vector<std::string> names;
+  names.push_back("log_p__");
+  names.push_back("log_g__");
+  model.constrained_param_names(names, true, true);
+  sample_writer(names);
+  const size_t num_values = names.size() - 2;
+
+  struct draw {
+    boost::ecuyer1988 rng;
+    double log_p;
+    double log_g;
+    std::vector<double> values;
+    std::stringstream msg;
+    std::vector<std::string> errors;
+
+    explicit draw(const boost::ecuyer1988& rng) : rng(rng) {}
+  };
+
+  Eigen::Map<const Eigen::VectorXd> x_mode(cont_vector.data(), num_params);
+  const boost::ecuyer1988 base_rng = util::create_rng(random_seed, chain);
+  for (int first = 0; first < num_draws; first += BLOCK_SIZE) {
+    interrupt();
+    const int size = std::min(BLOCK_SIZE, num_draws - first);
+    std::vector<draw> block;
+    block.reserve(size);
+    for (int j = 0; j < size; ++j)
+      block.emplace_back(base_rng);
+    Eigen::MatrixXd x(num_params, size);
+
+    stan::model::internal::parallel_for_each(size, [&](size_t j) {
+      draw& d = block[j];
+      d.rng.discard(DISCARD_STRIDE * (first + j));
+      boost::variate_generator<boost::ecuyer1988&,
+                               boost::normal_distribution<> >
+          std_normal(d.rng, boost::normal_distribution<>());
+      for (int i = 0; i < num_params; ++i)
+        x(i, j) = std_normal();
+      d.log_g = -0.5 * x.col(j).squaredNorm();
+    });
+
+    llt.matrixU().solveInPlace(x);
+    x.colwise() += x_mode;
+
+    stan::model::internal::parallel_for_each(size, [&](size_t j) {
+      draw& d = block[j];
+      std::vector<double> params_r(x.col(j).data(),
+                                   x.col(j).data() + num_params);
+      std::vector<int> params_i;
+      try {
+        d.log_p = model.template log_prob<false, jacobian>(params_r,
+                                                           params_i, &d.msg);
+      } catch (const std::exception& e) {
+        d.log_p = -std::numeric_limits<double>::infinity();
+        d.errors.push_back(e.what());
+      }
+      try {
+        model.write_array(d.rng, params_r, params_i, d.values, true, true,
+                          &d.msg);
+      } catch (const std::exception& e) {
+        d.errors.push_back(e.what());
+      }
+    });
+
+    for (draw& d : block) {
+      if (d.msg.str().length() > 0)
+        logger.info(d.msg);
+      for (const std::string& error : d.errors)
+        logger.info(error);
+      std::vector<double> values;
+      values.reserve(num_values + 2);
+      values.push_back(d.log_p);
+      values.push_back(d.log_g);
+      values.insert(values.end(), d.values.begin(), d.values.end());
+      values.resize(num_values + 2, std::numeric_limits<double>::quiet_NaN());
+      sample_writer(values);
+    }
+
+    const int last = first + size;
+    if (refresh > 0
+        && (last == num_draws || last / refresh > first / refresh)) {
+      std::stringstream msg;
+      msg << "Draw: " << last << " / " << num_draws;
+      logger.info(msg);
+    }
+  }
+  return error_codes::OK;
+}
+
+}  // namespace optimize
+}  // namespace services
+}  // namespace stan
+#endif
@@ -6,6 +6,7 @@
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/optimization/bfgs.hpp>
+#include <stan/optimization/compact_lbfgs_update.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/create_rng.hpp>
@@ -22,6 +23,13 @@ namespace optimize {
 /**
  * Runs the L-BFGS algorithm for a model.
  *
+ * The limited memory update is the two-loop recursion of
+ * <code>stan::optimization::LBFGSUpdate</code> by default;
+ * <code>stan::optimization::CompactLBFGSUpdate<></code> computes the
+ * same search directions with matrix-vector products, which is faster
+ * for large numbers of parameters.
+ *
+ * @tparam QNUpdate limited memory quasi-Newton update
  * @tparam Model A model implementation
  * @param[in] model Input model to test (with data already instantiated)
  * @param[in] init var context for initialization
@@ -49,7 +57,7 @@ namespace optimize {
  * @param[in,out] parameter_writer output for parameter values
  * @return error_codes::OK if successful
  */
-template <class Model>
+template <class QNUpdate = stan::optimization::LBFGSUpdate<>, class Model>
 int lbfgs(Model& model, const stan::io::var_context& init,
           unsigned int random_seed, unsigned int chain, double init_radius,
           int history_size, double init_alpha, double tol_obj,
@@ -65,9 +73,7 @@ int lbfgs(Model& model, const stan::io::var_context& init,
       model, init, rng, init_radius, false, logger, init_writer);
 
   std::stringstream lbfgs_ss;
-  typedef stan::optimization::BFGSLineSearch<Model,
-                                             stan::optimization::LBFGSUpdate<> >
-      Optimizer;
+  typedef stan::optimization::BFGSLineSearch<Model, QNUpdate> Optimizer;
   Optimizer lbfgs(model, cont_vector, disc_vector, &lbfgs_ss);
   lbfgs.get_qnupdate().set_history_size(history_size);
   lbfgs._ls_opts.alpha0 = init_alpha;
@@ -0,0 +1,289 @@
+#ifndef STAN_SERVICES_OPTIMIZE_LBFGS_MULTISTART_HPP
+#define STAN_SERVICES_OPTIMIZE_LBFGS_MULTISTART_HPP
+
+#include <stan/callbacks/buffer_logger.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/math/rev.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
+#include <stan/optimization/bfgs.hpp>
+#include <stan/services/error_codes.hpp>
+#include <stan/services/util/initialize.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace optimize {
+
+namespace internal {
+
+/**
+ * Result of one start of <code>lbfgs_multistart</code>.
+ */
+struct lbfgs_start {
+  boost::ecuyer1988 rng;
+  stan::callbacks::buffer_logger logger;
+  std::vector<double> init;
+  std::vector<double> cont_vector;
+  double lp = -std::numeric_limits<double>::infinity();
+  int ret = stan::optimization::TERM_LSFAIL;
+  size_t iterations = 0;
+  std::string code_string;
+  bool initialized = false;
+
+  explicit lbfgs_start(const boost::ecuyer1988& rng) : rng(rng) {}
+};
+
+/**
+ * Return true if the termination code is a convergence test, as
+ * opposed to a failed line search or the iteration limit.
+ */
+inline bool converged(int ret) {
+  return ret > 0 && ret != stan::optimization::TERM_MAXIT;
+}
+
+}  // namespace internal
+
+/**
+ * Runs the L-BFGS algorithm for a model from several random inits
+ * and reports the distinct optima found.
+ *
+ * Start <code>k</code> (counting from 0) initializes and draws from
+ * its own copy of the random number generator for
+ * <code>chain</code>, advanced by <code>k * 2^40</code> draws, so
+ * start 0 is the run of <code>lbfgs</code> with the same arguments,
+ * the starts do not depend on the number of threads, and all streams
+ * stay within the <code>2^50</code> draws that
+ * <code>create_rng</code> leaves between chains.  Parameters not
+ * given by <code>init</code> are drawn uniformly within
+ * <code>init_radius</code> as for a single run, which with a radius
+ * of 0 makes every start the same.
+ *
+ * The starts run against the shared model with
+ * <code>stan::model::internal::parallel_for_each</code>.  Each start
+ * logs into its own buffer and the buffers are passed to the logger
+ * in start order, so the output does not depend on the number of
+ * threads.  The interrupt callback is called once per iteration of
+ * every start, one call at a time; if it throws the remaining starts
+ * stop and the exception is rethrown.
+ *
+ * Starts that stop on a convergence test are grouped into modes: a
+ * start belongs to the mode of the best start before it, in order of
+ * decreasing log density, whose unconstrained parameters are within
+ * <code>mode_tol</code> of its own in every coordinate.  One draw per
+ * mode, that of its best start, is written to
+ * <code>parameter_writer</code> in order of decreasing log density,
+ * and the number of starts in each mode is logged.  Starts that fail
+ * to initialize, hit the iteration limit or fail the line search are
+ * logged and not written.
+ *
+ * @tparam Model A model implementation
+ * @param[in] model Input model to test (with data already instantiated)
+ * @param[in] init var context for initialization
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] init_radius radius to initialize
+ * @param[in] num_starts number of starts
+ * @param[in] mode_tol largest difference in any unconstrained
+ *   coordinate between optima of the same mode
+ * @param[in] history_size amount of history to keep for L-BFGS
+ * @param[in] init_alpha line search step size for first iteration
+ * @param[in] tol_obj convergence tolerance on absolute changes in
+ *   objective function value
+ * @param[in] tol_rel_obj convergence tolerance on relative changes
+ *   in objective function value
+ * @param[in] tol_grad convergence tolerance on the norm of the gradient
+ * @param[in] tol_rel_grad convergence tolerance on the relative norm of
+ *   the gradient
+ * @param[in] tol_param convergence tolerance on changes in parameter
+ *   value
+ * @param[in] num_iterations maximum number of iterations per start
+ * @param[in,out] interrupt callback to be called every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] init_writer Writer callback for unconstrained inits,
+ *   called with the init of each start in order
+ * @param[in,out] parameter_writer output for the optima
+ * @return error_codes::OK if at least one start converged,
+ *   error_codes::SOFTWARE if none did and error_codes::CONFIG if
+ *   <code>num_starts</code> is 0
+ */
+template <class Model>
+int lbfgs_multistart(Model& model, const stan::io::var_context& init,
+                     unsigned int random_seed, unsigned int chain,
+                     double init_radius, unsigned int num_starts,
+                     double mode_tol, int history_size, double init_alpha,
+                     double tol_obj, double tol_rel_obj, double tol_grad,
+                     double tol_rel_grad, double tol_param,
+                     int num_iterations, callbacks::interrupt& interrupt,
+                     callbacks::logger& logger,
+                     callbacks::writer& init_writer,
+                     callbacks::writer& parameter_writer) {
+  if (num_starts == 0) {
+    logger.error("Multi-start optimization needs at least one start.");
+    return error_codes::CONFIG;
+  }
+
+  typedef stan::optimization::BFGSLineSearch<Model,
+                                             stan::optimization::LBFGSUpdate<> >
+      Optimizer;
+  static const std::uintmax_t DISCARD_STRIDE = std::uintmax_t(1) << 40;
+
+  std::vector<internal::lbfgs_start> starts;
+  starts.reserve(num_starts);
+  boost::ecuyer1988 base_rng = util::create_rng(random_seed, chain);
+  for (unsigned int k = 0; k < num_starts; ++k) {
+    starts.emplace_back(base_rng);
+    starts.back().rng.discard(DISCARD_STRIDE * k);
+  }
+
+  std::mutex interrupt_mutex;
+  std::atomic<bool> stop(false);
+  stan::model::internal::parallel_for_each(num_starts, [&](size_t k) {
+    internal::lbfgs_start& s = starts[k];
+    if (stop)
+      return;
+    try {
+      stan::callbacks::writer no_init_writer;
+      try {
+        s.init = util::initialize<false>(model, init, s.rng, init_radius,
+                                         false, s.logger, no_init_writer);
+      } catch (const std::domain_error& e) {
+        return;
+      }
+      s.initialized = true;
+
+      std::vector<int> disc_vector;
+      std::stringstream lbfgs_ss;
+      Optimizer lbfgs(model, s.init, disc_vector, &lbfgs_ss);
+      lbfgs.get_qnupdate().set_history_size(history_size);
+      lbfgs._ls_opts.alpha0 = init_alpha;
+      lbfgs._conv_opts.tolAbsF = tol_obj;
+      lbfgs._conv_opts.tolRelF = tol_rel_obj;
+      lbfgs._conv_opts.tolAbsGrad = tol_grad;
+      lbfgs._conv_opts.tolRelGrad = tol_rel_grad;
+      lbfgs._conv_opts.tolAbsX = tol_param;
+      lbfgs._conv_opts.maxIts = num_iterations;
+
+      int ret = 0;
+      while (ret == 0) {
+        {
+          std::lock_guard<std::mutex> lock(interrupt_mutex);
+          interrupt();
+        }
+        if (stop)
+          break;
+        ret = lbfgs.step();
+        if (lbfgs_ss.str().length() > 0) {
+          s.logger.info(lbfgs_ss);
+          lbfgs_ss.str("");
+        }
+      }
+      s.ret = ret;
+      s.lp = lbfgs.logp();
+      s.iterations = lbfgs.iter_num();
+      s.code_string = lbfgs.get_code_string(ret);
+      lbfgs.params_r(s.cont_vector);
+    } catch (...) {
+      stop = true;
+      throw;
+    }
+  });
+
+  std::vector<size_t> converged;
+  for (size_t k = 0; k < starts.size(); ++k) {
+    internal::lbfgs_start& s = starts[k];
+    s.logger.replay(logger);
+    std::stringstream msg;
+    msg << "Start " << k + 1 << ": ";
+    if (!s.initialized) {
+      msg << "initialization failed";
+    } else {
+      init_writer(s.init);
+      msg << "log joint probability = " << std::setprecision(6) << s.lp
+          << " after " << s.iterations << " iterations; " << s.code_string;
+      if (internal::converged(s.ret))
+        converged.push_back(k);
+    }
+    logger.info(msg);
+  }
+
+  std::stable_sort(converged.begin(), converged.end(),
+                   [&](size_t a, size_t b) {
+                     return starts[a].lp > starts[b].lp;
+                   });
+  std::vector<size_t> modes;
+  std::vector<size_t> mode_counts;
+  for (size_t k : converged) {
+    const std::vector<double>& x = starts[k].cont_vector;
+    size_t m = 0;
+    for (; m < modes.size(); ++m) {
+      const std::vector<double>& y = starts[modes[m]].cont_vector;
+      double dist = 0;
+      for (size_t i = 0; i < x.size(); ++i)
+        dist = std::max(dist, std::fabs(x[i] - y[i]));
+      if (dist <= mode_tol)
+        break;
+    }
+    if (m == modes.size()) {
+      modes.push_back(k);
+      mode_counts.push_back(0);
+    }
+    ++mode_counts[m];
+  }
+
+  std::vector<std::string> names;
+  names.push_back("lp__");
+  model.constrained_param_names(names, true, true);
+  parameter_writer(names);
+
+  std::vector<int> disc_vector;
+  for (size_t m = 0; m < modes.size(); ++m) {
+    internal::lbfgs_start& s = starts[modes[m]];
+    std::stringstream mode_msg;
+    mode_msg << "Mode " << m + 1 << ": log joint probability = "
+             << std::setprecision(6) << s.lp << ", found by "
+             << mode_counts[m] << " of " << num_starts << " starts";
+    logger.info(mode_msg);
+
+    std::vector<double> values;
+    std::stringstream msg;
+    model.write_array(s.rng, s.cont_vector, disc_vector, values, true, true,
+                      &msg);
+    if (msg.str().length() > 0)
+      logger.info(msg);
+
+    values.insert(values.begin(), s.lp);
+    parameter_writer(values);
+  }
+
+  if (modes.empty()) {
+    logger.info("Optimization terminated with error: ");
+    logger.info("  No start converged");
+    return error_codes::SOFTWARE;
+  }
+  logger.info("Optimization terminated normally: ");
+  std::stringstream summary;
+  summary << "  " << converged.size() << " of " << num_starts
+          << " starts converged to " << modes.size()
+          << (modes.size() == 1 ? " mode" : " modes");
+  logger.info(summary);
+  return error_codes::OK;
+}
+
+}  // namespace optimize
+}  // namespace services
+}  // namespace stan
+#endif
@@ -5,11 +5,13 @@
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
+#include <stan/model/hessian.hpp>
 #include <stan/optimization/newton.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <cmath>
+#include <exception>
 #include <limits>
 #include <string>
 #include <vector>
@@ -30,19 +32,38 @@ namespace optimize {
  * @param[in] num_iterations maximum number of iterations
  * @param[in] save_iterations indicates whether all the iterations should
  *   be saved
+ * @param[in] autodiff_hessian indicates whether the Hessian is computed
+ *   exactly with autodiff rather than by finite differences; requires a
+ *   model class generated by stanc rather than model_base
+ * @param[in] trust_region indicates whether to take trust region steps
+ *   with a modified Cholesky factorization of the Hessian rather than
+ *   line search steps with its eigen decomposition
  * @param[in,out] interrupt callback to be called every iteration
  * @param[in,out] logger Logger for messages
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] parameter_writer output for parameter values
- * @return error_codes::OK if successful
+ * @return error_codes::OK if successful, error_codes::CONFIG if an
+ *   autodiff Hessian is requested for a model that does not support it
+ *   and error_codes::SOFTWARE if the gradient or Hessian can not be
+ *   evaluated or is not finite
  */
 template <class Model>
 int newton(Model& model, const stan::io::var_context& init,
            unsigned int random_seed, unsigned int chain, double init_radius,
-           int num_iterations, bool save_iterations,
-           callbacks::interrupt& interrupt, callbacks::logger& logger,
-           callbacks::writer& init_writer,
+           int num_iterations, bool save_iterations, bool autodiff_hessian,
+           bool trust_region, callbacks::interrupt& interrupt,
+           callbacks::logger& logger, callbacks::writer& init_writer,
            callbacks::writer& parameter_writer) {
+  if (autodiff_hessian && !stan::model::has_autodiff_hessian<Model>::value) {
+    logger.error(
+        "Autodiff Hessians are not supported for this model class;"
+        " use finite differences.");
+    return error_codes::CONFIG;
+  }
+  stan::optimization::newton_hessian hessian_method
+      = autodiff_hessian ? stan::optimization::autodiff_hessian
+                         : stan::optimization::finite_diff_hessian;
+
   boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
   std::vector<int> disc_vector;
@@ -82,6 +103,7 @@ int newton(Model& model, const stan::io::var_context& init,
   model.constrained_param_names(names, true, true);
   parameter_writer(names);
 
+  double radius = std::numeric_limits<double>::infinity();
   double lastlp = lp;
   for (int m = 0; m < num_iterations; m++) {
     if (save_iterations) {
@@ -95,7 +117,18 @@ int newton(Model& model, const stan::io::var_context& init,
     }
     interrupt();
     lastlp = lp;
-    lp = stan::optimization::newton_step(model, cont_vector, disc_vector);
+    try {
+      if (trust_region)
+        lp = stan::optimization::newton_trust_region_step(
+            model, cont_vector, disc_vector, radius, hessian_method);
+      else
+        lp = stan::optimization::newton_step(model, cont_vector, disc_vector,
+                                             hessian_method);
+    } catch (const std::exception& e) {
+      logger.error("Error evaluating the derivatives for a Newton step:");
+      logger.error(e.what());
+      return error_codes::SOFTWARE;
+    }
 
     std::stringstream msg2;
     msg2 << "Iteration " << std::setw(2) << (m + 1) << "."
@@ -119,6 +152,74 @@ int newton(Model& model, const stan::io::var_context& init,
   return error_codes::OK;
 }
 
+/**
+ * Runs the Newton algorithm for a model, taking line search steps.
+ *
+ * @tparam Model A model implementation
+ * @param[in] model the Stan model instantiated with data
+ * @param[in] init var context for initialization
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] init_radius radius to initialize
+ * @param[in] num_iterations maximum number of iterations
+ * @param[in] save_iterations indicates whether all the iterations should
+ *   be saved
+ * @param[in] autodiff_hessian indicates whether the Hessian is computed
+ *   exactly with autodiff rather than by finite differences; requires a
+ *   model class generated by stanc rather than model_base
+ * @param[in,out] interrupt callback to be called every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] init_writer Writer callback for unconstrained inits
+ * @param[in,out] parameter_writer output for parameter values
+ * @return error_codes::OK if successful, error_codes::CONFIG if an
+ *   autodiff Hessian is requested for a model that does not support it
+ *   and error_codes::SOFTWARE if the gradient or Hessian can not be
+ *   evaluated or is not finite
+ */
+template <class Model>
+int newton(Model& model, const stan::io::var_context& init,
+           unsigned int random_seed, unsigned int chain, double init_radius,
+           int num_iterations, bool save_iterations, bool autodiff_hessian,
+           callbacks::interrupt& interrupt, callbacks::logger& logger,
+           callbacks::writer& init_writer,
+           callbacks::writer& parameter_writer) {
+  return newton(model, init, random_seed, chain, init_radius, num_iterations,
+                save_iterations, autodiff_hessian, false, interrupt, logger,
+                init_writer, parameter_writer);
+}
+
+/**
+ * Runs the Newton algorithm for a model, computing the Hessian by
+ * finite differences.
+ *
+ * @tparam Model A model implementation
+ * @param[in] model the Stan model instantiated with data
+ * @param[in] init var context for initialization
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] init_radius radius to initialize
+ * @param[in] num_iterations maximum number of iterations
+ * @param[in] save_iterations indicates whether all the iterations should
+ *   be saved
+ * @param[in,out] interrupt callback to be called every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] init_writer Writer callback for unconstrained inits
+ * @param[in,out] parameter_writer output for parameter values
+ * @return error_codes::OK if successful and error_codes::SOFTWARE if the
+ *   gradient or Hessian can not be evaluated or is not finite
+ */
+template <class Model>
+int newton(Model& model, const stan::io::var_context& init,
+           unsigned int random_seed, unsigned int chain, double init_radius,
+           int num_iterations, bool save_iterations,
+           callbacks::interrupt& interrupt, callbacks::logger& logger,
+           callbacks::writer& init_writer,
+           callbacks::writer& parameter_writer) {
+  return newton(model, init, random_seed, chain, init_radius, num_iterations,
+                save_iterations, false, false, interrupt, logger,
+                init_writer, parameter_writer);
+}
+
 }  // namespace optimize
 }  // namespace services
 }  // namespace stan
@@ -0,0 +1,149 @@
+#ifndef STAN_SERVICES_UTIL_GENERATE_BUDGETED_TRANSITIONS_HPP
+#define STAN_SERVICES_UTIL_GENERATE_BUDGETED_TRANSITIONS_HPP
+
+#include <stan/analyze/mcmc/compute_split_rank_normalized_ess.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/sampling_budget.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Returns the smallest bulk effective sample size over the monitored
+ * draws. Returns NaN if any monitored parameter's effective sample
+ * size can not be estimated yet. Parameters whose draws are all the
+ * same, such as constants, have no effective sample size and are
+ * skipped; infinity is returned if all the parameters are skipped.
+ *
+ * @param[in] draws saved draws, one vector per monitored parameter
+ * @return minimum bulk effective sample size
+ */
+inline double min_bulk_effective_sample_size(
+    const std::vector<std::vector<double>>& draws) {
+  double min_ess = std::numeric_limits<double>::infinity();
+  for (const auto& draw : draws) {
+    if (!draw.empty()
+        && std::all_of(draw.begin(), draw.end(),
+                       [&](double x) { return x == draw[0]; }))
+      continue;
+    std::vector<const double*> chain(1, draw.data());
+    double ess = stan::analyze::compute_split_rank_normalized_ess(
+                     chain, draw.size())
+                     .first;
+    if (std::isnan(ess))
+      return ess;
+    min_ess = std::min(min_ess, ess);
+  }
+  return min_ess;
+}
+
+/**
+ * Generates MCMC transitions until the sampling budget is exhausted.
+ *
+ * Every saved draw of the monitored parameters is kept in memory. Every
+ * <code>budget.check_every</code> iterations the bulk effective
+ * sample size of each monitored parameter is computed from the saved
+ * draws; once all of them reach <code>budget.target_ess</code>
+ * sampling stops. The wall-clock deadline is checked after every
+ * iteration.
+ *
+ * @tparam Model model class
+ * @tparam RNG random number generator class
+ * @param[in,out] sampler MCMC sampler used to generate transitions
+ * @param[in] budget stopping criteria
+ * @param[in] start starting iteration number used for printing messages
+ * @param[in] num_thin a draw will be written to the mcmc_writer every
+ *   num_thin iterations
+ * @param[in] refresh number of iterations to print a message. If
+ *   refresh is zero, iteration number messages will not be printed
+ * @param[in,out] mcmc_writer writer to handle mcmc output
+ * @param[in,out] init_s starts as the initial unconstrained parameter
+ *   values. When the function completes, this will have the final
+ *   iteration's unconstrained parameter values
+ * @param[in] model model
+ * @param[in,out] base_rng random number generator
+ * @param[in,out] callback interrupt callback called once an iteration
+ * @param[in,out] logger logger for messages
+ * @param[out] num_iterations number of transitions generated
+ * @return reason sampling stopped
+ */
+template <class Model, class RNG>
+sampling_stop_reason generate_budgeted_transitions(
+    stan::mcmc::base_mcmc& sampler, const sampling_budget& budget, int start,
+    int num_thin, int refresh, util::mcmc_writer& mcmc_writer,
+    stan::mcmc::sample& init_s, Model& model, RNG& base_rng,
+    callbacks::interrupt& callback, callbacks::logger& logger,
+    int& num_iterations) {
+  const bool monitor_all = budget.monitored.empty();
+  const size_t num_monitored = monitor_all ? init_s.cont_params().size() + 1
+                                           : budget.monitored.size();
+  std::vector<std::vector<double>> draws(num_monitored);
+  num_iterations = 0;
+
+  const int finish = start + budget.max_iterations;
+  auto start_time = std::chrono::steady_clock::now();
+  for (int m = 0; m < budget.max_iterations; ++m) {
+    callback();
+
+    if (refresh > 0
+        && (start + m + 1 == finish || m == 0 || (m + 1) % refresh == 0)) {
+      int it_print_width = std::ceil(std::log10(static_cast<double>(finish)));
+      std::stringstream message;
+      message << "Iteration: ";
+      message << std::setw(it_print_width) << m + 1 + start << " / " << finish;
+      message << " [" << std::setw(3)
+              << static_cast<int>((100.0 * (start + m + 1)) / finish) << "%] ";
+      message << " (Sampling)";
+
+      logger.info(message);
+    }
+
+    init_s = sampler.transition(init_s, logger);
+    num_iterations = m + 1;
+
+    if ((m % num_thin) == 0) {
+      mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
+      mcmc_writer.write_diagnostic_params(init_s, sampler);
+
+      const Eigen::VectorXd& q = init_s.cont_params();
+      if (monitor_all) {
+        draws[0].push_back(init_s.log_prob());
+        for (int n = 0; n < q.size(); ++n)
+          draws[n + 1].push_back(q(n));
+      } else {
+        for (size_t n = 0; n < num_monitored; ++n)
+          draws[n].push_back(q(budget.monitored[n]));
+      }
+    }
+
+    if (budget.max_seconds > 0) {
+      double elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start_time)
+                           .count();
+      if (elapsed >= budget.max_seconds)
+        return sampling_stop_reason::deadline;
+    }
+
+    if ((m + 1) % budget.check_every == 0
+        && min_bulk_effective_sample_size(draws) >= budget.target_ess)
+      return sampling_stop_reason::target_ess;
+  }
+  return sampling_stop_reason::max_iterations;
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+
+#endif
@@ -1,14 +1,19 @@
 #ifndef STAN_SERVICES_UTIL_INITIALIZE_HPP
 #define STAN_SERVICES_UTIL_INITIALIZE_HPP
 
+#include <stan/callbacks/buffer_logger.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/io/random_var_context.hpp>
 #include <stan/io/chained_var_context.hpp>
 #include <stan/model/log_prob_grad.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
 #include <stan/math/prim.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <exception>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -17,6 +22,238 @@ namespace stan {
 namespace services {
 namespace util {
 
+namespace internal {
+
+/**
+ * Return the number of initialization attempts to make: one if the
+ * initial values are fully specified or zero, otherwise 100.
+ *
+ * @tparam Model the type of the model class
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in] init_radius the radius for generating random values
+ * @param[out] any_initialized set to <code>true</code> if init
+ *   provides a value for any parameter
+ * @return maximum number of attempts
+ */
+template <class Model>
+int max_init_tries(const Model& model, const stan::io::var_context& init,
+                   double init_radius, bool& any_initialized) {
+  bool is_fully_initialized = true;
+  any_initialized = false;
+  std::vector<std::string> param_names;
+  model.get_param_names(param_names);
+  for (size_t n = 0; n < param_names.size(); n++) {
+    is_fully_initialized &= init.contains_r(param_names[n]);
+    any_initialized |= init.contains_r(param_names[n]);
+  }
+  return is_fully_initialized || init_radius == 0.0 ? 1 : 100;
+}
+
+/**
+ * Generate one candidate initial value and check that the log
+ * density is finite there, evaluated with <code>double</code> values.
+ * Candidates that pass still need their gradient checked with
+ * <code>check_initial_gradient</code>.
+ *
+ * Uses no autodiff, so candidates can be generated concurrently as
+ * long as each has its own RNG and logger.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in] any_initialized whether init has values for any parameter
+ * @param[in,out] rng random number generator
+ * @param[in] init_radius the radius for generating random values
+ * @param[out] unconstrained candidate on the unconstrained scale
+ * @param[out] disc_vector integer parameters
+ * @param[in,out] logger logger for messages
+ * @throws exception passed through from the model if the model has a
+ *   fatal error (not a std::domain_error)
+ * @return <code>true</code> if the log density is finite at the
+ *   candidate, <code>false</code> if the candidate was rejected
+ */
+template <bool Jacobian, class Model, class RNG>
+bool generate_initial_candidate(Model& model,
+                                const stan::io::var_context& init,
+                                bool any_initialized, RNG& rng,
+                                double init_radius,
+                                std::vector<double>& unconstrained,
+                                std::vector<int>& disc_vector,
+                                stan::callbacks::logger& logger) {
+  std::stringstream msg;
+  try {
+    stan::io::random_var_context random_context(model, rng, init_radius,
+                                                init_radius == 0.0);
+
+    if (!any_initialized) {
+      unconstrained = random_context.get_unconstrained();
+    } else {
+      stan::io::chained_var_context context(init, random_context);
+
+      model.transform_inits(context, disc_vector, unconstrained, &msg);
+    }
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Rejecting initial value:");
+    logger.info(
+        "  Error evaluating the log probability"
+        " at the initial value.");
+    logger.info(e.what());
+    return false;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info(
+        "Unrecoverable error evaluating the log probability"
+        " at the initial value.");
+    logger.info(e.what());
+    throw;
+  }
+
+  msg.str("");
+  double log_prob(0);
+  try {
+    // we evaluate the log_prob function with propto=false
+    // because we're evaluating with `double` as the type of
+    // the parameters.
+    log_prob = model.template log_prob<false, Jacobian>(unconstrained,
+                                                        disc_vector, &msg);
+    if (msg.str().length() > 0)
+      logger.info(msg);
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Rejecting initial value:");
+    logger.info(
+        "  Error evaluating the log probability"
+        " at the initial value.");
+    logger.info(e.what());
+    return false;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info(
+        "Unrecoverable error evaluating the log probability"
+        " at the initial value.");
+    logger.info(e.what());
+    throw;
+  }
+  if (!std::isfinite(log_prob)) {
+    logger.info("Rejecting initial value:");
+    logger.info(
+        "  Log probability evaluates to log(0),"
+        " i.e. negative infinity.");
+    logger.info(
+        "  Stan can't start sampling from this"
+        " initial value.");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Check that the gradient of the log density is finite at a
+ * candidate initial value, optionally logging how long the gradient
+ * took to evaluate.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term
+ * @tparam Model the type of the model class
+ * @param[in] model the model
+ * @param[in] unconstrained candidate on the unconstrained scale
+ * @param[in] disc_vector integer parameters
+ * @param[in] print_timing indicates whether a timing message should
+ *   be printed to the logger
+ * @param[in,out] logger logger for messages
+ * @throws exception passed through from the gradient evaluation
+ * @return <code>true</code> if the gradient is finite
+ */
+template <bool Jacobian, class Model>
+bool check_initial_gradient(Model& model, std::vector<double>& unconstrained,
+                            std::vector<int>& disc_vector, bool print_timing,
+                            stan::callbacks::logger& logger) {
+  std::stringstream log_prob_msg;
+  std::vector<double> gradient;
+  auto start = std::chrono::steady_clock::now();
+  try {
+    // we evaluate this with propto=true since we're
+    // evaluating with autodiff variables
+    stan::model::log_prob_grad<true, Jacobian>(
+        model, unconstrained, disc_vector, gradient, &log_prob_msg);
+  } catch (const std::exception& e) {
+    if (log_prob_msg.str().length() > 0)
+      logger.info(log_prob_msg);
+    logger.info(e.what());
+    throw;
+  }
+  auto end = std::chrono::steady_clock::now();
+  double deltaT
+      = std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count()
+        / 1000000.0;
+  if (log_prob_msg.str().length() > 0)
+    logger.info(log_prob_msg);
+
+  bool gradient_ok = std::isfinite(stan::math::sum(gradient));
+
+  if (!gradient_ok) {
+    logger.info("Rejecting initial value:");
+    logger.info(
+        "  Gradient evaluated at the initial value"
+        " is not finite.");
+    logger.info(
+        "  Stan can't start sampling from this"
+        " initial value.");
+  }
+  if (gradient_ok && print_timing) {
+    logger.info("");
+    std::stringstream msg1;
+    msg1 << "Gradient evaluation took " << deltaT << " seconds";
+    logger.info(msg1);
+
+    std::stringstream msg2;
+    msg2 << "1000 transitions using 10 leapfrog steps"
+         << " per transition would take"
+         << " " << 1e4 * deltaT << " seconds.";
+    logger.info(msg2);
+
+    logger.info("Adjust your expectations accordingly!");
+    logger.info("");
+    logger.info("");
+  }
+  return gradient_ok;
+}
+
+/**
+ * Log that initialization failed and throw.
+ *
+ * @param[in] init_radius the radius for generating random values
+ * @param[in] max_init_tries number of attempts made
+ * @param[in,out] logger logger for messages
+ * @throws std::domain_error always
+ */
+inline void initialization_failed(double init_radius, int max_init_tries,
+                                  stan::callbacks::logger& logger) {
+  if (init_radius != 0.0) {
+    logger.info("");
+    std::stringstream msg;
+    msg << "Initialization between (-" << init_radius << ", " << init_radius
+        << ") failed after"
+        << " " << max_init_tries << " attempts. ";
+    logger.info(msg);
+    logger.info(
+        " Try specifying initial values,"
+        " reducing ranges of constrained values,"
+        " or reparameterizing the model.");
+  }
+  throw std::domain_error("Initialization failed.");
+}
+
+}  // namespace internal
+
 /**
  * Returns a valid initial value of the parameters of the model
  * on the unconstrained scale.
@@ -73,158 +310,130 @@ std::vector<double> initialize(Model& model, const stan::io::var_context& init,
   std::vector<double> unconstrained;
   std::vector<int> disc_vector;
 
-  bool is_fully_initialized = true;
-  bool any_initialized = false;
-  std::vector<std::string> param_names;
-  model.get_param_names(param_names);
-  for (size_t n = 0; n < param_names.size(); n++) {
-    is_fully_initialized &= init.contains_r(param_names[n]);
-    any_initialized |= init.contains_r(param_names[n]);
-  }
-
-  bool is_initialized_with_zero = init_radius == 0.0;
-
+  bool any_initialized;
   int MAX_INIT_TRIES
-      = is_fully_initialized || is_initialized_with_zero ? 1 : 100;
-  int num_init_tries = 0;
-  for (; num_init_tries < MAX_INIT_TRIES; num_init_tries++) {
-    std::stringstream msg;
-    try {
-      stan::io::random_var_context random_context(model, rng, init_radius,
-                                                  is_initialized_with_zero);
-
-      if (!any_initialized) {
-        unconstrained = random_context.get_unconstrained();
-      } else {
-        stan::io::chained_var_context context(init, random_context);
-
-        model.transform_inits(context, disc_vector, unconstrained, &msg);
-      }
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Rejecting initial value:");
-      logger.info(
-          "  Error evaluating the log probability"
-          " at the initial value.");
-      logger.info(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info(
-          "Unrecoverable error evaluating the log probability"
-          " at the initial value.");
-      logger.info(e.what());
-      throw;
-    }
-
-    msg.str("");
-    double log_prob(0);
-    try {
-      // we evaluate the log_prob function with propto=false
-      // because we're evaluating with `double` as the type of
-      // the parameters.
-      log_prob = model.template log_prob<false, Jacobian>(unconstrained,
-                                                          disc_vector, &msg);
-      if (msg.str().length() > 0)
-        logger.info(msg);
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Rejecting initial value:");
-      logger.info(
-          "  Error evaluating the log probability"
-          " at the initial value.");
-      logger.info(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info(
-          "Unrecoverable error evaluating the log probability"
-          " at the initial value.");
-      logger.info(e.what());
-      throw;
-    }
-    if (!std::isfinite(log_prob)) {
-      logger.info("Rejecting initial value:");
-      logger.info(
-          "  Log probability evaluates to log(0),"
-          " i.e. negative infinity.");
-      logger.info(
-          "  Stan can't start sampling from this"
-          " initial value.");
+      = internal::max_init_tries(model, init, init_radius, any_initialized);
+  for (int num_init_tries = 0; num_init_tries < MAX_INIT_TRIES;
+       num_init_tries++) {
+    if (!internal::generate_initial_candidate<Jacobian>(
+            model, init, any_initialized, rng, init_radius, unconstrained,
+            disc_vector, logger))
       continue;
-    }
-    std::stringstream log_prob_msg;
-    std::vector<double> gradient;
-    auto start = std::chrono::steady_clock::now();
-    try {
-      // we evaluate this with propto=true since we're
-      // evaluating with autodiff variables
-      log_prob = stan::model::log_prob_grad<true, Jacobian>(
-          model, unconstrained, disc_vector, gradient, &log_prob_msg);
-    } catch (const std::exception& e) {
-      if (log_prob_msg.str().length() > 0)
-        logger.info(log_prob_msg);
-      logger.info(e.what());
-      throw;
-    }
-    auto end = std::chrono::steady_clock::now();
-    double deltaT
-        = std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-              .count()
-          / 1000000.0;
-    if (log_prob_msg.str().length() > 0)
-      logger.info(log_prob_msg);
-
-    bool gradient_ok = std::isfinite(stan::math::sum(gradient));
-
-    if (!gradient_ok) {
-      logger.info("Rejecting initial value:");
-      logger.info(
-          "  Gradient evaluated at the initial value"
-          " is not finite.");
-      logger.info(
-          "  Stan can't start sampling from this"
-          " initial value.");
-    }
-    if (gradient_ok && print_timing) {
-      logger.info("");
-      std::stringstream msg1;
-      msg1 << "Gradient evaluation took " << deltaT << " seconds";
-      logger.info(msg1);
-
-      std::stringstream msg2;
-      msg2 << "1000 transitions using 10 leapfrog steps"
-           << " per transition would take"
-           << " " << 1e4 * deltaT << " seconds.";
-      logger.info(msg2);
-
-      logger.info("Adjust your expectations accordingly!");
-      logger.info("");
-      logger.info("");
-    }
-    if (gradient_ok) {
+    if (internal::check_initial_gradient<Jacobian>(
+            model, unconstrained, disc_vector, print_timing, logger)) {
       init_writer(unconstrained);
       return unconstrained;
     }
   }
+  internal::initialization_failed(init_radius, MAX_INIT_TRIES, logger);
+  return unconstrained;
+}
 
-  if (!is_initialized_with_zero) {
-    logger.info("");
-    std::stringstream msg;
-    msg << "Initialization between (-" << init_radius << ", " << init_radius
-        << ") failed after"
-        << " " << MAX_INIT_TRIES << " attempts. ";
-    logger.info(msg);
-    logger.info(
-        " Try specifying initial values,"
-        " reducing ranges of constrained values,"
-        " or reparameterizing the model.");
+/**
+ * Returns a valid initial value of the parameters of the model on
+ * the unconstrained scale, generating random candidates in batches
+ * that are evaluated concurrently when Stan is built with threads.
+ *
+ * This follows the serial <code>initialize</code>, except for how
+ * random values are drawn.  Candidate <code>k</code> (counting from
+ * 0) draws from its own copy of <code>rng</code> advanced by
+ * <code>(k + 1) * 2^40</code> draws, so each candidate is the same
+ * whatever the batch size or the number of threads, and
+ * <code>rng</code> itself is not advanced.  The streams stay within
+ * the <code>2^50</code> draws that <code>create_rng</code> leaves
+ * between chains.
+ *
+ * Each batch of up to <code>batch_size</code> candidates is generated
+ * and has its log density evaluated with
+ * <code>stan::model::internal::parallel_for_each</code>, concurrently
+ * only when Stan is built with threads, as models may use nested
+ * autodiff even for double evaluations.  Each candidate logs into its
+ * own buffer.  The candidates are then taken in order: the
+ * messages of each are passed to the logger and its gradient is
+ * checked, on the calling thread as the autodiff stack is only
+ * thread local when Stan is built with threads.  The first candidate
+ * that passes is returned, so the result and the log are the same as
+ * if the candidates had been tried one after another; messages of
+ * the candidates after it are discarded.
+ *
+ * When the initial values are fully specified or
+ * <code>init_radius</code> is 0, or <code>batch_size</code> is at
+ * most 1, this is the serial <code>initialize</code>.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator, which must be
+ *   copyable and provide <code>discard</code>
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in] rng random number generator the candidates are derived
+ *   from
+ * @param[in] init_radius the radius for generating random values.
+ * @param[in] print_timing indicates whether a timing message should
+ *   be printed to the logger
+ * @param[in,out] logger logger for messages
+ * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @param[in] batch_size number of candidates generated per batch
+ * @throws exception passed through from the model if the model has a
+ *   fatal error (not a std::domain_error)
+ * @throws std::domain_error if the model can not be initialized and
+ *   the model does not have a fatal error
+ * @return valid unconstrained parameters for the model
+ */
+template <bool Jacobian = true, class Model, class RNG>
+std::vector<double> initialize(Model& model, const stan::io::var_context& init,
+                               RNG& rng, double init_radius, bool print_timing,
+                               stan::callbacks::logger& logger,
+                               stan::callbacks::writer& init_writer,
+                               size_t batch_size) {
+  bool any_initialized;
+  int MAX_INIT_TRIES
+      = internal::max_init_tries(model, init, init_radius, any_initialized);
+  if (MAX_INIT_TRIES == 1 || batch_size <= 1)
+    return initialize<Jacobian>(model, init, rng, init_radius, print_timing,
+                                logger, init_writer);
+
+  static const std::uintmax_t DISCARD_STRIDE = std::uintmax_t(1) << 40;
+  struct candidate {
+    stan::callbacks::buffer_logger logger;
+    std::vector<double> unconstrained;
+    std::vector<int> disc_vector;
+    bool finite = false;
+    std::exception_ptr error;
+  };
+  const RNG& base_rng = rng;
+  for (size_t first = 0; first < static_cast<size_t>(MAX_INIT_TRIES);
+       first += batch_size) {
+    size_t size = std::min(batch_size, MAX_INIT_TRIES - first);
+    std::vector<candidate> batch(size);
+    stan::model::internal::parallel_for_each(size, [&](size_t k) {
+      candidate& c = batch[k];
+      RNG candidate_rng(base_rng);
+      candidate_rng.discard(DISCARD_STRIDE * (first + k + 1));
+      try {
+        c.finite = internal::generate_initial_candidate<Jacobian>(
+            model, init, any_initialized, candidate_rng, init_radius,
+            c.unconstrained, c.disc_vector, c.logger);
+      } catch (...) {
+        c.error = std::current_exception();
+      }
+    });
+    for (candidate& c : batch) {
+      c.logger.replay(logger);
+      if (c.error)
+        std::rethrow_exception(c.error);
+      if (c.finite
+          && internal::check_initial_gradient<Jacobian>(
+              model, c.unconstrained, c.disc_vector, print_timing, logger)) {
+        init_writer(c.unconstrained);
+        return c.unconstrained;
+      }
+    }
   }
-  throw std::domain_error("Initialization failed.");
+  internal::initialization_failed(init_radius, MAX_INIT_TRIES, logger);
+  return std::vector<double>();
 }
 
 }  // namespace util
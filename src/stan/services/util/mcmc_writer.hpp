@@ -6,6 +6,7 @@
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
+#include <stan/services/util/sampling_budget.hpp>
 #include <iomanip>
 #include <limits>
 #include <sstream>
@@ -139,6 +140,28 @@ class mcmc_writer {
     sample_writer_("Adaptation terminated");
   }
 
+  /**
+   * Prints the stopping criteria of a budgeted sampling run to the
+   * sample stream as comments.
+   *
+   * @param[in] budget sampling budget
+   */
+  void write_sampling_budget(const sampling_budget& budget) {
+    std::stringstream ss;
+    ss << "Sampling budget: target_ess = " << budget.target_ess
+       << ", check_every = " << budget.check_every
+       << ", max_seconds = " << budget.max_seconds
+       << ", max_iterations = " << budget.max_iterations;
+    sample_writer_(ss.str());
+    if (!budget.monitored.empty()) {
+      std::stringstream monitored;
+      monitored << "Monitored unconstrained parameters:";
+      for (size_t n : budget.monitored)
+        monitored << " " << n;
+      sample_writer_(monitored.str());
+    }
+  }
+
   /**
    * Print diagnostic names
    *
@@ -250,6 +273,26 @@ class mcmc_writer {
     write_timing(warmDeltaT, sampleDeltaT, diagnostic_writer_);
     log_timing(warmDeltaT, sampleDeltaT);
   }
+
+  /**
+   * Print timing information and the reason a budgeted sampling run
+   * stopped to all streams
+   *
+   * @param[in] warmDeltaT warmup time (sec)
+   * @param[in] sampleDeltaT sample time (sec)
+   * @param[in] reason reason sampling stopped
+   * @param[in] num_iterations number of sampling iterations generated
+   */
+  void write_timing(double warmDeltaT, double sampleDeltaT,
+                    sampling_stop_reason reason, int num_iterations) {
+    std::stringstream ss;
+    ss << "Sampling stopped: " << to_string(reason) << " after "
+       << num_iterations << " iterations";
+    sample_writer_(ss.str());
+    diagnostic_writer_(ss.str());
+    logger_.info(ss);
+    write_timing(warmDeltaT, sampleDeltaT);
+  }
 };
 
 }  // namespace util
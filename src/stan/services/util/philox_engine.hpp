@@ -0,0 +1,190 @@
+#ifndef STAN_SERVICES_UTIL_PHILOX_ENGINE_HPP
+#define STAN_SERVICES_UTIL_PHILOX_ENGINE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Counter-based pseudo random number generator implementing the
+ * Philox4x32-10 generator of Salmon et al. (2011), "Parallel random
+ * numbers: as easy as 1, 2, 3".
+ *
+ * The n-th number of a stream is a fixed function of the seed, the
+ * stream number and n, so any stream can be started at any position
+ * in constant time: constructing a generator for
+ * <code>(seed, stream, counter)</code> and <code>discard</code> cost
+ * the same whatever the stream or the number of draws skipped.  This
+ * gives every chain, generated quantities draw or parallel task its
+ * own reproducible stream, independent of how the work is scheduled
+ * over threads.
+ *
+ * The 64 bit seed is the Philox key.  The 128 bit Philox counter
+ * holds the stream in its high and the block number in its low 64
+ * bits; each block gives four 32 bit numbers.  A stream has
+ * <code>2^64</code> numbers.
+ *
+ * The class models a uniform random bit generator with
+ * <code>discard</code> and equality like the Boost engines, so it can
+ * be used for any <code>BaseRNG</code> template parameter and with the
+ * Boost distributions.
+ */
+class philox_engine {
+ public:
+  typedef std::uint32_t result_type;
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+ private:
+  std::uint64_t seed_;
+  std::uint64_t stream_;
+  std::uint64_t position_;  // index of the next number in the stream
+  std::uint64_t block_;     // block held in buffer_
+  result_type buffer_[4];
+
+  static void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t& hi,
+                      std::uint32_t& lo) {
+    std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    hi = static_cast<std::uint32_t>(product >> 32);
+    lo = static_cast<std::uint32_t>(product);
+  }
+
+  void generate(std::uint64_t block) {
+    std::uint32_t ctr[4] = {static_cast<std::uint32_t>(block),
+                            static_cast<std::uint32_t>(block >> 32),
+                            static_cast<std::uint32_t>(stream_),
+                            static_cast<std::uint32_t>(stream_ >> 32)};
+    std::uint32_t key[2] = {static_cast<std::uint32_t>(seed_),
+                            static_cast<std::uint32_t>(seed_ >> 32)};
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+      }
+      std::uint32_t hi0, lo0, hi1, lo1;
+      mulhilo(0xD2511F53, ctr[0], hi0, lo0);
+      mulhilo(0xCD9E8D57, ctr[2], hi1, lo1);
+      ctr[0] = hi1 ^ ctr[1] ^ key[0];
+      ctr[1] = lo1;
+      ctr[2] = hi0 ^ ctr[3] ^ key[1];
+      ctr[3] = lo0;
+    }
+    for (int i = 0; i < 4; ++i)
+      buffer_[i] = ctr[i];
+    block_ = block;
+  }
+
+ public:
+  /**
+   * Construct a generator positioned at the specified number of the
+   * specified stream.
+   *
+   * @param[in] seed seed
+   * @param[in] stream stream number
+   * @param[in] counter index of the first number to return
+   */
+  explicit philox_engine(std::uint64_t seed = 0, std::uint64_t stream = 0,
+                         std::uint64_t counter = 0) {
+    this->seed(seed, stream, counter);
+  }
+
+  /**
+   * Reposition the generator at the specified number of the specified
+   * stream.
+   *
+   * @param[in] seed seed
+   * @param[in] stream stream number
+   * @param[in] counter index of the first number to return
+   */
+  void seed(std::uint64_t seed, std::uint64_t stream = 0,
+            std::uint64_t counter = 0) {
+    seed_ = seed;
+    stream_ = stream;
+    position_ = counter;
+    generate(position_ >> 2);
+  }
+
+  /**
+   * Return the next number of the stream.
+   *
+   * @return uniform 32 bit number
+   */
+  result_type operator()() {
+    std::uint64_t block = position_ >> 2;
+    if (block != block_)
+      generate(block);
+    return buffer_[position_++ & 3];
+  }
+
+  /**
+   * Skip the specified number of draws, in constant time.
+   *
+   * @param[in] n number of draws to skip
+   */
+  void discard(std::uint64_t n) { position_ += n; }
+
+  /**
+   * Return the seed.
+   */
+  std::uint64_t seed_value() const { return seed_; }
+
+  /**
+   * Return the stream number.
+   */
+  std::uint64_t stream() const { return stream_; }
+
+  /**
+   * Return the index in the stream of the next number.
+   */
+  std::uint64_t counter() const { return position_; }
+
+  friend bool operator==(const philox_engine& x, const philox_engine& y) {
+    return x.seed_ == y.seed_ && x.stream_ == y.stream_
+           && x.position_ == y.position_;
+  }
+
+  friend bool operator!=(const philox_engine& x, const philox_engine& y) {
+    return !(x == y);
+  }
+
+  /**
+   * Write the state of the generator as seed, stream and counter.
+   */
+  friend std::ostream& operator<<(std::ostream& out, const philox_engine& x) {
+    return out << x.seed_ << ' ' << x.stream_ << ' ' << x.position_;
+  }
+
+  /**
+   * Read a state written by <code>operator<<</code>.
+   */
+  friend std::istream& operator>>(std::istream& in, philox_engine& x) {
+    std::uint64_t seed, stream, counter;
+    if (in >> seed >> stream >> counter)
+      x.seed(seed, stream, counter);
+    return in;
+  }
+};
+
+/**
+ * Create a counter-based generator for the specified chain, the
+ * counterpart of <code>create_rng</code>: each chain gets its own
+ * stream of the seed, in constant time.
+ *
+ * @param[in] seed the random seed
+ * @param[in] chain the chain id
+ * @return generator for the chain
+ */
+inline philox_engine create_philox_rng(unsigned int seed, unsigned int chain) {
+  return philox_engine(seed, chain);
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -3,8 +3,10 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
+#include <stan/services/util/generate_budgeted_transitions.hpp>
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/sampling_budget.hpp>
 #include <chrono>
 #include <vector>
 
@@ -87,6 +89,94 @@ void run_adaptive_sampler(Sampler& sampler, Model& model,
                           / 1000.0;
   writer.write_timing(warm_delta_t, sample_delta_t);
 }
+
+/**
+ * Runs the sampler with adaptation, then samples until the sampling
+ * budget is exhausted instead of for a fixed number of iterations.
+ *
+ * Sampling stops once the bulk effective sample size of every
+ * monitored parameter reaches the budget's target, the budget's
+ * wall-clock deadline passes, or the budget's iteration cap is hit.
+ * The budget is written to the sample writer with the headers and the
+ * reason sampling stopped is written with the timing information.
+ *
+ * @tparam Sampler Type of adaptive sampler.
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @param[in,out] sampler the mcmc sampler to use on the model
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vector initial parameter values
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] budget stopping criteria for the post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than
+ *   or equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rng random number generator
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws
+ * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @throw std::invalid_argument if the budget is invalid
+ */
+template <class Sampler, class Model, class RNG>
+void run_adaptive_sampler(Sampler& sampler, Model& model,
+                          std::vector<double>& cont_vector, int num_warmup,
+                          const sampling_budget& budget, int num_thin,
+                          int refresh, bool save_warmup, RNG& rng,
+                          callbacks::interrupt& interrupt,
+                          callbacks::logger& logger,
+                          callbacks::writer& sample_writer,
+                          callbacks::writer& diagnostic_writer) {
+  budget.validate(cont_vector.size());
+  Eigen::Map<Eigen::VectorXd> cont_params(cont_vector.data(),
+                                          cont_vector.size());
+
+  sampler.engage_adaptation();
+  try {
+    sampler.z().q = cont_params;
+    sampler.init_stepsize(logger);
+  } catch (const std::exception& e) {
+    logger.info("Exception initializing step size.");
+    logger.info(e.what());
+    return;
+  }
+
+  services::util::mcmc_writer writer(sample_writer, diagnostic_writer, logger);
+  stan::mcmc::sample s(cont_params, 0, 0);
+
+  // Headers
+  writer.write_sample_names(s, sampler, model);
+  writer.write_diagnostic_names(s, sampler, model);
+  writer.write_sampling_budget(budget);
+
+  auto start_warm = std::chrono::steady_clock::now();
+  util::generate_transitions(sampler, num_warmup, 0,
+                             num_warmup + budget.max_iterations, num_thin,
+                             refresh, save_warmup, true, writer, s, model, rng,
+                             interrupt, logger);
+  auto end_warm = std::chrono::steady_clock::now();
+  double warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            end_warm - start_warm)
+                            .count()
+                        / 1000.0;
+  sampler.disengage_adaptation();
+  writer.write_adapt_finish(sampler);
+  sampler.write_sampler_state(sample_writer);
+
+  int num_samples = 0;
+  auto start_sample = std::chrono::steady_clock::now();
+  sampling_stop_reason reason = util::generate_budgeted_transitions(
+      sampler, budget, num_warmup, num_thin, refresh, writer, s, model, rng,
+      interrupt, logger, num_samples);
+  auto end_sample = std::chrono::steady_clock::now();
+  double sample_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              end_sample - start_sample)
+                              .count()
+                          / 1000.0;
+  writer.write_timing(warm_delta_t, sample_delta_t, reason, num_samples);
+}
 }  // namespace util
 }  // namespace services
 }  // namespace stan
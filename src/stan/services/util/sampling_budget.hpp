@@ -0,0 +1,138 @@
+#ifndef STAN_SERVICES_UTIL_SAMPLING_BUDGET_HPP
+#define STAN_SERVICES_UTIL_SAMPLING_BUDGET_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Reasons a budgeted sampling run stops generating transitions.
+ */
+enum class sampling_stop_reason {
+  /**
+   * Every monitored parameter reached the target effective sample size.
+   */
+  target_ess,
+  /**
+   * The wall-clock deadline passed.
+   */
+  deadline,
+  /**
+   * The maximum number of sampling iterations was generated.
+   */
+  max_iterations
+};
+
+/**
+ * Returns a human readable description of the stop reason, suitable
+ * for writing to the output footer.
+ *
+ * @param[in] reason stop reason
+ * @return description of the stop reason
+ */
+inline std::string to_string(sampling_stop_reason reason) {
+  switch (reason) {
+    case sampling_stop_reason::target_ess:
+      return "target effective sample size reached";
+    case sampling_stop_reason::deadline:
+      return "wall-clock deadline reached";
+    default:
+      return "maximum number of iterations reached";
+  }
+}
+
+/**
+ * Stopping criteria for sampling until a target effective sample
+ * size is reached.
+ *
+ * Sampling continues until the bulk effective sample size of every
+ * monitored parameter is at least <code>target_ess</code>, the
+ * sampling phase has run for <code>max_seconds</code> of wall-clock
+ * time, or <code>max_iterations</code> sampling iterations have been
+ * generated, whichever comes first. The effective sample sizes are
+ * only computed every <code>check_every</code> iterations.
+ *
+ * Monitored parameters are indexes into the unconstrained parameter
+ * vector. When <code>monitored</code> is empty, every unconstrained
+ * parameter and <code>lp__</code> are monitored.
+ */
+struct sampling_budget {
+  /**
+   * Target effective sample size for every monitored parameter.
+   */
+  double target_ess;
+
+  /**
+   * Number of sampling iterations between effective sample size
+   * checks.
+   */
+  int check_every;
+
+  /**
+   * Wall-clock limit in seconds for the sampling phase. A
+   * non-positive value disables the deadline.
+   */
+  double max_seconds;
+
+  /**
+   * Maximum number of sampling iterations.
+   */
+  int max_iterations;
+
+  /**
+   * Indexes of the monitored unconstrained parameters.
+   */
+  std::vector<size_t> monitored;
+
+  /**
+   * Construct a sampling budget.
+   *
+   * @param[in] target_ess target effective sample size
+   * @param[in] check_every number of iterations between checks
+   * @param[in] max_seconds wall-clock limit in seconds; non-positive
+   *   values disable the deadline
+   * @param[in] max_iterations maximum number of sampling iterations
+   * @param[in] monitored indexes of monitored unconstrained
+   *   parameters; empty to monitor all parameters and lp__
+   */
+  sampling_budget(double target_ess, int check_every, double max_seconds,
+                  int max_iterations,
+                  const std::vector<size_t>& monitored = std::vector<size_t>())
+      : target_ess(target_ess),
+        check_every(check_every),
+        max_seconds(max_seconds),
+        max_iterations(max_iterations),
+        monitored(monitored) {}
+
+  /**
+   * Validates the budget.
+   *
+   * @param[in] num_params number of unconstrained parameters
+   * @throw std::invalid_argument if the target effective sample size
+   *   is not positive, the check interval or iteration cap is not
+   *   positive, or a monitored index is out of range
+   */
+  void validate(size_t num_params) const {
+    if (!(target_ess > 0))
+      throw std::invalid_argument("target_ess must be greater than 0.");
+    if (!(check_every > 0))
+      throw std::invalid_argument("check_every must be greater than 0.");
+    if (!(max_iterations > 0))
+      throw std::invalid_argument("max_iterations must be greater than 0.");
+    for (size_t n : monitored)
+      if (n >= num_params)
+        throw std::invalid_argument(
+            "monitored parameter index must be less than the number of"
+            " unconstrained parameters.");
+  }
+};
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
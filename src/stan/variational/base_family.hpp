@@ -3,8 +3,13 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim.hpp>
+#include <stan/model/gradient_workspace.hpp>
+#include <stan/model/log_prob_grad_batch.hpp>
 #include <algorithm>
 #include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace stan {
 namespace variational {
@@ -23,6 +28,21 @@ class base_family {
   virtual const Eigen::VectorXd& mean() const = 0;
   virtual double entropy() const = 0;
   virtual Eigen::VectorXd transform(const Eigen::VectorXd& eta) const = 0;
+  /**
+   * Return the transforms of the specified draws from the standard
+   * normal, one per column.  This transforms each column in turn;
+   * families override it to transform all the columns at once.
+   *
+   * @param[in] eta Draws, one per column; the number of rows has to be
+   * the same as the dimension of variational q.
+   * @return Transformed draws, one per column.
+   */
+  virtual Eigen::MatrixXd transform_draws(const Eigen::MatrixXd& eta) const {
+    Eigen::MatrixXd zeta(eta.rows(), eta.cols());
+    for (int j = 0; j < eta.cols(); ++j)
+      zeta.col(j) = transform(eta.col(j));
+    return zeta;
+  }
   /**
    * Assign a draw from this mean field approximation to the
    * specified vector using the specified random number generator.
@@ -85,6 +105,95 @@ class base_family {
                  callbacks::logger& logger) const;
 
  protected:
+  /**
+   * Draw from the standard normal and evaluate the gradient of the log
+   * density of the model at the transformed draws, with the Jacobian
+   * adjustment, until <code>n_monte_carlo_grad</code> gradients have
+   * been evaluated without error.  Draws where the evaluation throws
+   * or the gradient is not finite are dropped.
+   *
+   * The draws are made in batches of as many as are still needed, but
+   * no more than can still be dropped, and kept in the order they were
+   * drawn, so the draws kept, the messages logged, the number dropped
+   * and the state of the random number generator, even after too many
+   * draws were dropped, are those of drawing and evaluating one at a
+   * time.  The gradients of a batch are evaluated
+   * with <code>stan::model::internal::parallel_for_each</code>; the
+   * random number generator is only used on the calling thread, so
+   * the result does not depend on the number of threads.
+   *
+   * @tparam M Class of model.
+   * @tparam BaseRNG Class of random number generator.
+   * @param[in] m Model.
+   * @param[in] n_monte_carlo_grad Number of draws to keep.
+   * @param[in,out] rng Random number generator.
+   * @param[in,out] logger Logger for messages.
+   * @param[in] function Name of the calling function, for errors.
+   * @param[out] eta Standard normal draws kept, one per column.
+   * @param[out] grad Gradients at the transformed draws kept, one per
+   * column.
+   * @throw std::domain_error If the number of dropped draws reaches ten
+   * times <code>n_monte_carlo_grad</code>.
+   */
+  template <class M, class BaseRNG>
+  void calc_grad_draws(M& m, int n_monte_carlo_grad, BaseRNG& rng,
+                       callbacks::logger& logger, const char* function,
+                       Eigen::MatrixXd& eta, Eigen::MatrixXd& grad) const {
+    static const int n_retries = 10;
+    const int dim = dimension();
+    eta.resize(dim, n_monte_carlo_grad);
+    grad.resize(dim, n_monte_carlo_grad);
+
+    for (int n_kept = 0, n_monte_carlo_drop = 0;
+         n_kept < n_monte_carlo_grad;) {
+      const int size
+          = std::min(n_monte_carlo_grad - n_kept,
+                     n_retries * n_monte_carlo_grad - n_monte_carlo_drop);
+      Eigen::MatrixXd batch_eta(dim, size);
+      for (int j = 0; j < size; ++j)
+        for (int d = 0; d < dim; ++d)
+          batch_eta(d, j) = stan::math::normal_rng(0, 1, rng);
+      Eigen::MatrixXd batch_zeta = transform_draws(batch_eta);
+      Eigen::MatrixXd batch_grad(dim, size);
+
+      std::vector<std::string> msgs(size);
+      std::vector<int> evaluated(size, 0);
+      stan::model::internal::parallel_for_each(
+          size, [] { return stan::model::gradient_workspace(); },
+          [&](size_t j, stan::model::gradient_workspace& workspace) {
+            try {
+              std::stringstream ss;
+              workspace.log_prob_grad<true, true>(m, batch_zeta.col(j),
+                                                  batch_grad.col(j), &ss);
+              msgs[j] = ss.str();
+              evaluated[j] = 1;
+            } catch (const std::exception& e) {
+            }
+          });
+
+      for (int j = 0; j < size; ++j) {
+        if (msgs[j].length() > 0) {
+          std::stringstream ss;
+          ss << msgs[j];
+          logger.info(ss);
+        }
+        if (evaluated[j] && batch_grad.col(j).allFinite()) {
+          eta.col(n_kept) = batch_eta.col(j);
+          grad.col(n_kept) = batch_grad.col(j);
+          ++n_kept;
+        } else if (++n_monte_carlo_drop >= n_retries * n_monte_carlo_grad) {
+          const char* name = "The number of dropped evaluations";
+          const char* msg1 = "has reached its maximum amount (";
+          int y = n_retries * n_monte_carlo_grad;
+          const char* msg2
+              = "). Your model may be either severely "
+                "ill-conditioned or misspecified.";
+          stan::math::throw_domain_error(function, name, y, msg1, msg2);
+        }
+      }
+    }
+  }
+
   void write_error_msg_(std::ostream* error_msgs,
                         const std::exception& e) const {
     if (!error_msgs) {
@@ -3,10 +3,10 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim.hpp>
-#include <stan/model/gradient.hpp>
 #include <stan/variational/base_family.hpp>
 #include <algorithm>
 #include <ostream>
+#include <sstream>
 #include <vector>
 
 namespace stan {
@@ -351,6 +351,27 @@ class normal_fullrank : public base_family {
     return (L_chol_ * eta) + mu_;
   }
 
+  /**
+   * Return the transforms of the specified draws, one per column,
+   * computed with one triangular matrix product.
+   *
+   * @param[in] eta Draws to transform, one per column.
+   * @throws std::domain_error If the number of rows of the draws does
+   * not match the dimension of the approximation or any draw is NaN.
+   */
+  Eigen::MatrixXd transform_draws(const Eigen::MatrixXd& eta) const {
+    static const char* function
+        = "stan::variational::normal_fullrank::transform_draws";
+    stan::math::check_size_match(function, "Dimension of input vectors",
+                                 eta.rows(), "Dimension of mean vector",
+                                 dimension());
+    stan::math::check_not_nan(function, "Input vectors", eta);
+
+    Eigen::MatrixXd zeta = L_chol_.triangularView<Eigen::Lower>() * eta;
+    zeta.colwise() += mu_;
+    return zeta;
+  }
+
   template <class BaseRNG>
   void sample(BaseRNG& rng, Eigen::VectorXd& eta) const {
     // Draw from standard normal and transform to real-coordinate space
@@ -384,7 +405,9 @@ class normal_fullrank : public base_family {
    * Calculates the "blackbox" gradient with respect to BOTH the
    * location vector (mu) and the cholesky factor of the scale
    * matrix (L_chol) in parallel. It uses the same gradient
-   * computed from a set of Monte Carlo samples
+   * computed from a set of Monte Carlo samples, which are evaluated
+   * concurrently when Stan is built with threads (see
+   * <code>base_family::calc_grad_draws</code>).
    *
    * @tparam M Model class.
    * @tparam BaseRNG Class of base random number generator.
@@ -410,48 +433,16 @@ class normal_fullrank : public base_family {
                                  dimension(), "Dimension of variables in model",
                                  cont_params.size());
 
-    Eigen::VectorXd mu_grad = Eigen::VectorXd::Zero(dimension());
+    Eigen::MatrixXd eta;
+    Eigen::MatrixXd grad;
+    calc_grad_draws(m, n_monte_carlo_grad, rng, logger, function, eta, grad);
+
+    // Naive Monte Carlo integration; the sum over draws of the outer
+    // products of the gradients and draws is the lower triangle of one
+    // matrix product of the D x S matrices
+    Eigen::VectorXd mu_grad = grad.rowwise().sum();
     Eigen::MatrixXd L_grad = Eigen::MatrixXd::Zero(dimension(), dimension());
-    double tmp_lp = 0.0;
-    Eigen::VectorXd tmp_mu_grad = Eigen::VectorXd::Zero(dimension());
-    Eigen::VectorXd eta = Eigen::VectorXd::Zero(dimension());
-    Eigen::VectorXd zeta = Eigen::VectorXd::Zero(dimension());
-
-    // Naive Monte Carlo integration
-    static const int n_retries = 10;
-    for (int i = 0, n_monte_carlo_drop = 0; i < n_monte_carlo_grad;) {
-      // Draw from standard normal and transform to real-coordinate space
-      for (int d = 0; d < dimension(); ++d) {
-        eta(d) = stan::math::normal_rng(0, 1, rng);
-      }
-      zeta = transform(eta);
-      try {
-        std::stringstream ss;
-        stan::model::gradient(m, zeta, tmp_lp, tmp_mu_grad, &ss);
-        if (ss.str().length() > 0)
-          logger.info(ss);
-        stan::math::check_finite(function, "Gradient of mu", tmp_mu_grad);
-
-        mu_grad += tmp_mu_grad;
-        for (int ii = 0; ii < dimension(); ++ii) {
-          for (int jj = 0; jj <= ii; ++jj) {
-            L_grad(ii, jj) += tmp_mu_grad(ii) * eta(jj);
-          }
-        }
-        ++i;
-      } catch (const std::exception& e) {
-        ++n_monte_carlo_drop;
-        if (n_monte_carlo_drop >= n_retries * n_monte_carlo_grad) {
-          const char* name = "The number of dropped evaluations";
-          const char* msg1 = "has reached its maximum amount (";
-          int y = n_retries * n_monte_carlo_grad;
-          const char* msg2
-              = "). Your model may be either severely "
-                "ill-conditioned or misspecified.";
-          stan::math::throw_domain_error(function, name, y, msg1, msg2);
-        }
-      }
-    }
+    L_grad.triangularView<Eigen::Lower>() = grad * eta.transpose();
     mu_grad /= static_cast<double>(n_monte_carlo_grad);
     L_grad /= static_cast<double>(n_monte_carlo_grad);
 
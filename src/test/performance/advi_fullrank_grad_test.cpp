@@ -0,0 +1,69 @@
+/**
+ * Performance test: full-rank ADVI gradient accumulation.
+ *
+ * Times the two dense steps of normal_fullrank::calc_grad for S Monte
+ * Carlo draws in D dimensions: transforming the standard normal draws
+ * by the Cholesky factor, and summing the outer products of the
+ * gradients and draws into the lower triangle of the gradient with
+ * respect to the Cholesky factor.  Each is done one draw at a time, as
+ * calc_grad used to, and for all the draws at once with a triangular
+ * matrix product; the test only fails if the results disagree.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/variational/families/normal_fullrank.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace {
+template <typename F>
+double milliseconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return 1e3 * std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+TEST(performance, advi_fullrank_grad) {
+  const int num_draws = 100;
+  for (int dim : {100, 500, 2000}) {
+    Eigen::MatrixXd L = Eigen::MatrixXd::Random(dim, dim);
+    L.triangularView<Eigen::StrictlyUpper>().setZero();
+    L.diagonal().array() = L.diagonal().array().abs() + 1;
+    stan::variational::normal_fullrank q(Eigen::VectorXd::Random(dim), L);
+    Eigen::MatrixXd eta = Eigen::MatrixXd::Random(dim, num_draws);
+    Eigen::MatrixXd grad = Eigen::MatrixXd::Random(dim, num_draws);
+
+    Eigen::MatrixXd zeta_draws(dim, num_draws);
+    double transform_draw_time = milliseconds([&] {
+      for (int i = 0; i < num_draws; ++i)
+        zeta_draws.col(i) = q.transform(eta.col(i));
+    });
+    Eigen::MatrixXd zeta_batch;
+    double transform_batch_time
+        = milliseconds([&] { zeta_batch = q.transform_draws(eta); });
+
+    Eigen::MatrixXd L_grad_draws = Eigen::MatrixXd::Zero(dim, dim);
+    double outer_draw_time = milliseconds([&] {
+      for (int i = 0; i < num_draws; ++i)
+        for (int ii = 0; ii < dim; ++ii)
+          for (int jj = 0; jj <= ii; ++jj)
+            L_grad_draws(ii, jj) += grad(ii, i) * eta(jj, i);
+    });
+    Eigen::MatrixXd L_grad_batch = Eigen::MatrixXd::Zero(dim, dim);
+    double outer_batch_time = milliseconds([&] {
+      L_grad_batch.triangularView<Eigen::Lower>() = grad * eta.transpose();
+    });
+
+    std::cout << "D = " << dim << ", S = " << num_draws << ": transform "
+              << transform_draw_time << " ms per draw, "
+              << transform_batch_time << " ms batched; outer products "
+              << outer_draw_time << " ms per draw, " << outer_batch_time
+              << " ms batched" << std::endl;
+
+    EXPECT_LT((zeta_draws - zeta_batch).cwiseAbs().maxCoeff(), 1e-10 * dim);
+    EXPECT_LT((L_grad_draws - L_grad_batch).cwiseAbs().maxCoeff(),
+              1e-10 * num_draws);
+  }
+}
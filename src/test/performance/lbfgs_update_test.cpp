@@ -0,0 +1,65 @@
+/**
+ * Performance test: L-BFGS search directions.
+ *
+ * Times the search direction computation of LBFGSUpdate, which runs
+ * the two-loop recursion over a circular buffer of vectors, and of
+ * CompactLBFGSUpdate, which uses matrix-vector products with the
+ * history matrices, for a history of 20 updates and a few dimensions.
+ * The effective memory bandwidth of the compact version, counting one
+ * read of S and Y for each of its two passes, is printed alongside; the
+ * test only fails if the directions disagree.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/optimization/compact_lbfgs_update.hpp>
+#include <stan/optimization/lbfgs_update.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace {
+template <typename F>
+double milliseconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return 1e3 * std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+TEST(performance, lbfgs_update) {
+  typedef Eigen::VectorXd VectorT;
+  const int history_size = 20;
+  const int num_directions = 10;
+  for (int num_params : {10000, 100000, 1000000}) {
+    stan::optimization::LBFGSUpdate<> two_loop(history_size);
+    stan::optimization::CompactLBFGSUpdate<> compact(history_size);
+    VectorT sk(num_params), yk(num_params);
+    for (int k = 0; k < history_size; ++k) {
+      sk.setRandom();
+      yk = sk + 0.1 * VectorT::Random(num_params);
+      two_loop.update(yk, sk, k == 0);
+      compact.update(yk, sk, k == 0);
+    }
+
+    VectorT gk = VectorT::Random(num_params);
+    VectorT pk_two_loop(num_params), pk_compact(num_params);
+    double two_loop_time = milliseconds([&] {
+                             for (int n = 0; n < num_directions; ++n)
+                               two_loop.search_direction(pk_two_loop, gk);
+                           })
+                           / num_directions;
+    double compact_time = milliseconds([&] {
+                            for (int n = 0; n < num_directions; ++n)
+                              compact.search_direction(pk_compact, gk);
+                          })
+                          / num_directions;
+    double gigabytes = 4.0 * history_size * num_params * sizeof(double) / 1e9;
+
+    std::cout << "D = " << num_params << ", m = " << history_size
+              << ": two-loop " << two_loop_time << " ms, compact "
+              << compact_time << " ms (" << gigabytes / (compact_time / 1e3)
+              << " GB/s)" << std::endl;
+    EXPECT_NEAR(0, (pk_compact - pk_two_loop).norm(),
+                1e-8 * pk_two_loop.norm());
+  }
+}
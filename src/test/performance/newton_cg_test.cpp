@@ -0,0 +1,102 @@
+/**
+ * Performance test: Newton-CG against L-BFGS.
+ *
+ * Minimizes the negative of the chained Rosenbrock log density and of
+ * an ill-conditioned Gaussian log density with the Hessian-free
+ * Newton-CG trust region optimizer and with L-BFGS, for a few
+ * dimensions.  Iterations, gradient and Hessian-vector product
+ * evaluations and timings are printed; the test only fails if an
+ * optimizer does not find the mode.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/optimization/bfgs.hpp>
+#include <stan/optimization/newton_cg.hpp>
+#include <test/unit/model/rosenbrock_model.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+/**
+ * Independent normals centered at one with standard deviations from
+ * 1 to 1e-2, a condition number of 1e4.
+ */
+class ill_conditioned_normal {
+ public:
+  explicit ill_conditioned_normal(size_t num_params)
+      : num_params_(num_params) {}
+
+  size_t num_params_r() const { return num_params_; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& x,
+             std::ostream* msgs = 0) const {
+    using stan::math::square;
+    T lp = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+      double precision = std::pow(1e4, static_cast<double>(i) / x.size());
+      lp = lp - 0.5 * precision * square(1 - x(i));
+    }
+    return lp;
+  }
+
+ private:
+  size_t num_params_;
+};
+
+template <typename F>
+double milliseconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return 1e3 * std::chrono::duration<double>(end - start).count();
+}
+
+template <class M>
+void compare(const char* name, M& model, int num_params) {
+  std::vector<double> x0(num_params);
+  for (int i = 0; i < num_params; ++i)
+    x0[i] = 0.1 * (i % 7) - 0.2;
+  std::vector<int> params_i;
+
+  std::vector<double> newton_x = x0;
+  stan::optimization::NewtonCG<M> newton(model, newton_x, params_i);
+  int newton_ret;
+  double newton_time
+      = milliseconds([&] { newton_ret = newton.minimize(newton_x); });
+
+  std::vector<double> lbfgs_x = x0;
+  stan::optimization::BFGSLineSearch<M, stan::optimization::LBFGSUpdate<> >
+      lbfgs(model, lbfgs_x, params_i);
+  int lbfgs_ret;
+  double lbfgs_time = milliseconds([&] {
+    while ((lbfgs_ret = lbfgs.step()) == stan::optimization::TERM_SUCCESS)
+      continue;
+  });
+  lbfgs.params_r(lbfgs_x);
+
+  std::cout << name << " D = " << num_params << ": Newton-CG "
+            << newton.iter_num() << " iterations, " << newton.grad_evals()
+            << " gradients, " << newton.hessian_vector_evals()
+            << " Hessian-vector products, " << newton_time << " ms; L-BFGS "
+            << lbfgs.iter_num() << " iterations, " << lbfgs.grad_evals()
+            << " gradients, " << lbfgs_time << " ms" << std::endl;
+  EXPECT_GE(newton_ret, 0) << newton.get_code_string(newton_ret);
+  EXPECT_GE(lbfgs_ret, 0) << lbfgs.get_code_string(lbfgs_ret);
+  for (int i = 0; i < num_params; ++i) {
+    EXPECT_NEAR(1, newton_x[i], 1e-3);
+    EXPECT_NEAR(1, lbfgs_x[i], 1e-3);
+  }
+}
+}  // namespace
+
+TEST(performance, newton_cg) {
+  for (int num_params : {10, 100, 1000}) {
+    rosenbrock_model rosenbrock(num_params);
+    compare("chained Rosenbrock", rosenbrock, num_params);
+    ill_conditioned_normal normal(num_params);
+    compare("ill-conditioned normal", normal, num_params);
+  }
+}
@@ -0,0 +1,75 @@
+/**
+ * Performance test: Hessians for Newton's method.
+ *
+ * Compares the Hessian of the chained Rosenbrock function computed by
+ * finite differences of the gradient, with the four and two point
+ * stencils of grad_hess_log_prob, with the exact Hessian computed by
+ * forward-over-reverse autodiff with stan::model::hessian, for a few
+ * dimensions.  Timings and the largest difference from the exact
+ * Hessian are printed; the test only fails if the Hessians disagree.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/model/hessian.hpp>
+#include <test/unit/model/rosenbrock_model.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+template <typename F>
+double milliseconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return 1e3 * std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+TEST(performance, newton_hessian) {
+  for (int num_params : {10, 50, 200}) {
+    rosenbrock_model model(num_params);
+    std::vector<double> params_r(num_params);
+    for (int i = 0; i < num_params; ++i)
+      params_r[i] = 0.1 * (i % 7) - 0.2;
+    std::vector<int> params_i;
+    Eigen::Map<Eigen::VectorXd> x(params_r.data(), num_params);
+
+    double f;
+    Eigen::VectorXd grad_f;
+    Eigen::MatrixXd exact;
+    double ad_time = milliseconds([&] {
+      stan::model::hessian<true, false>(model, x, f, grad_f, exact);
+    });
+
+    std::vector<double> gradient;
+    std::vector<double> four, two;
+    double four_time = milliseconds([&] {
+      stan::model::grad_hess_log_prob<true, false>(model, params_r, params_i,
+                                                   gradient, four);
+    });
+    double two_time = milliseconds([&] {
+      stan::model::grad_hess_log_prob<true, false>(
+          model, params_r, params_i, gradient, two, stan::model::two_point);
+    });
+    double four_error
+        = (Eigen::Map<Eigen::MatrixXd>(four.data(), num_params, num_params)
+           - exact)
+              .cwiseAbs()
+              .maxCoeff();
+    double two_error
+        = (Eigen::Map<Eigen::MatrixXd>(two.data(), num_params, num_params)
+           - exact)
+              .cwiseAbs()
+              .maxCoeff();
+
+    std::cout << "D = " << num_params << ": autodiff " << ad_time
+              << " ms, finite differences four point " << four_time
+              << " ms (max error " << four_error << "), two point "
+              << two_time << " ms (max error " << two_error << ")"
+              << std::endl;
+    EXPECT_LT(four_error, 1e-4);
+    EXPECT_LT(two_error, 1e-2);
+  }
+}
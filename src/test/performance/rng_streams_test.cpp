@@ -0,0 +1,68 @@
+/**
+ * Performance test: cost of creating independent random number
+ * streams.
+ *
+ * Compares create_rng, which seeds boost::ecuyer1988 and discards
+ * 2^50 draws per chain, with the counter-based philox_engine, which
+ * starts any stream in constant time, and the cost of drawing from
+ * each.  Results are printed; the test only fails if the streams are
+ * not usable.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/philox_engine.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace {
+template <typename F>
+double seconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+TEST(performance, rng_stream_creation) {
+  const unsigned int num_streams = 10000;
+  unsigned int check_ecuyer = 0;
+  unsigned int check_philox = 0;
+  double ecuyer = seconds([&] {
+    for (unsigned int chain = 1; chain <= num_streams; ++chain)
+      check_ecuyer += stan::services::util::create_rng(1234, chain)();
+  });
+  double philox = seconds([&] {
+    for (unsigned int chain = 1; chain <= num_streams; ++chain)
+      check_philox += stan::services::util::create_philox_rng(1234, chain)();
+  });
+  std::cout << "creating " << num_streams << " streams: create_rng "
+            << 1e9 * ecuyer / num_streams << " ns/stream, philox_engine "
+            << 1e9 * philox / num_streams << " ns/stream" << std::endl;
+  EXPECT_NE(0u, check_ecuyer + check_philox);
+}
+
+TEST(performance, rng_draws) {
+  const int num_draws = 10000000;
+  boost::ecuyer1988 ecuyer_rng = stan::services::util::create_rng(1234, 1);
+  stan::services::util::philox_engine philox_rng
+      = stan::services::util::create_philox_rng(1234, 1);
+  boost::random::uniform_real_distribution<double> unif;
+  double sum_ecuyer = 0;
+  double sum_philox = 0;
+  double ecuyer = seconds([&] {
+    for (int n = 0; n < num_draws; ++n)
+      sum_ecuyer += unif(ecuyer_rng);
+  });
+  double philox = seconds([&] {
+    for (int n = 0; n < num_draws; ++n)
+      sum_philox += unif(philox_rng);
+  });
+  std::cout << "uniform draws: ecuyer1988 " << 1e9 * ecuyer / num_draws
+            << " ns/draw, philox_engine " << 1e9 * philox / num_draws
+            << " ns/draw" << std::endl;
+  EXPECT_NEAR(0.5, sum_ecuyer / num_draws, 0.01);
+  EXPECT_NEAR(0.5, sum_philox / num_draws, 0.01);
+}
@@ -0,0 +1,110 @@
+#include <stan/mcmc/chains.hpp>
+#include <stan/analyze/mcmc/compute_split_rank_normalized_ess.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+class ComputeRankNormalizedEss : public testing::Test {
+ public:
+  void SetUp() {
+    blocker1_stream.open("src/test/unit/mcmc/test_csv_files/blocker.1.csv");
+    blocker2_stream.open("src/test/unit/mcmc/test_csv_files/blocker.2.csv");
+  }
+
+  void TearDown() {
+    blocker1_stream.close();
+    blocker2_stream.close();
+  }
+  std::ifstream blocker1_stream, blocker2_stream;
+};
+
+TEST_F(ComputeRankNormalizedEss, invariant_to_monotone_transform) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1
+      = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  stan::io::stan_csv blocker2
+      = stan::io::stan_csv_reader::parse(blocker2_stream, &out);
+  EXPECT_EQ("", out.str());
+
+  stan::mcmc::chains<> chains(blocker1);
+  chains.add(blocker2);
+
+  Eigen::Matrix<Eigen::VectorXd, Eigen::Dynamic, 1> samples(
+      chains.num_chains());
+  Eigen::Matrix<Eigen::VectorXd, Eigen::Dynamic, 1> transformed(
+      chains.num_chains());
+  std::vector<const double*> draws(chains.num_chains());
+  std::vector<const double*> transformed_draws(chains.num_chains());
+  std::vector<size_t> sizes(chains.num_chains());
+  for (int index = 4; index < chains.num_params(); index++) {
+    for (int chain = 0; chain < chains.num_chains(); ++chain) {
+      samples(chain) = chains.samples(chain, index);
+      transformed(chain) = samples(chain).array().exp();
+      draws[chain] = &samples(chain)(0);
+      transformed_draws[chain] = &transformed(chain)(0);
+      sizes[chain] = samples(chain).size();
+    }
+    std::pair<double, double> ess
+        = stan::analyze::compute_split_rank_normalized_ess(draws, sizes);
+    std::pair<double, double> ess_transformed
+        = stan::analyze::compute_split_rank_normalized_ess(transformed_draws,
+                                                           sizes);
+    EXPECT_FLOAT_EQ(ess.first, ess_transformed.first)
+        << "bulk ess for parameter: " << chains.param_name(index);
+    EXPECT_FLOAT_EQ(ess.second, ess_transformed.second)
+        << "tail ess for parameter: " << chains.param_name(index);
+    EXPECT_GT(ess.first, 0);
+    EXPECT_GT(ess.second, 0);
+
+    std::pair<double, double> chains_ess
+        = chains.split_rank_normalized_ess(index);
+    EXPECT_FLOAT_EQ(ess.first, chains_ess.first);
+    EXPECT_FLOAT_EQ(ess.second, chains_ess.second);
+  }
+}
+
+TEST_F(ComputeRankNormalizedEss, independent_draws) {
+  std::vector<double> chain1(1000), chain2(1000);
+  for (size_t n = 0; n < chain1.size(); ++n) {
+    // low discrepancy sequence, close to independent uniform draws
+    chain1[n] = std::fmod(n * 0.6180339887498949, 1.0);
+    chain2[n] = std::fmod(n * 0.7548776662466927, 1.0);
+  }
+  std::vector<const double*> draws = {chain1.data(), chain2.data()};
+  std::pair<double, double> ess
+      = stan::analyze::compute_split_rank_normalized_ess(draws, 1000);
+  EXPECT_GT(ess.first, 1000);
+  EXPECT_GT(ess.second, 1000);
+}
+
+TEST_F(ComputeRankNormalizedEss, constant_and_non_finite) {
+  std::vector<double> constant(100, 1.0);
+  std::vector<const double*> draws = {constant.data(), constant.data()};
+  std::pair<double, double> ess
+      = stan::analyze::compute_split_rank_normalized_ess(draws, 100);
+  EXPECT_TRUE(std::isnan(ess.first));
+
+  std::vector<double> chain(100);
+  for (size_t n = 0; n < chain.size(); ++n)
+    chain[n] = std::sin(n);
+  chain[50] = std::numeric_limits<double>::infinity();
+  draws = {chain.data(), constant.data()};
+  ess = stan::analyze::compute_split_rank_normalized_ess(draws, 100);
+  EXPECT_TRUE(std::isnan(ess.first));
+  EXPECT_TRUE(std::isnan(ess.second));
+}
+
+TEST_F(ComputeRankNormalizedEss, too_few_draws) {
+  std::vector<double> chain = {1.0, 2.0, 3.0};
+  std::vector<const double*> draws = {chain.data(), chain.data()};
+  for (size_t size = 0; size < 4; ++size) {
+    std::pair<double, double> ess
+        = stan::analyze::compute_split_rank_normalized_ess(draws, size);
+    EXPECT_TRUE(std::isnan(ess.first));
+    EXPECT_TRUE(std::isnan(ess.second));
+  }
+}
@@ -0,0 +1,82 @@
+#include <stan/mcmc/chains.hpp>
+#include <stan/analyze/mcmc/compute_split_rank_normalized_rhat.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+class ComputeRankNormalizedRhat : public testing::Test {
+ public:
+  void SetUp() {
+    blocker1_stream.open("src/test/unit/mcmc/test_csv_files/blocker.1.csv");
+    blocker2_stream.open("src/test/unit/mcmc/test_csv_files/blocker.2.csv");
+  }
+
+  void TearDown() {
+    blocker1_stream.close();
+    blocker2_stream.close();
+  }
+  std::ifstream blocker1_stream, blocker2_stream;
+};
+
+TEST_F(ComputeRankNormalizedRhat, blocker) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1
+      = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  stan::io::stan_csv blocker2
+      = stan::io::stan_csv_reader::parse(blocker2_stream, &out);
+  EXPECT_EQ("", out.str());
+
+  stan::mcmc::chains<> chains(blocker1);
+  chains.add(blocker2);
+
+  for (int index = 4; index < chains.num_params(); index++) {
+    std::pair<double, double> rhat = chains.split_rank_normalized_rhat(index);
+    ASSERT_NEAR(1.0, rhat.first, 0.05)
+        << "bulk rhat for parameter: " << chains.param_name(index);
+    ASSERT_NEAR(1.0, rhat.second, 0.05)
+        << "tail rhat for parameter: " << chains.param_name(index);
+  }
+}
+
+TEST_F(ComputeRankNormalizedRhat, detects_shifted_chain) {
+  std::vector<double> chain1(500), chain2(500);
+  for (size_t n = 0; n < chain1.size(); ++n) {
+    chain1[n] = std::sin(n);
+    chain2[n] = std::sin(n) + 1;
+  }
+  std::vector<const double*> draws = {chain1.data(), chain2.data()};
+  std::pair<double, double> rhat
+      = stan::analyze::compute_split_rank_normalized_rhat(draws, 500);
+  EXPECT_GT(rhat.first, 1.1);
+}
+
+TEST_F(ComputeRankNormalizedRhat, non_finite) {
+  std::vector<double> chain(100);
+  for (size_t n = 0; n < chain.size(); ++n)
+    chain[n] = std::sin(n);
+  chain[10] = std::numeric_limits<double>::quiet_NaN();
+  std::vector<const double*> draws = {chain.data(), chain.data()};
+  std::pair<double, double> rhat
+      = stan::analyze::compute_split_rank_normalized_rhat(draws, 100);
+  EXPECT_TRUE(std::isnan(rhat.first));
+  EXPECT_TRUE(std::isnan(rhat.second));
+}
+
+TEST_F(ComputeRankNormalizedRhat, too_few_draws) {
+  std::vector<double> chain = {1.0, 2.0, 3.0};
+  std::vector<const double*> draws = {chain.data(), chain.data()};
+  for (size_t size = 0; size < 4; ++size) {
+    std::pair<double, double> rhat
+        = stan::analyze::compute_split_rank_normalized_rhat(draws, size);
+    EXPECT_TRUE(std::isnan(rhat.first));
+    EXPECT_TRUE(std::isnan(rhat.second));
+  }
+
+  Eigen::VectorXd empty;
+  EXPECT_THROW(stan::analyze::partial_sort_quantile(empty, 0.5),
+               std::invalid_argument);
+}
@@ -109,3 +109,25 @@ TEST_F(SplitChains, split_chains_convenience) {
     }
   }
 }
+
+TEST_F(SplitChains, split_chain_views) {
+  std::vector<double> chain1 = {1, 2, 3, 4, 5, 6, 7};
+  std::vector<double> chain2 = {8, 9, 10, 11, 12, 13, 14, 15};
+  std::vector<const double*> draws = {chain1.data(), chain2.data()};
+  std::vector<size_t> sizes = {chain1.size(), chain2.size()};
+
+  std::vector<Eigen::Map<const Eigen::VectorXd>> split_draws
+      = stan::analyze::split_chain_views(draws, sizes);
+  ASSERT_EQ(4, split_draws.size());
+  for (const auto& half : split_draws)
+    EXPECT_EQ(3, half.size());
+
+  EXPECT_EQ(chain1.data(), split_draws[0].data()) << "no copy";
+  EXPECT_EQ(chain1.data() + 4, split_draws[1].data())
+      << "middle draw of odd chain is ignored";
+  EXPECT_EQ(chain2.data(), split_draws[2].data());
+  EXPECT_EQ(chain2.data() + 4, split_draws[3].data())
+      << "chains are trimmed to the shortest chain";
+  EXPECT_FLOAT_EQ(7, split_draws[1](2));
+  EXPECT_FLOAT_EQ(14, split_draws[3](2));
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stan/callbacks/buffer_logger.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+
+class StanInterfaceCallbacksBufferLogger : public ::testing::Test {
+ public:
+  StanInterfaceCallbacksBufferLogger()
+      : out(debug, info, warn, error, fatal) {}
+
+  stan::callbacks::buffer_logger logger;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger out;
+};
+
+TEST_F(StanInterfaceCallbacksBufferLogger, records) {
+  std::stringstream msg;
+  msg << "message " << 2;
+  logger.info("message 1");
+  logger.warn(msg);
+  ASSERT_EQ(2, logger.messages().size());
+  EXPECT_EQ(stan::callbacks::buffer_logger::info_level,
+            logger.messages()[0].lvl);
+  EXPECT_EQ("message 1", logger.messages()[0].text);
+  EXPECT_FALSE(logger.messages()[0].from_stream);
+  EXPECT_EQ(stan::callbacks::buffer_logger::warn_level,
+            logger.messages()[1].lvl);
+  EXPECT_EQ("message 2", logger.messages()[1].text);
+  EXPECT_TRUE(logger.messages()[1].from_stream);
+
+  logger.clear();
+  EXPECT_EQ(0, logger.messages().size());
+}
+
+TEST_F(StanInterfaceCallbacksBufferLogger, replay) {
+  std::stringstream msg;
+  msg << "stream";
+  logger.debug("d");
+  logger.info("i1");
+  logger.info(msg);
+  logger.warn("w");
+  logger.error(msg);
+  logger.fatal("f");
+  EXPECT_EQ("", info.str());
+
+  logger.replay(out);
+  EXPECT_EQ("d\n", debug.str());
+  EXPECT_EQ("i1\nstream\n", info.str());
+  EXPECT_EQ("w\n", warn.str());
+  EXPECT_EQ("stream\n", error.str());
+  EXPECT_EQ("f\n", fatal.str());
+  EXPECT_EQ(6, logger.messages().size());
+}
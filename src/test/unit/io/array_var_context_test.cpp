@@ -241,3 +241,47 @@ TEST(array_var_context, invalid_context_validate) {
   EXPECT_NO_THROW(
       bernoulli_model_namespace::bernoulli_model(avc3, 0, &std::cout));
 }
+
+TEST(array_var_context, vals_views) {
+  stan::io::array_var_context avc(
+      std::vector<std::string>{"y"}, std::vector<double>{1.5, 2.5},
+      std::vector<std::vector<size_t>>{{2}}, std::vector<std::string>{"n"},
+      std::vector<int>{3}, std::vector<std::vector<size_t>>{{}});
+  stan::io::vals_view<double> y = avc.vals_r_view("y");
+  EXPECT_FALSE(y.owns());
+  EXPECT_EQ(avc.vals_r("y"), y.to_vector());
+  EXPECT_EQ(y.data(), avc.vals_r_view("y").data());
+
+  stan::io::vals_view<int> n = avc.vals_i_view("n");
+  EXPECT_FALSE(n.owns());
+  EXPECT_EQ(std::vector<int>{3}, n.to_vector());
+  stan::io::vals_view<double> n_r = avc.vals_r_view("n");
+  EXPECT_TRUE(n_r.owns());
+  EXPECT_EQ(std::vector<double>{3}, n_r.to_vector());
+
+  EXPECT_TRUE(avc.vals_r_view("z").empty());
+  EXPECT_TRUE(avc.vals_i_view("y").empty());
+}
+
+TEST(array_var_context, lookup_and_names) {
+  stan::io::array_var_context avc(
+      std::vector<std::string>{"y", "x"}, std::vector<double>{1.5, 2.5, 3},
+      std::vector<std::vector<size_t>>{{2}, {}}, std::vector<std::string>{"n"},
+      std::vector<int>{3}, std::vector<std::vector<size_t>>{{}});
+  stan::io::var_entry y = avc.lookup("y");
+  ASSERT_TRUE(y);
+  EXPECT_FALSE(y.is_int);
+  EXPECT_EQ((std::vector<double>{1.5, 2.5}), y.vals_r.to_vector());
+  EXPECT_EQ(std::vector<size_t>{2}, y.dims.to_vector());
+  stan::io::var_entry n = avc.lookup("n");
+  ASSERT_TRUE(n);
+  EXPECT_TRUE(n.is_int);
+  EXPECT_EQ(std::vector<int>{3}, n.vals_i.to_vector());
+  EXPECT_FALSE(avc.lookup("z"));
+
+  std::vector<std::string> names;
+  avc.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"x", "y"}), names);
+  avc.names_i(names);
+  EXPECT_EQ(std::vector<std::string>{"n"}, names);
+}
@@ -1,6 +1,53 @@
 #include <stan/io/chained_var_context.hpp>
 #include <stan/io/array_var_context.hpp>
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+// Forwards to an array_var_context, counting the values fetched, and
+// keeps the default lookup and views, as a context from outside Stan
+// would.
+class counting_var_context : public stan::io::var_context {
+ public:
+  explicit counting_var_context(const stan::io::array_var_context& vc)
+      : vc_(vc), vals_calls(0) {}
+
+  bool contains_r(const std::string& name) const {
+    return vc_.contains_r(name);
+  }
+  std::vector<double> vals_r(const std::string& name) const {
+    ++vals_calls;
+    return vc_.vals_r(name);
+  }
+  std::vector<size_t> dims_r(const std::string& name) const {
+    return vc_.dims_r(name);
+  }
+  bool contains_i(const std::string& name) const {
+    return vc_.contains_i(name);
+  }
+  std::vector<int> vals_i(const std::string& name) const {
+    ++vals_calls;
+    return vc_.vals_i(name);
+  }
+  std::vector<size_t> dims_i(const std::string& name) const {
+    return vc_.dims_i(name);
+  }
+  void names_r(std::vector<std::string>& names) const { vc_.names_r(names); }
+  void names_i(std::vector<std::string>& names) const { vc_.names_i(names); }
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+
+ private:
+  const stan::io::array_var_context& vc_;
+
+ public:
+  mutable int vals_calls;
+};
+}  // namespace
 
 TEST(chained_var_context, ctor) {
   std::vector<double> v;
@@ -53,3 +100,73 @@ TEST(chained_var_context, ctor) {
   std::vector<double> alpha(1, 0);
   EXPECT_EQ(alpha, vcc.vals_r("alpha"));
 }
+
+TEST(chained_var_context, vals_views) {
+  stan::io::array_var_context avc(std::vector<std::string>{"a", "b"},
+                                  std::vector<double>{1, 2, 3},
+                                  std::vector<std::vector<size_t>>{{}, {2}});
+  stan::io::array_var_context avc2(std::vector<std::string>{"a", "n"},
+                                   std::vector<int>{7, 8},
+                                   std::vector<std::vector<size_t>>{{}, {}});
+  stan::io::chained_var_context vcc(avc, avc2);
+
+  stan::io::vals_view<double> a = vcc.vals_r_view("a");
+  EXPECT_FALSE(a.owns());
+  EXPECT_EQ(avc.vals_r_view("a").data(), a.data());
+  EXPECT_EQ(std::vector<double>{1}, a.to_vector());
+
+  stan::io::vals_view<int> a_i = vcc.vals_i_view("a");
+  EXPECT_EQ(std::vector<int>{7}, a_i.to_vector());
+
+  stan::io::vals_view<double> n = vcc.vals_r_view("n");
+  EXPECT_TRUE(n.owns());
+  EXPECT_EQ(std::vector<double>{8}, n.to_vector());
+  EXPECT_TRUE(vcc.vals_r_view("z").empty());
+}
+
+TEST(chained_var_context, lookup) {
+  stan::io::array_var_context avc(std::vector<std::string>{"a", "b"},
+                                  std::vector<double>{1, 2, 3},
+                                  std::vector<std::vector<size_t>>{{}, {2}});
+  stan::io::array_var_context avc2(std::vector<std::string>{"a", "n"},
+                                   std::vector<int>{7, 8, 9},
+                                   std::vector<std::vector<size_t>>{{}, {2}});
+  stan::io::chained_var_context vcc(avc, avc2);
+
+  stan::io::var_entry a = vcc.lookup("a");
+  ASSERT_TRUE(a);
+  EXPECT_FALSE(a.is_int);
+  EXPECT_EQ(std::vector<double>{1}, a.vals_r.to_vector());
+
+  stan::io::var_entry n = vcc.lookup("n");
+  ASSERT_TRUE(n);
+  EXPECT_TRUE(n.is_int);
+  EXPECT_EQ((std::vector<int>{8, 9}), n.vals_i.to_vector());
+  EXPECT_EQ(std::vector<size_t>{2}, vcc.dims_i("n"));
+  EXPECT_EQ(std::vector<size_t>{2}, vcc.dims_r("b"));
+  EXPECT_EQ(0, vcc.dims_i("b").size());
+  EXPECT_FALSE(vcc.lookup("z"));
+}
+
+TEST(chained_var_context, dims_without_values) {
+  stan::io::array_var_context avc(std::vector<std::string>{"a", "b"},
+                                  std::vector<double>{1, 2, 3},
+                                  std::vector<std::vector<size_t>>{{}, {2}});
+  stan::io::array_var_context avc2(std::vector<std::string>{"n"},
+                                   std::vector<int>{7, 8},
+                                   std::vector<std::vector<size_t>>{{2}});
+  counting_var_context cvc(avc), cvc2(avc2);
+  stan::io::chained_var_context vcc(cvc, cvc2);
+
+  EXPECT_EQ(std::vector<size_t>{2}, vcc.dims_r("b"));
+  EXPECT_EQ(std::vector<size_t>{2}, vcc.dims_i("n"));
+  vcc.validate_dims("data", "b", "vector", {2});
+  vcc.validate_dims("data", "n", "int", {2});
+  EXPECT_THROW(vcc.validate_dims("data", "b", "int", {2}),
+               std::runtime_error);
+  EXPECT_EQ(0, cvc.vals_calls);
+  EXPECT_EQ(0, cvc2.vals_calls);
+
+  EXPECT_EQ((std::vector<double>{2, 3}), vcc.vals_r("b"));
+  EXPECT_EQ(1, cvc.vals_calls);
+}
@@ -683,3 +683,126 @@ TEST(io_dump, too_large_zero_array) {
   test_exception(
       "a <- structure(double(999918446744073709551616L), .Dim = c(2,3))");
 }
+
+TEST(io_dump, reader_move_values) {
+  std::stringstream in("a <- c(1, 2L, 3)\nb <- c(4, 5.5, -Inf)");
+  stan::io::dump_reader reader(in);
+  std::vector<int> ints;
+  std::vector<double> doubles;
+
+  ASSERT_TRUE(reader.next());
+  ASSERT_TRUE(reader.is_int());
+  reader.move_int_values(ints);
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), ints);
+  EXPECT_EQ(0U, reader.int_values().size());
+
+  ASSERT_TRUE(reader.next());
+  ASSERT_FALSE(reader.is_int());
+  reader.move_double_values(doubles);
+  ASSERT_EQ(3U, doubles.size());
+  EXPECT_FLOAT_EQ(4, doubles[0]);
+  EXPECT_FLOAT_EQ(5.5, doubles[1]);
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), doubles[2]);
+  EXPECT_EQ(0U, reader.double_values().size());
+  EXPECT_FALSE(reader.next());
+}
+
+TEST(io_dump, reader_long_mixed_seq) {
+  std::stringstream txt;
+  std::vector<double> expected;
+  txt << "x <- c(";
+  for (int i = 0; i < 100000; ++i) {
+    if (i > 0)
+      txt << (i % 7 == 0 ? " ,\n " : ",");
+    if (i == 50000) {
+      txt << "0.25e1";
+      expected.push_back(2.5);
+    } else {
+      txt << i;
+      expected.push_back(i);
+    }
+  }
+  txt << ")";
+  std::stringstream in(txt.str());
+  stan::io::dump dump(in);
+  EXPECT_FALSE(dump.contains_i("x"));
+  std::vector<double> vals = dump.vals_r("x");
+  ASSERT_EQ(expected.size(), vals.size());
+  for (size_t i = 0; i < vals.size(); ++i)
+    ASSERT_EQ(expected[i], vals[i]);
+}
+
+void test_next_exception(const std::string& input,
+                         const std::string& exception_text) {
+  std::stringstream in(input);
+  stan::io::dump_reader reader(in);
+  try {
+    reader.next();
+  } catch (const std::invalid_argument& e) {
+    EXPECT_TRUE(hasEnding(e.what(), exception_text)) << e.what();
+    return;
+  }
+  FAIL() << "no exception for " << input;
+}
+
+TEST(io_dump, out_of_range_messages) {
+  test_next_exception("k <- c(1, 2147483648)",
+                      "value 2147483648 beyond int range");
+  test_next_exception("a <- c(1.0, 1e400)", "value 1e400 beyond numeric range");
+  test_next_exception("a <- c(1.0, 4e-400)",
+                      "value 4e-400 beyond numeric range");
+  test_next_exception("a <- c(1.0, 1e)", "value 1e beyond numeric range");
+}
+
+TEST(io_dump, vals_views) {
+  std::stringstream in("y <- c(1.5, 2.5, 3.5)\nN <- 3\nx <- c(4, 5)\n");
+  stan::io::dump dump(in);
+  stan::io::vals_view<double> y = dump.vals_r_view("y");
+  EXPECT_FALSE(y.owns());
+  EXPECT_EQ(dump.vals_r("y"), y.to_vector());
+  EXPECT_EQ(y.data(), dump.vals_r_view("y").data());
+
+  stan::io::vals_view<int> x = dump.vals_i_view("x");
+  EXPECT_FALSE(x.owns());
+  EXPECT_EQ(dump.vals_i("x"), x.to_vector());
+
+  stan::io::vals_view<double> x_r = dump.vals_r_view("x");
+  EXPECT_TRUE(x_r.owns());
+  EXPECT_EQ(dump.vals_r("x"), x_r.to_vector());
+
+  EXPECT_TRUE(dump.vals_r_view("z").empty());
+  EXPECT_TRUE(dump.vals_i_view("y").empty());
+}
+
+TEST(io_dump, lookup) {
+  std::stringstream in(
+      "y <- c(1.5, 2.5, 3.5)\n"
+      "x <- structure(c(4, 5, 6, 7), .Dim = c(2, 2))\n");
+  stan::io::dump dump(in);
+
+  stan::io::var_entry y = dump.lookup("y");
+  ASSERT_TRUE(y);
+  EXPECT_FALSE(y.is_int);
+  EXPECT_EQ(dump.vals_r_view("y").data(), y.vals_r.data());
+  EXPECT_EQ(std::vector<size_t>{3}, y.dims.to_vector());
+
+  stan::io::var_entry x = dump.lookup("x");
+  ASSERT_TRUE(x);
+  EXPECT_TRUE(x.is_int);
+  EXPECT_EQ(dump.vals_i("x"), x.vals_i.to_vector());
+  EXPECT_EQ((std::vector<size_t>{2, 2}), x.dims.to_vector());
+
+  EXPECT_FALSE(dump.lookup("z"));
+  EXPECT_TRUE(dump.remove("x"));
+  EXPECT_FALSE(dump.lookup("x"));
+}
+
+TEST(io_dump, names_sorted) {
+  std::stringstream in("b <- 1.5\nd <- 2\na <- 2.5\nc <- 3\n");
+  stan::io::dump dump(in);
+  std::vector<std::string> names;
+  dump.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), names);
+  dump.names_i(names);
+  EXPECT_EQ((std::vector<std::string>{"c", "d"}), names);
+}
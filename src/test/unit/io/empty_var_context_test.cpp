@@ -52,3 +52,14 @@ TEST(empty_var_context, names_i) {
   EXPECT_NO_THROW(context.names_i(names_i));
   EXPECT_EQ(0, names_i.size());
 }
+
+TEST(empty_var_context, vals_views) {
+  stan::io::empty_var_context context;
+  EXPECT_TRUE(context.vals_r_view("").empty());
+  EXPECT_TRUE(context.vals_i_view("").empty());
+}
+
+TEST(empty_var_context, lookup) {
+  stan::io::empty_var_context context;
+  EXPECT_FALSE(context.lookup(""));
+}
@@ -0,0 +1,157 @@
+#include <stan/io/json_data.hpp>
+#include <stan/io/dump.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+stan::io::json_data read_json(const std::string& txt) {
+  std::stringstream in(txt);
+  return stan::io::json_data(in);
+}
+
+void expect_json_error(const std::string& txt, const std::string& what) {
+  try {
+    read_json(txt);
+  } catch (const std::invalid_argument& e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find(what))
+        << e.what();
+    return;
+  }
+  FAIL() << "no exception for " << txt;
+}
+
+TEST(io_json_data, scalars) {
+  stan::io::json_data data
+      = read_json("{\"N\": 3, \"sigma\": 2.5, \"big\": 3000000000}");
+  EXPECT_TRUE(data.contains_i("N"));
+  EXPECT_EQ(std::vector<int>{3}, data.vals_i("N"));
+  EXPECT_EQ(0U, data.dims_i("N").size());
+
+  EXPECT_FALSE(data.contains_i("sigma"));
+  EXPECT_TRUE(data.contains_r("sigma"));
+  EXPECT_EQ(std::vector<double>{2.5}, data.vals_r("sigma"));
+  EXPECT_EQ(0U, data.dims_r("sigma").size());
+
+  EXPECT_FALSE(data.contains_i("big"));
+  EXPECT_FLOAT_EQ(3e9, data.vals_r("big")[0]);
+
+  EXPECT_TRUE(data.contains_r("N"));
+  EXPECT_EQ(std::vector<double>{3}, data.vals_r("N"));
+  EXPECT_FALSE(data.contains_r("missing"));
+}
+
+TEST(io_json_data, int_real_promotion) {
+  stan::io::json_data data
+      = read_json("{\"y\": [1, 2, 3.5, -4], \"k\": [1, -2, 3]}");
+  EXPECT_FALSE(data.contains_i("y"));
+  EXPECT_EQ((std::vector<double>{1, 2, 3.5, -4}), data.vals_r("y"));
+  EXPECT_EQ(std::vector<size_t>{4}, data.dims_r("y"));
+  EXPECT_EQ((std::vector<int>{1, -2, 3}), data.vals_i("k"));
+  EXPECT_EQ(std::vector<size_t>{3}, data.dims_i("k"));
+
+  std::vector<std::string> names;
+  data.names_r(names);
+  EXPECT_EQ(std::vector<std::string>{"y"}, names);
+  data.names_i(names);
+  EXPECT_EQ(std::vector<std::string>{"k"}, names);
+}
+
+TEST(io_json_data, vals_views) {
+  stan::io::json_data data = read_json("{\"y\": [1.5, 2], \"k\": [1, 2]}");
+  stan::io::vals_view<double> y = data.vals_r_view("y");
+  EXPECT_FALSE(y.owns());
+  EXPECT_EQ(y.data(), data.vals_r_view("y").data());
+  EXPECT_EQ(data.vals_r("y"), y.to_vector());
+  stan::io::vals_view<int> k = data.vals_i_view("k");
+  EXPECT_FALSE(k.owns());
+  EXPECT_EQ(data.vals_i("k"), k.to_vector());
+  stan::io::vals_view<double> k_r = data.vals_r_view("k");
+  EXPECT_TRUE(k_r.owns());
+  EXPECT_EQ(data.vals_r("k"), k_r.to_vector());
+  EXPECT_TRUE(data.vals_i_view("y").empty());
+}
+
+TEST(io_json_data, lookup) {
+  stan::io::json_data data = read_json("{\"y\": [1.5, 2], \"k\": 3}");
+  stan::io::var_entry y = data.lookup("y");
+  ASSERT_TRUE(y);
+  EXPECT_FALSE(y.is_int);
+  EXPECT_EQ(data.vals_r_view("y").data(), y.vals_r.data());
+  EXPECT_EQ(std::vector<size_t>{2}, y.dims.to_vector());
+  stan::io::var_entry k = data.lookup("k");
+  ASSERT_TRUE(k);
+  EXPECT_TRUE(k.is_int);
+  EXPECT_EQ(std::vector<int>{3}, k.vals_i.to_vector());
+  EXPECT_TRUE(k.dims.empty());
+  EXPECT_FALSE(data.lookup("z"));
+}
+
+TEST(io_json_data, nested_arrays_column_major) {
+  stan::io::json_data data = read_json(
+      "{\"x\": [[1, 2, 3], [4, 5, 6]],"
+      " \"z\": [[[1, 2], [3, 4], [5, 6]], [[7, 8], [9, 10], [11, 12]]]}");
+  EXPECT_EQ((std::vector<size_t>{2, 3}), data.dims_i("x"));
+  EXPECT_EQ((std::vector<int>{1, 4, 2, 5, 3, 6}), data.vals_i("x"));
+
+  std::stringstream dump_in(
+      "z <- structure(c(1, 7, 3, 9, 5, 11, 2, 8, 4, 10, 6, 12),"
+      " .Dim = c(2, 3, 2))");
+  stan::io::dump dump(dump_in);
+  EXPECT_EQ(dump.dims_i("z"), data.dims_i("z"));
+  EXPECT_EQ(dump.vals_i("z"), data.vals_i("z"));
+}
+
+TEST(io_json_data, empty_arrays) {
+  stan::io::json_data data = read_json("{\"a\": [], \"b\": [[], []]}");
+  EXPECT_TRUE(data.contains_i("a"));
+  EXPECT_EQ(std::vector<size_t>{0}, data.dims_i("a"));
+  EXPECT_EQ((std::vector<size_t>{2, 0}), data.dims_i("b"));
+  EXPECT_EQ(0U, data.vals_i("b").size());
+  EXPECT_EQ(0U, read_json("{}").vals_r("a").size());
+}
+
+TEST(io_json_data, infinity_nan) {
+  stan::io::json_data data = read_json(
+      "{\"a\": [\"Infinity\", \"-Infinity\", \"NaN\", \"-Inf\", 1],"
+      " \"b\": [Infinity, -Infinity, NaN]}");
+  std::vector<double> a = data.vals_r("a");
+  ASSERT_EQ(5U, a.size());
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), a[0]);
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), a[1]);
+  EXPECT_TRUE(std::isnan(a[2]));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), a[3]);
+  EXPECT_EQ(1, a[4]);
+  std::vector<double> b = data.vals_r("b");
+  ASSERT_EQ(3U, b.size());
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), b[0]);
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), b[1]);
+  EXPECT_TRUE(std::isnan(b[2]));
+}
+
+TEST(io_json_data, validate_dims) {
+  stan::io::json_data data = read_json("{\"x\": [[1, 2, 3], [4, 5, 6]]}");
+  EXPECT_NO_THROW(data.validate_dims("data", "x", "int", {2, 3}));
+  EXPECT_NO_THROW(data.validate_dims("data", "x", "double", {2, 3}));
+  EXPECT_THROW(data.validate_dims("data", "x", "int", {3, 2}),
+               std::runtime_error);
+}
+
+TEST(io_json_data, errors) {
+  expect_json_error("{\"x\": [[1, 2], [3]]}", "variable x: non-rectangular");
+  expect_json_error("{\"x\": [[1, 2], 3]}", "variable x: non-rectangular");
+  expect_json_error("{\"x\": [1, [2]]}", "variable x: non-rectangular");
+  expect_json_error("{\"x\": [[], [1]]}", "variable x: non-rectangular");
+  expect_json_error("{\"x\": 1, \"x\": 2}", "variable x: duplicate");
+  expect_json_error("{\"x\": \"abc\"}", "variable x: string values");
+  expect_json_error("{\"x\": true}", "variable x: boolean values");
+  expect_json_error("{\"x\": null}", "variable x: null values");
+  expect_json_error("{\"x\": {\"y\": 1}}", "nested objects");
+  expect_json_error("[1, 2]", "must be an object");
+  expect_json_error("{\"x\": [1, 2}", "line 1, column 12");
+  expect_json_error("{\"x\":\n 1e400}", "line 2");
+  expect_json_error("{\"x\": 1} 2", "extra characters");
+  expect_json_error("{\"x\": 1", "unexpected end");
+}
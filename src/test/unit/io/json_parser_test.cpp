@@ -0,0 +1,57 @@
+#include <stan/io/json_parser.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+class recording_handler {
+ public:
+  std::stringstream events;
+  void start_object() { events << "{"; }
+  void end_object() { events << "}"; }
+  void key(const std::string& k) { events << "key:" << k << " "; }
+  void start_array() { events << "["; }
+  void end_array() { events << "]"; }
+  void int_value(int n) { events << "int:" << n << " "; }
+  void double_value(double x) { events << "double:" << x << " "; }
+  void string_value(const std::string& s) { events << "string:" << s << " "; }
+  void bool_value(bool b) { events << "bool:" << b << " "; }
+  void null_value() { events << "null "; }
+};
+
+std::string parse_events(const std::string& txt) {
+  std::stringstream in(txt);
+  recording_handler handler;
+  stan::io::parse_json(in, handler);
+  return handler.events.str();
+}
+
+TEST(io_json_parser, events) {
+  EXPECT_EQ("{key:a int:1 key:b [double:2.5 int:-3 [][]]key:c string:x\"y }",
+            parse_events("{\"a\": 1, \"b\": [2.5, -3, [], [ ]],"
+                         " \"c\": \"x\\\"y\"}"));
+  EXPECT_EQ("[bool:1 bool:0 null ]", parse_events(" [true, false, null] "));
+}
+
+TEST(io_json_parser, numbers) {
+  EXPECT_EQ("[int:2147483647 int:-2147483648 double:2.14748e+09 double:100 "
+            "double:-0.5 double:inf double:-inf ]",
+            parse_events("[2147483647, -2147483648, 2147483648, 1e2, -5E-1,"
+                         " Infinity, -Infinity]"));
+  EXPECT_EQ("[double:nan ]", parse_events("[NaN]"));
+}
+
+TEST(io_json_parser, string_escapes) {
+  EXPECT_EQ("string:a\\/\n\t\xC3\xA9 ",
+            parse_events("\"a\\\\\\/\\n\\t\\u00e9\""));
+}
+
+TEST(io_json_parser, errors) {
+  EXPECT_THROW(parse_events("[1, 2"), std::invalid_argument);
+  EXPECT_THROW(parse_events("[1 2]"), std::invalid_argument);
+  EXPECT_THROW(parse_events("{\"a\" 1}"), std::invalid_argument);
+  EXPECT_THROW(parse_events("{a: 1}"), std::invalid_argument);
+  EXPECT_THROW(parse_events("[1.2.3]"), std::invalid_argument);
+  EXPECT_THROW(parse_events("[tru]"), std::invalid_argument);
+  EXPECT_THROW(parse_events("\"abc"), std::invalid_argument);
+  EXPECT_THROW(parse_events(""), std::invalid_argument);
+}
@@ -0,0 +1,204 @@
+#include <stan/io/mmap_var_context.hpp>
+#include <stan/io/binary_data_writer.hpp>
+#include <stan/io/dump.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class StanIoMmapVarContext : public testing::Test {
+ public:
+  void SetUp() { path = testing::TempDir() + "mmap_var_context_test.bin"; }
+
+  void TearDown() { std::remove(path.c_str()); }
+
+  void write_file(const std::string& contents) {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out << contents;
+  }
+
+  std::string path;
+};
+
+TEST_F(StanIoMmapVarContext, round_trip) {
+  {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    stan::io::binary_data_writer writer(out);
+    writer.write("N", std::vector<int>{3}, std::vector<size_t>{});
+    writer.write("y", std::vector<double>{1.5, -2, 3.25},
+                 std::vector<size_t>{3});
+    writer.write("x", std::vector<int>{1, 2, 3, 4, 5, 6},
+                 std::vector<size_t>{2, 3});
+    writer.write("a_long_variable_name",
+                 std::vector<double>{std::numeric_limits<double>::infinity(),
+                                     std::numeric_limits<double>::quiet_NaN()},
+                 std::vector<size_t>{2});
+    writer.write("empty", std::vector<int>{}, std::vector<size_t>{2, 0});
+  }
+
+  stan::io::mmap_var_context context(path);
+  EXPECT_TRUE(context.contains_i("N"));
+  EXPECT_EQ(std::vector<int>{3}, context.vals_i("N"));
+  EXPECT_EQ(0U, context.dims_i("N").size());
+  EXPECT_TRUE(context.contains_r("N"));
+  EXPECT_EQ(std::vector<double>{3}, context.vals_r("N"));
+
+  EXPECT_FALSE(context.contains_i("y"));
+  EXPECT_TRUE(context.contains_r("y"));
+  EXPECT_EQ((std::vector<double>{1.5, -2, 3.25}), context.vals_r("y"));
+  EXPECT_EQ(std::vector<size_t>{3}, context.dims_r("y"));
+  EXPECT_EQ(0U, context.vals_i("y").size());
+
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6}), context.vals_i("x"));
+  EXPECT_EQ((std::vector<size_t>{2, 3}), context.dims_i("x"));
+  EXPECT_NO_THROW(context.validate_dims("data", "x", "int", {2, 3}));
+
+  std::vector<double> a = context.vals_r("a_long_variable_name");
+  ASSERT_EQ(2U, a.size());
+  EXPECT_TRUE(std::isinf(a[0]));
+  EXPECT_TRUE(std::isnan(a[1]));
+
+  EXPECT_EQ((std::vector<size_t>{2, 0}), context.dims_i("empty"));
+  EXPECT_EQ(0U, context.vals_i("empty").size());
+
+  EXPECT_FALSE(context.contains_r("missing"));
+  EXPECT_EQ(0U, context.vals_r("missing").size());
+
+  std::vector<std::string> names;
+  context.names_i(names);
+  EXPECT_EQ((std::vector<std::string>{"N", "empty", "x"}), names);
+  context.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"a_long_variable_name", "y"}), names);
+}
+
+TEST_F(StanIoMmapVarContext, convert_dump) {
+  std::stringstream in(
+      "N <- 4\n"
+      "y <- c(1.5, 2, 3, 4)\n"
+      "z <- structure(c(1, 2, 3, 4, 5, 6), .Dim = c(3, 2))\n");
+  stan::io::dump dump(in);
+  {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    stan::io::binary_data_writer writer(out);
+    writer.write(dump);
+  }
+  stan::io::mmap_var_context context(path);
+  for (const std::string& name : {"N", "z"}) {
+    EXPECT_TRUE(context.contains_i(name));
+    EXPECT_EQ(dump.vals_i(name), context.vals_i(name));
+    EXPECT_EQ(dump.dims_i(name), context.dims_i(name));
+  }
+  EXPECT_FALSE(context.contains_i("y"));
+  EXPECT_EQ(dump.vals_r("y"), context.vals_r("y"));
+  EXPECT_EQ(dump.dims_r("y"), context.dims_r("y"));
+}
+
+TEST_F(StanIoMmapVarContext, writer_size_mismatch) {
+  std::stringstream out;
+  stan::io::binary_data_writer writer(out);
+  EXPECT_THROW(writer.write("x", std::vector<double>{1, 2, 3},
+                            std::vector<size_t>{2, 2}),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoMmapVarContext, bad_files) {
+  EXPECT_THROW(stan::io::mmap_var_context(path + ".missing"),
+               std::invalid_argument);
+
+  write_file("NOTSTAN!");
+  EXPECT_THROW(stan::io::mmap_var_context context(path),
+               std::invalid_argument);
+
+  std::stringstream out;
+  {
+    stan::io::binary_data_writer writer(out);
+    writer.write("y", std::vector<double>{1, 2, 3}, std::vector<size_t>{3});
+  }
+  std::string full = out.str();
+  write_file(full.substr(0, full.size() - 8));
+  EXPECT_THROW(stan::io::mmap_var_context context(path),
+               std::invalid_argument);
+
+  write_file(full + full);
+  EXPECT_THROW(stan::io::mmap_var_context context(path),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoMmapVarContext, truncated_files) {
+  std::stringstream out;
+  {
+    stan::io::binary_data_writer writer(out);
+    writer.write("y", std::vector<double>{1, 2, 3}, std::vector<size_t>{3});
+  }
+  // file header, record header, dims, name "y" and 7 bytes of padding,
+  // then 24 bytes of values
+  std::string full = out.str();
+  ASSERT_EQ(16 + 16 + 8 + 8 + 24, full.size());
+  for (size_t size : {44, 48, 60, 71}) {
+    write_file(full.substr(0, size));
+    EXPECT_THROW(stan::io::mmap_var_context context(path),
+                 std::invalid_argument)
+        << "truncated to " << size << " bytes";
+  }
+
+  std::stringstream out_i;
+  {
+    stan::io::binary_data_writer writer(out_i);
+    writer.write("k", std::vector<int>{1, 2, 3}, std::vector<size_t>{3});
+  }
+  std::string full_i = out_i.str();
+  write_file(full_i.substr(0, full_i.size() - 2));
+  EXPECT_THROW(stan::io::mmap_var_context context(path), std::invalid_argument)
+      << "truncated inside the padding of the values";
+}
+
+TEST_F(StanIoMmapVarContext, vals_views) {
+  {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    stan::io::binary_data_writer writer(out);
+    writer.write("y", std::vector<double>{1.5, -2, 3.25},
+                 std::vector<size_t>{3});
+    writer.write("k", std::vector<int>{1, 2}, std::vector<size_t>{2});
+  }
+  stan::io::mmap_var_context context(path);
+  stan::io::vals_view<double> y = context.vals_r_view("y");
+  EXPECT_FALSE(y.owns());
+  EXPECT_EQ(y.data(), context.vals_r_view("y").data());
+  EXPECT_EQ(context.vals_r("y"), y.to_vector());
+
+  stan::io::vals_view<int> k = context.vals_i_view("k");
+  EXPECT_FALSE(k.owns());
+  EXPECT_EQ(context.vals_i("k"), k.to_vector());
+  stan::io::vals_view<double> k_r = context.vals_r_view("k");
+  EXPECT_TRUE(k_r.owns());
+  EXPECT_EQ((std::vector<double>{1, 2}), k_r.to_vector());
+
+  EXPECT_TRUE(context.vals_r_view("z").empty());
+  EXPECT_TRUE(context.vals_i_view("y").empty());
+}
+
+TEST_F(StanIoMmapVarContext, lookup) {
+  {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    stan::io::binary_data_writer writer(out);
+    writer.write("y", std::vector<double>{1.5, -2}, std::vector<size_t>{2});
+    writer.write("k", std::vector<int>{1, 2, 3, 4},
+                 std::vector<size_t>{2, 2});
+  }
+  stan::io::mmap_var_context context(path);
+  stan::io::var_entry y = context.lookup("y");
+  ASSERT_TRUE(y);
+  EXPECT_FALSE(y.is_int);
+  EXPECT_EQ(context.vals_r_view("y").data(), y.vals_r.data());
+  EXPECT_EQ(std::vector<size_t>{2}, y.dims.to_vector());
+  stan::io::var_entry k = context.lookup("k");
+  ASSERT_TRUE(k);
+  EXPECT_TRUE(k.is_int);
+  EXPECT_EQ(context.vals_i("k"), k.vals_i.to_vector());
+  EXPECT_EQ((std::vector<size_t>{2, 2}), k.dims.to_vector());
+  EXPECT_FALSE(context.lookup("z"));
+}
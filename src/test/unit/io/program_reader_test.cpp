@@ -1,5 +1,8 @@
 #include <stan/io/program_reader.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -279,3 +282,83 @@ TEST(prog_reader, allowSequential) {
   stan::io::program_reader reader(ss, "foo", search_path);
   EXPECT_EQ("functions {\n// foo\n// foo\n}\nmodel { }\n", reader.program());
 }
+
+void expect_same_reads(const std::string& program,
+                       stan::io::include_cache& cache) {
+  std::vector<std::string> search_path = create_search_path();
+  std::stringstream ss1(program);
+  stan::io::program_reader expected(ss1, "foo", search_path);
+  std::stringstream ss2(program);
+  stan::io::program_reader found(ss2, "foo", search_path, cache);
+  EXPECT_EQ(expected.program(), found.program());
+  ASSERT_EQ(expected.history().size(), found.history().size());
+  for (size_t i = 0; i < expected.history().size(); ++i) {
+    EXPECT_EQ(expected.history()[i].concat_line_num_,
+              found.history()[i].concat_line_num_);
+    EXPECT_EQ(expected.history()[i].line_num_, found.history()[i].line_num_);
+    EXPECT_EQ(expected.history()[i].action_, found.history()[i].action_);
+    EXPECT_EQ(expected.history()[i].path_, found.history()[i].path_);
+  }
+  std::string text = expected.program();
+  int num_lines = std::count(text.begin(), text.end(), '\n');
+  for (int i = 1; i <= num_lines + 2; ++i)
+    expect_eq_traces(expected.trace(i), found.trace(i));
+}
+
+TEST(prog_reader, includeCache) {
+  stan::io::include_cache cache;
+  std::vector<std::string> programs;
+  programs.push_back(
+      "functions {\n#include incl_fun.stan\n}\n"
+      "#include incl_params.stan// comment should be OK\n"
+      "model {\n}\n");
+  programs.push_back("parameters {\n#include incl_nested.stan\n}\n");
+  programs.push_back("functions {\n#include badrecurse1.stan\n}\nmodel { }\n");
+  programs.push_back(
+      "functions {\n#include simple1.stan\n#include simple1.stan\n}\n"
+      "model { }\n");
+  programs.push_back("model {\n}\n#include incl_fun.stan");
+
+  for (const std::string& program : programs)
+    expect_same_reads(program, cache);
+  size_t misses = cache.misses();
+  EXPECT_EQ(misses, cache.size());
+  EXPECT_LT(0u, cache.hits());
+
+  size_t hits = cache.hits();
+  for (const std::string& program : programs)
+    expect_same_reads(program, cache);
+  EXPECT_EQ(misses, cache.misses());
+  EXPECT_EQ(hits + hits + misses, cache.hits());
+
+  cache.clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(prog_reader, includeCacheRereadsChangedFiles) {
+  const std::string path = "program_reader_cache_test.stan";
+  std::vector<std::string> search_path(1, ".");
+  stan::io::include_cache cache;
+  {
+    std::ofstream out(path.c_str());
+    out << "  real y;\n";
+  }
+  std::stringstream ss1("parameters {\n#include " + path + "\n}\n");
+  stan::io::program_reader reader1(ss1, "foo", search_path, cache);
+  EXPECT_EQ("parameters {\n  real y;\n}\n", reader1.program());
+  {
+    std::ofstream out(path.c_str());
+    out << "  real y;\n  real z;\n";
+  }
+  std::stringstream ss2("parameters {\n#include " + path + "\n}\n");
+  stan::io::program_reader reader2(ss2, "foo", search_path, cache);
+  EXPECT_EQ("parameters {\n  real y;\n  real z;\n}\n", reader2.program());
+  expect_trace(reader2, 3, "foo", 2, path, 2);
+  EXPECT_EQ(2u, cache.misses());
+  EXPECT_EQ(1u, cache.size());
+  std::remove(path.c_str());
+
+  std::stringstream ss3("parameters {\n#include " + path + "\n}\n");
+  EXPECT_THROW(stan::io::program_reader(ss3, "foo", search_path, cache),
+               std::runtime_error);
+}
@@ -132,6 +132,19 @@ TEST_F(random_var_context, dims_r) {
   EXPECT_EQ(2, dims_r[0]);
 }
 
+TEST_F(random_var_context, lookup) {
+  stan::io::random_var_context context(model, rng, 2, false);
+  EXPECT_FALSE(context.lookup(""));
+
+  stan::io::var_entry entry = context.lookup("y");
+  ASSERT_TRUE(entry);
+  EXPECT_FALSE(entry.is_int);
+  EXPECT_EQ(context.vals_r("y"), entry.vals_r.to_vector());
+  EXPECT_EQ(context.dims_r("y"), entry.dims.to_vector());
+  EXPECT_FALSE(entry.vals_r.owns());
+  EXPECT_EQ(entry.vals_r.data(), context.vals_r_view("y").data());
+}
+
 TEST_F(random_var_context, contains_i) {
   stan::io::random_var_context context(model, rng, 2, false);
   EXPECT_FALSE(context.contains_i(""));
@@ -500,3 +500,238 @@ TEST_F(StanIoStanCsvReader, ParseEightSchools) {
 
   EXPECT_EQ("", out.str());
 }
+
+TEST_F(StanIoStanCsvReader, read_samples_line_endings_and_special_values) {
+  std::stringstream in;
+  in << "1,2.5,-3e-2\r\n"
+     << "\n"
+     << "# a comment between draws\n"
+     << "nan,inf,-inf\n"
+     << " 4 , 5 ,6\n"
+     << "#  Elapsed Time: 0.5 seconds (Warm-up)\n"
+     << "#                1.25 seconds (Sampling)\n"
+     << "7,8,9";
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, 0, 1));
+
+  ASSERT_EQ(4, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  EXPECT_FLOAT_EQ(1, samples(0, 0));
+  EXPECT_FLOAT_EQ(2.5, samples(0, 1));
+  EXPECT_FLOAT_EQ(-0.03, samples(0, 2));
+  EXPECT_TRUE(std::isnan(samples(1, 0)));
+  EXPECT_TRUE(std::isinf(samples(1, 1)));
+  EXPECT_GT(0, samples(1, 2));
+  EXPECT_FLOAT_EQ(4, samples(2, 0));
+  EXPECT_FLOAT_EQ(6, samples(2, 2));
+  EXPECT_FLOAT_EQ(9, samples(3, 2));
+  EXPECT_FLOAT_EQ(0.5, timing.warmup);
+  EXPECT_FLOAT_EQ(1.25, timing.sampling);
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_empty_fields) {
+  std::stringstream in("1,2,\n3,4,5\n,6, \n");
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, 0, 1));
+
+  ASSERT_EQ(3, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  EXPECT_FLOAT_EQ(2, samples(0, 1));
+  EXPECT_FLOAT_EQ(0, samples(0, 2)) << "empty last field is 0";
+  EXPECT_FLOAT_EQ(3, samples(1, 0));
+  EXPECT_FLOAT_EQ(5, samples(1, 2));
+  EXPECT_FLOAT_EQ(0, samples(2, 0)) << "empty first field is 0";
+  EXPECT_FLOAT_EQ(6, samples(2, 1));
+  EXPECT_FLOAT_EQ(0, samples(2, 2)) << "blank last field is 0";
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_column_mismatch) {
+  std::stringstream in("1,2,3\n4,5\n");
+  Eigen::MatrixXd samples(1, 1);
+  samples << 10;
+  stan::io::stan_csv_timing timing;
+  std::stringstream out;
+  EXPECT_FALSE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, &out));
+  EXPECT_EQ("Error: expected 3 columns, but found 2 instead for row 2\n",
+            out.str());
+  ASSERT_EQ(1, samples.size()) << "samples unchanged on failure";
+  EXPECT_FLOAT_EQ(10, samples(0, 0));
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_large_block_boundaries) {
+  std::stringstream in;
+  int rows = 100000;
+  for (int i = 0; i < rows; ++i)
+    in << i << "," << -i << ",0.125\n";
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, 0, 10));
+  ASSERT_EQ(rows, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  for (int i = 0; i < rows; ++i) {
+    ASSERT_FLOAT_EQ(i, samples(i, 0));
+    ASSERT_FLOAT_EQ(-i, samples(i, 1));
+    ASSERT_FLOAT_EQ(0.125, samples(i, 2));
+  }
+}
+
+TEST_F(StanIoStanCsvReader, parse_selection) {
+  std::stringstream out;
+  stan::io::stan_csv all
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out);
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+
+  stan::io::stan_csv_selection selection;
+  selection.columns = {"mu[3]", "lp__", "sigma_delta"};
+  selection.row_begin = 10;
+  selection.row_end = 500;
+  selection.row_stride = 7;
+  stan::io::stan_csv some
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out, selection);
+
+  EXPECT_EQ(selection.columns, some.header);
+  EXPECT_EQ(all.metadata.num_samples, some.metadata.num_samples);
+  EXPECT_FLOAT_EQ(all.timing.sampling, some.timing.sampling);
+  ASSERT_EQ(70, some.samples.rows());
+  ASSERT_EQ(3, some.samples.cols());
+  int mu3 = std::find(all.header.begin(), all.header.end(), "mu[3]")
+            - all.header.begin();
+  for (int r = 0; r < some.samples.rows(); ++r) {
+    int row = 10 + 7 * r;
+    EXPECT_EQ(all.samples(row, mu3), some.samples(r, 0));
+    EXPECT_EQ(all.samples(row, 0), some.samples(r, 1));
+    EXPECT_EQ(all.samples(row, all.samples.cols() - 1), some.samples(r, 2));
+  }
+}
+
+TEST_F(StanIoStanCsvReader, parse_selection_unknown_column) {
+  std::stringstream out;
+  stan::io::stan_csv_selection selection;
+  selection.columns = {"lp__", "not_a_column"};
+  EXPECT_THROW(
+      stan::io::stan_csv_reader::parse(blocker0_stream, &out, selection),
+      std::invalid_argument);
+}
+
+TEST_F(StanIoStanCsvReader, zero_row_stride) {
+  std::stringstream out;
+  stan::io::stan_csv_selection selection;
+  selection.row_stride = 0;
+  EXPECT_THROW(
+      stan::io::stan_csv_reader::parse(blocker0_stream, &out, selection),
+      std::invalid_argument);
+
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+  stan::io::stan_csv_index index
+      = stan::io::stan_csv_reader::index(blocker0_stream, &out);
+  EXPECT_THROW(
+      stan::io::stan_csv_reader::read(blocker0_stream, index, selection, &out),
+      std::invalid_argument);
+}
+
+TEST_F(StanIoStanCsvReader, index_and_read) {
+  std::stringstream out;
+  stan::io::stan_csv all
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out);
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+
+  stan::io::stan_csv_index index
+      = stan::io::stan_csv_reader::index(blocker0_stream, &out);
+  EXPECT_EQ(all.header, index.header);
+  ASSERT_EQ(all.samples.rows(), index.row_offsets.size());
+  EXPECT_FLOAT_EQ(all.timing.warmup, index.timing.warmup);
+  EXPECT_FLOAT_EQ(all.timing.sampling, index.timing.sampling);
+
+  stan::io::stan_csv whole = stan::io::stan_csv_reader::read(
+      blocker0_stream, index, stan::io::stan_csv_selection(), &out);
+  EXPECT_EQ(all.header, whole.header);
+  EXPECT_TRUE(all.samples == whole.samples);
+
+  stan::io::stan_csv_selection selection;
+  selection.columns = {"delta_new", "d"};
+  selection.row_begin = 995;
+  selection.row_stride = 2;
+  stan::io::stan_csv tail = stan::io::stan_csv_reader::read(
+      blocker0_stream, index, selection, &out);
+  ASSERT_EQ(3, tail.samples.rows());
+  ASSERT_EQ(2, tail.samples.cols());
+  for (int r = 0; r < 3; ++r) {
+    EXPECT_EQ(all.samples(995 + 2 * r, all.samples.cols() - 2),
+              tail.samples(r, 0));
+    EXPECT_EQ(all.samples(995 + 2 * r, 7), tail.samples(r, 1));
+  }
+
+  selection.row_begin = 2000;
+  EXPECT_EQ(0, stan::io::stan_csv_reader::read(blocker0_stream, index,
+                                               selection, &out)
+                   .samples.rows());
+}
+
+TEST_F(StanIoStanCsvReader, parse_memory) {
+  std::string csv
+      = "# thin = 1\n"
+        "a,b,c\n"
+        "# Adaptation terminated\n"
+        "1,2.5,-3e-2\r\n"
+        "\n"
+        "nan,inf,-inf\n"
+        "#  Elapsed Time: 0.5 seconds (Warm-up)\n"
+        "#                1.25 seconds (Sampling)\n"
+        "7,8,9";
+  std::stringstream out;
+  stan::io::stan_csv data = stan::io::stan_csv_reader::parse(
+      csv.data(), csv.data() + csv.size(), &out);
+  ASSERT_EQ(3, data.header.size());
+  EXPECT_EQ("c", data.header[2]);
+  ASSERT_EQ(3, data.samples.rows());
+  ASSERT_EQ(3, data.samples.cols());
+  EXPECT_FLOAT_EQ(-0.03, data.samples(0, 2));
+  EXPECT_TRUE(std::isnan(data.samples(1, 0)));
+  EXPECT_FLOAT_EQ(9, data.samples(2, 2));
+  EXPECT_FLOAT_EQ(0.5, data.timing.warmup);
+  EXPECT_FLOAT_EQ(1.25, data.timing.sampling);
+
+  csv = "a,b\n1,2\n3\n";
+  data = stan::io::stan_csv_reader::parse(csv.data(), csv.data() + csv.size(),
+                                          &out);
+  EXPECT_EQ(0, data.samples.size());
+  EXPECT_NE(std::string::npos,
+            out.str().find("expected 2 columns, but found 1 instead"));
+}
+
+TEST_F(StanIoStanCsvReader, parse_files) {
+  std::stringstream out;
+  stan::io::stan_csv blocker0
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out);
+
+  std::string blocker0_path = "src/test/unit/io/test_csv_files/blocker.0.csv";
+  std::vector<stan::io::stan_csv> data
+      = stan::io::stan_csv_reader::parse_files({blocker0_path, blocker0_path},
+                                               &out);
+  ASSERT_EQ(2, data.size());
+  for (const auto& chain : data) {
+    EXPECT_EQ(blocker0.header, chain.header);
+    EXPECT_EQ(blocker0.metadata.seed, chain.metadata.seed);
+    EXPECT_EQ(blocker0.adaptation.step_size, chain.adaptation.step_size);
+    EXPECT_FLOAT_EQ(blocker0.timing.sampling, chain.timing.sampling);
+    EXPECT_TRUE(blocker0.samples == chain.samples);
+  }
+
+  EXPECT_THROW(stan::io::stan_csv_reader::parse_files(
+                   {blocker0_path,
+                    "src/test/unit/io/test_csv_files/eight_schools.csv"},
+                   &out),
+               std::invalid_argument);
+  EXPECT_THROW(stan::io::stan_csv_reader::parse_files(
+                   {blocker0_path, "src/test/unit/io/no_such_file.csv"}, &out),
+               std::invalid_argument);
+}
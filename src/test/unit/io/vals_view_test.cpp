@@ -0,0 +1,65 @@
+#include <stan/io/vals_view.hpp>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+TEST(vals_view, empty) {
+  stan::io::vals_view<double> view;
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(0, view.size());
+  EXPECT_FALSE(view.owns());
+  EXPECT_EQ(view.begin(), view.end());
+  EXPECT_EQ(0, view.to_vector().size());
+}
+
+TEST(vals_view, refers_to_vector) {
+  std::vector<double> vals{1.5, 2.5, 3.5};
+  stan::io::vals_view<double> view(vals);
+  EXPECT_FALSE(view.owns());
+  EXPECT_EQ(vals.data(), view.data());
+  ASSERT_EQ(3, view.size());
+  EXPECT_FLOAT_EQ(2.5, view[1]);
+  EXPECT_EQ(vals, view.to_vector());
+}
+
+TEST(vals_view, refers_to_pointer) {
+  int vals[] = {4, 5};
+  stan::io::vals_view<int> view(vals, 2);
+  EXPECT_FALSE(view.owns());
+  EXPECT_EQ(vals, view.data());
+  std::vector<int> copy(view.begin(), view.end());
+  EXPECT_EQ((std::vector<int>{4, 5}), copy);
+}
+
+TEST(vals_view, owns_vector) {
+  std::vector<double> vals{1, 2, 3};
+  const double* data = vals.data();
+  stan::io::vals_view<double> view(std::move(vals));
+  EXPECT_TRUE(view.owns());
+  EXPECT_EQ(data, view.data());
+  EXPECT_EQ(3, view.size());
+  EXPECT_FLOAT_EQ(3, view[2]);
+}
+
+TEST(vals_view, copy_and_move) {
+  stan::io::vals_view<double> owning(std::vector<double>{1, 2, 3});
+  stan::io::vals_view<double> copy(owning);
+  EXPECT_TRUE(copy.owns());
+  EXPECT_NE(owning.data(), copy.data());
+  EXPECT_EQ(owning.to_vector(), copy.to_vector());
+
+  const double* data = owning.data();
+  stan::io::vals_view<double> moved(std::move(owning));
+  EXPECT_EQ(data, moved.data());
+  EXPECT_FLOAT_EQ(2, moved[1]);
+
+  std::vector<double> vals{7, 8};
+  stan::io::vals_view<double> assigned;
+  assigned = stan::io::vals_view<double>(vals);
+  EXPECT_FALSE(assigned.owns());
+  EXPECT_EQ(vals.data(), assigned.data());
+  assigned = copy;
+  EXPECT_TRUE(assigned.owns());
+  EXPECT_NE(copy.data(), assigned.data());
+  EXPECT_EQ(copy.to_vector(), assigned.to_vector());
+}
@@ -0,0 +1,113 @@
+#include <stan/io/var_index.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(var_index, insert_and_find) {
+  stan::io::var_index vars;
+  EXPECT_EQ(nullptr, vars.find("y"));
+
+  stan::io::var_index::var& y = vars.insert_r("y");
+  y.vals_r = {1.5, 2.5};
+  y.dims = {2};
+  stan::io::var_index::var& n = vars.insert_i("N");
+  n.vals_i = {3};
+  EXPECT_EQ(2, vars.size());
+
+  ASSERT_NE(nullptr, vars.find("y"));
+  EXPECT_FALSE(vars.find("y")->is_int);
+  ASSERT_NE(nullptr, vars.find("N"));
+  EXPECT_TRUE(vars.find("N")->is_int);
+  EXPECT_EQ(nullptr, vars.find("n"));
+}
+
+TEST(var_index, accessors) {
+  stan::io::var_index vars;
+  stan::io::var_index::var& y = vars.insert_r("y");
+  y.vals_r = {1.5, 2.5};
+  y.dims = {2};
+  stan::io::var_index::var& k = vars.insert_i("k");
+  k.vals_i = {1, 2, 3};
+  k.dims = {3};
+
+  EXPECT_TRUE(vars.contains_r("y"));
+  EXPECT_FALSE(vars.contains_i("y"));
+  EXPECT_TRUE(vars.contains_r("k"));
+  EXPECT_TRUE(vars.contains_i("k"));
+  EXPECT_FALSE(vars.contains_r("z"));
+
+  EXPECT_EQ((std::vector<double>{1.5, 2.5}), vars.vals_r("y"));
+  EXPECT_EQ((std::vector<double>{1, 2, 3}), vars.vals_r("k"));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), vars.vals_i("k"));
+  EXPECT_EQ(0, vars.vals_i("y").size());
+  EXPECT_EQ(0, vars.vals_r("z").size());
+
+  EXPECT_EQ(std::vector<size_t>{2}, vars.dims_r("y"));
+  EXPECT_EQ(std::vector<size_t>{3}, vars.dims_r("k"));
+  EXPECT_EQ(std::vector<size_t>{3}, vars.dims_i("k"));
+  EXPECT_EQ(0, vars.dims_i("y").size());
+  EXPECT_EQ(0, vars.dims_r("z").size());
+
+  EXPECT_FALSE(vars.vals_r_view("y").owns());
+  EXPECT_TRUE(vars.vals_r_view("k").owns());
+  EXPECT_EQ(vars.find("k")->vals_i.data(), vars.vals_i_view("k").data());
+  EXPECT_TRUE(vars.vals_i_view("y").empty());
+}
+
+TEST(var_index, lookup) {
+  stan::io::var_index vars;
+  stan::io::var_index::var& y = vars.insert_r("y");
+  y.vals_r = {1.5, 2.5};
+  y.dims = {2};
+  stan::io::var_index::var& k = vars.insert_i("k");
+  k.vals_i = {4};
+
+  stan::io::var_entry entry = vars.lookup("y");
+  ASSERT_TRUE(entry);
+  EXPECT_FALSE(entry.is_int);
+  EXPECT_EQ(vars.find("y")->vals_r.data(), entry.vals_r.data());
+  EXPECT_EQ(vars.find("y")->dims.data(), entry.dims.data());
+  EXPECT_TRUE(entry.vals_i.empty());
+  EXPECT_FALSE(entry.real_vals().owns());
+
+  entry = vars.lookup("k");
+  ASSERT_TRUE(entry);
+  EXPECT_TRUE(entry.is_int);
+  EXPECT_EQ(std::vector<int>{4}, entry.vals_i.to_vector());
+  EXPECT_TRUE(entry.dims.empty());
+  EXPECT_TRUE(entry.vals_r.empty());
+  EXPECT_EQ(std::vector<double>{4}, entry.real_vals().to_vector());
+
+  EXPECT_FALSE(vars.lookup("z"));
+}
+
+TEST(var_index, replace_and_erase) {
+  stan::io::var_index vars;
+  vars.insert_i("x").vals_i = {1};
+  stan::io::var_index::var& x = vars.insert_r("x");
+  EXPECT_FALSE(x.is_int);
+  EXPECT_TRUE(x.vals_i.empty());
+  x.vals_r = {2.5};
+  EXPECT_EQ(1, vars.size());
+  EXPECT_FALSE(vars.contains_i("x"));
+  EXPECT_EQ(std::vector<double>{2.5}, vars.vals_r("x"));
+
+  EXPECT_TRUE(vars.erase("x"));
+  EXPECT_FALSE(vars.erase("x"));
+  EXPECT_FALSE(vars.contains_r("x"));
+  EXPECT_EQ(0, vars.size());
+}
+
+TEST(var_index, sorted_names) {
+  stan::io::var_index vars;
+  for (const std::string& name : {"delta", "alpha", "charlie", "bravo"})
+    vars.insert_r(name);
+  for (const std::string& name : {"n2", "n1"})
+    vars.insert_i(name);
+  std::vector<std::string> names{"stale"};
+  vars.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"alpha", "bravo", "charlie", "delta"}),
+            names);
+  vars.names_i(names);
+  EXPECT_EQ((std::vector<std::string>{"n1", "n2"}), names);
+}
@@ -50,6 +50,40 @@ TEST_F(McmcChains, constructor) {
   EXPECT_EQ(1000, chains2.num_samples(0));
 }
 
+TEST_F(McmcChains, constructor_parse_files) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1
+      = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  stan::io::stan_csv blocker2
+      = stan::io::stan_csv_reader::parse(blocker2_stream, &out);
+
+  stan::mcmc::chains<> chains(stan::io::stan_csv_reader::parse_files(
+      {"src/test/unit/mcmc/test_csv_files/blocker.1.csv",
+       "src/test/unit/mcmc/test_csv_files/blocker.2.csv"},
+      &out));
+  EXPECT_EQ("", out.str());
+  ASSERT_EQ(2, chains.num_chains());
+  EXPECT_EQ(blocker1.header, chains.param_names());
+  EXPECT_EQ(0, chains.warmup(0));
+  EXPECT_EQ(0, chains.warmup(1));
+  for (int j = 0; j < chains.num_params(); j++) {
+    EXPECT_TRUE(blocker1.samples.col(j) == chains.samples(0, j));
+    EXPECT_TRUE(blocker2.samples.col(j) == chains.samples(1, j));
+  }
+
+  stan::io::stan_csv epil1
+      = stan::io::stan_csv_reader::parse(epil1_stream, &out);
+  EXPECT_THROW(chains.add(std::move(epil1)), std::invalid_argument);
+  stan::io::stan_csv narrow = blocker1;
+  narrow.samples.conservativeResize(Eigen::NoChange,
+                                    narrow.samples.cols() - 1);
+  EXPECT_THROW(chains.add(std::move(narrow)), std::invalid_argument);
+  EXPECT_EQ(2, chains.num_chains());
+  chains.add(std::move(blocker2));
+  EXPECT_EQ(3, chains.num_chains());
+  EXPECT_EQ(0, blocker2.samples.size());
+}
+
 TEST_F(McmcChains, add) {
   std::stringstream out;
   stan::io::stan_csv blocker1
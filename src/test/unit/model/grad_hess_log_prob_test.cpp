@@ -1,5 +1,6 @@
 #include <stan/model/grad_hess_log_prob.hpp>
 #include <test/test-models/good/model/valid.hpp>
+#include <test/unit/model/rosenbrock_model.hpp>
 #include <test/unit/util.hpp>
 #include <gtest/gtest.h>
 
@@ -46,3 +47,35 @@ TEST(ModelUtil, grad_hess_log_prob) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(ModelUtil, grad_hess_log_prob_values) {
+  rosenbrock_model model;
+  std::vector<double> params_r{0.5, 1.5};
+  std::vector<int> params_i;
+  std::vector<double> gradient;
+  std::vector<double> hessian;
+
+  double lp = stan::model::grad_hess_log_prob<true, true>(
+      model, params_r, params_i, gradient, hessian);
+  EXPECT_FLOAT_EQ(-(0.25 + 100 * 1.25 * 1.25), lp);
+  ASSERT_EQ(2u, gradient.size());
+  EXPECT_FLOAT_EQ(1 + 200 * 1.25, gradient[0]);
+  EXPECT_FLOAT_EQ(-200 * 1.25, gradient[1]);
+  ASSERT_EQ(4u, hessian.size());
+  EXPECT_NEAR(298, hessian[0], 1e-6);
+  EXPECT_NEAR(200, hessian[1], 1e-6);
+  EXPECT_NEAR(200, hessian[2], 1e-6);
+  EXPECT_NEAR(-200, hessian[3], 1e-6);
+  EXPECT_EQ(hessian[1], hessian[2]);
+
+  std::vector<double> two_point_hessian;
+  stan::model::grad_hess_log_prob<true, true>(model, params_r, params_i,
+                                              gradient, two_point_hessian,
+                                              stan::model::two_point);
+  ASSERT_EQ(4u, two_point_hessian.size());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_NEAR(hessian[i], two_point_hessian[i], 1e-3);
+  EXPECT_EQ(two_point_hessian[1], two_point_hessian[2]);
+  EXPECT_FLOAT_EQ(0.5, params_r[0]);
+  EXPECT_FLOAT_EQ(1.5, params_r[1]);
+}
@@ -0,0 +1,116 @@
+#include <stan/model/gradient_workspace.hpp>
+#include <stan/model/log_prob_grad.hpp>
+#include <stan/model/log_prob_propto.hpp>
+#include <test/test-models/good/model/valid.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+/**
+ * Model with a single parameter that throws at negative points.
+ */
+class throwing_model {
+ public:
+  size_t num_params_r() const { return 1; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs) const {
+    if (stan::math::value_of(params_r(0)) < 0)
+      throw std::domain_error("negative point");
+    return -0.5 * (params_r(0) * params_r(0));
+  }
+};
+}  // namespace
+
+class ModelGradientWorkspace : public ::testing::Test {
+ public:
+  ModelGradientWorkspace()
+      : data_var_context(data_stream), model(data_var_context, 0, &output) {}
+
+  std::stringstream data_stream;
+  std::stringstream output;
+  stan::io::dump data_var_context;
+  valid_model_namespace::valid_model model;
+  stan::model::gradient_workspace workspace;
+};
+
+TEST_F(ModelGradientWorkspace, log_prob_grad) {
+  Eigen::VectorXd x(1);
+  Eigen::VectorXd g(1);
+  Eigen::VectorXd expected_g(1);
+  for (int i = 0; i < 10; ++i) {
+    x(0) = i - 4.5;
+    Eigen::VectorXd params_r = x;
+    double expected_lp
+        = stan::model::log_prob_grad<true, true>(model, params_r, expected_g);
+    double lp = workspace.log_prob_grad<true, true>(model, x, g);
+    EXPECT_FLOAT_EQ(expected_lp, lp);
+    EXPECT_FLOAT_EQ(expected_g(0), g(0));
+    EXPECT_FLOAT_EQ(-x(0), g(0));
+
+    expected_lp
+        = stan::model::log_prob_grad<false, false>(model, params_r, expected_g);
+    lp = workspace.log_prob_grad<false, false>(model, x, g, &output);
+    EXPECT_FLOAT_EQ(expected_lp, lp);
+    EXPECT_FLOAT_EQ(expected_g(0), g(0));
+  }
+  EXPECT_EQ("", output.str());
+}
+
+TEST_F(ModelGradientWorkspace, log_prob_propto) {
+  Eigen::VectorXd x(1);
+  x(0) = 1.5;
+  EXPECT_FLOAT_EQ(stan::model::log_prob_propto<true>(model, x),
+                  workspace.log_prob_propto<true>(model, x));
+  EXPECT_FLOAT_EQ(stan::model::log_prob_propto<false>(model, x),
+                  workspace.log_prob_propto<false>(model, x));
+}
+
+TEST_F(ModelGradientWorkspace, blocks) {
+  Eigen::MatrixXd points(1, 3);
+  points << 1, 2, 3;
+  Eigen::MatrixXd gradients(1, 3);
+  for (int j = 0; j < 3; ++j)
+    workspace.log_prob_grad<true, true>(model, points.col(j),
+                                        gradients.col(j));
+  EXPECT_FLOAT_EQ(-1, gradients(0, 0));
+  EXPECT_FLOAT_EQ(-3, gradients(0, 2));
+}
+
+TEST_F(ModelGradientWorkspace, keeps_enclosing_stack) {
+  stan::math::var outer = 3;
+  stan::math::var y = outer * outer;
+  Eigen::VectorXd x(1);
+  Eigen::VectorXd g(1);
+  x(0) = 2;
+  workspace.log_prob_grad<true, true>(model, x, g);
+  EXPECT_FLOAT_EQ(-2, g(0));
+  y.grad();
+  EXPECT_FLOAT_EQ(6, outer.adj());
+  stan::math::recover_memory();
+}
+
+TEST_F(ModelGradientWorkspace, wrong_gradient_size) {
+  Eigen::VectorXd x(1);
+  Eigen::VectorXd g(2);
+  x(0) = 2;
+  EXPECT_THROW((workspace.log_prob_grad<true, true>(model, x, g)),
+               std::invalid_argument);
+}
+
+TEST(ModelGradientWorkspaceErrors, recovers_after_exception) {
+  throwing_model model;
+  stan::model::gradient_workspace workspace;
+  Eigen::VectorXd x(1);
+  Eigen::VectorXd g(1);
+  x(0) = -1;
+  EXPECT_THROW((workspace.log_prob_grad<true, true>(model, x, g)),
+               std::domain_error);
+  EXPECT_THROW(workspace.log_prob_propto<true>(model, x), std::domain_error);
+  EXPECT_TRUE(stan::math::empty_nested());
+  x(0) = 4;
+  EXPECT_FLOAT_EQ(-8, (workspace.log_prob_grad<true, true>(model, x, g)));
+  EXPECT_FLOAT_EQ(-4, g(0));
+}
@@ -1,6 +1,9 @@
 #include <stan/model/hessian.hpp>
+#include <stan/model/model_base.hpp>
 #include <test/test-models/good/model/valid.hpp>
+#include <test/unit/model/rosenbrock_model.hpp>
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 TEST(ModelUtil, hessian) {
   int dim = 5;
@@ -31,3 +34,37 @@ TEST(ModelUtil, hessian) {
   // &output); EXPECT_THROW(stan::model::hessian(domain_fail_model, x, f,
   // grad_f, hess_f), std::domain_error); EXPECT_EQ("", output.str());
 }
+
+TEST(ModelUtil, hessian_autodiff) {
+  rosenbrock_model model;
+  Eigen::VectorXd x(2);
+  x << 0.5, 1.5;
+  double f;
+  Eigen::VectorXd grad_f;
+  Eigen::MatrixXd hess_f;
+  std::stringstream msgs;
+  stan::model::hessian<true, false>(model, x, f, grad_f, hess_f, &msgs);
+
+  EXPECT_FLOAT_EQ(-(0.25 + 100 * 1.25 * 1.25), f);
+  ASSERT_EQ(2, grad_f.size());
+  EXPECT_FLOAT_EQ(1 + 200 * 1.25, grad_f(0));
+  EXPECT_FLOAT_EQ(-200 * 1.25, grad_f(1));
+  ASSERT_EQ(2, hess_f.rows());
+  ASSERT_EQ(2, hess_f.cols());
+  EXPECT_FLOAT_EQ(298, hess_f(0, 0));
+  EXPECT_FLOAT_EQ(200, hess_f(0, 1));
+  EXPECT_FLOAT_EQ(200, hess_f(1, 0));
+  EXPECT_FLOAT_EQ(-200, hess_f(1, 1));
+  EXPECT_EQ("x=0.5;", msgs.str());
+
+  x(1) = 200;
+  EXPECT_THROW((stan::model::hessian<true, false>(model, x, f, grad_f,
+                                                  hess_f)),
+               std::domain_error);
+}
+
+TEST(ModelUtil, hessian_autodiff_model_base) {
+  EXPECT_TRUE(stan::model::has_autodiff_hessian<rosenbrock_model>::value);
+  EXPECT_FALSE(
+      stan::model::has_autodiff_hessian<stan::model::model_base>::value);
+}
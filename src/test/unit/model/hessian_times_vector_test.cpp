@@ -1,6 +1,9 @@
 #include <stan/model/hessian_times_vector.hpp>
 #include <test/test-models/good/model/valid.hpp>
+#include <test/unit/model/rosenbrock_model.hpp>
 #include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
 
 TEST(ModelUtil, hessian_times_vector) {
   int dim = 5;
@@ -33,3 +36,32 @@ TEST(ModelUtil, hessian_times_vector) {
   //             std::domain_error);
   // EXPECT_EQ("", output.str());
 }
+
+TEST(ModelUtil, hessian_times_vector_autodiff) {
+  rosenbrock_model model;
+  Eigen::VectorXd x(2);
+  x << 0.5, 1.5;
+  Eigen::VectorXd v(2);
+  v << 1, -2;
+  double f;
+  Eigen::VectorXd hess_f_dot_v;
+  std::stringstream msgs;
+  stan::model::hessian_times_vector<true, false>(model, x, v, f, hess_f_dot_v,
+                                                 &msgs);
+
+  EXPECT_FLOAT_EQ(-(0.25 + 100 * 1.25 * 1.25), f);
+  ASSERT_EQ(2, hess_f_dot_v.size());
+  EXPECT_FLOAT_EQ(298 - 2 * 200, hess_f_dot_v(0));
+  EXPECT_FLOAT_EQ(200 + 2 * 200, hess_f_dot_v(1));
+  EXPECT_EQ("x=0.5;", msgs.str());
+
+  x(1) = 200;
+  EXPECT_THROW((stan::model::hessian_times_vector<true, false>(
+                   model, x, v, f, hess_f_dot_v)),
+               std::domain_error);
+  x(1) = 1.5;
+  v.resize(3);
+  EXPECT_THROW((stan::model::hessian_times_vector<true, false>(
+                   model, x, v, f, hess_f_dot_v)),
+               std::invalid_argument);
+}
@@ -0,0 +1,125 @@
+#include <stan/model/log_prob_grad_batch.hpp>
+#include <stan/model/log_prob_grad.hpp>
+#include <test/test-models/good/model/valid.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+/**
+ * Model with a single parameter that logs each point it is evaluated
+ * at and throws at negative points.
+ */
+class logging_model {
+ public:
+  size_t num_params_r() const { return 1; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs) const {
+    double x = stan::math::value_of(params_r(0));
+    if (msgs)
+      *msgs << "x=" << x << ";";
+    if (x < 0)
+      throw std::domain_error("negative point");
+    return -0.5 * params_r(0) * params_r(0);
+  }
+};
+}  // namespace
+
+class ModelLogProbGradBatch : public ::testing::Test {
+ public:
+  ModelLogProbGradBatch()
+      : data_var_context(data_stream), model(data_var_context, 0, &output) {}
+
+  std::stringstream data_stream;
+  std::stringstream output;
+  stan::io::dump data_var_context;
+  valid_model_namespace::valid_model model;
+};
+
+TEST_F(ModelLogProbGradBatch, matches_log_prob_grad) {
+  const int num_points = 25;
+  Eigen::MatrixXd points(1, num_points);
+  for (int j = 0; j < num_points; ++j)
+    points(0, j) = 0.5 * j - 6;
+  Eigen::VectorXd lp(num_points);
+  Eigen::MatrixXd gradients(1, num_points);
+
+  stan::model::log_prob_grad_batch<true, true>(model, points, lp, gradients);
+
+  for (int j = 0; j < num_points; ++j) {
+    Eigen::VectorXd params_r = points.col(j);
+    Eigen::VectorXd gradient(1);
+    double expected_lp = stan::model::log_prob_grad<true, true>(
+        model, params_r, gradient);
+    EXPECT_EQ(expected_lp, lp(j));
+    EXPECT_EQ(gradient(0), gradients(0, j));
+    EXPECT_NEAR(-points(0, j), gradients(0, j), 1e-6);
+  }
+  EXPECT_EQ("", output.str());
+}
+
+TEST_F(ModelLogProbGradBatch, writes_into_blocks) {
+  Eigen::MatrixXd points(1, 3);
+  points << 1, 2, 3;
+  Eigen::MatrixXd results = Eigen::MatrixXd::Zero(4, 4);
+  stan::model::log_prob_grad_batch<false, false>(
+      model, points, results.col(0).tail(3), results.block(0, 1, 1, 3));
+  EXPECT_FLOAT_EQ(0, results(0, 0));
+  EXPECT_FLOAT_EQ(-0.5, results(1, 0));
+  EXPECT_FLOAT_EQ(-4.5, results(3, 0));
+  EXPECT_FLOAT_EQ(-2, results(0, 2));
+  EXPECT_FLOAT_EQ(0, results(1, 2));
+}
+
+TEST_F(ModelLogProbGradBatch, empty_batch) {
+  Eigen::MatrixXd points(1, 0);
+  Eigen::VectorXd lp(0);
+  Eigen::MatrixXd gradients(1, 0);
+  EXPECT_NO_THROW((stan::model::log_prob_grad_batch<true, true>(
+      model, points, lp, gradients)));
+}
+
+TEST_F(ModelLogProbGradBatch, checks_output_sizes) {
+  Eigen::MatrixXd points(1, 3);
+  points << 1, 2, 3;
+  Eigen::VectorXd lp(3);
+  Eigen::MatrixXd gradients(1, 3);
+  Eigen::VectorXd short_lp(2);
+  Eigen::MatrixXd short_gradients(1, 2);
+  Eigen::MatrixXd tall_gradients(2, 3);
+  EXPECT_THROW((stan::model::log_prob_grad_batch<true, true>(
+                   model, points, short_lp, gradients)),
+               std::invalid_argument);
+  EXPECT_THROW((stan::model::log_prob_grad_batch<true, true>(
+                   model, points, lp, short_gradients)),
+               std::invalid_argument);
+  EXPECT_THROW((stan::model::log_prob_grad_batch<true, true>(
+                   model, points, lp, tall_gradients)),
+               std::invalid_argument);
+}
+
+TEST(ModelLogProbGradBatchMessages, ordered_messages_and_first_error) {
+  logging_model model;
+  Eigen::MatrixXd points(1, 5);
+  points << 1, -2, 3, -4, 5;
+  Eigen::VectorXd lp(5);
+  Eigen::MatrixXd gradients(1, 5);
+  std::stringstream msgs;
+  try {
+    stan::model::log_prob_grad_batch<true, true>(model, points, lp,
+                                                 gradients, &msgs);
+    FAIL() << "expected an exception";
+  } catch (const std::domain_error& e) {
+    EXPECT_EQ(std::string("negative point"), e.what());
+  }
+  EXPECT_EQ("x=1;x=-2;x=3;x=-4;x=5;", msgs.str());
+  EXPECT_FLOAT_EQ(-12.5, lp(4));
+  EXPECT_FLOAT_EQ(-5, gradients(0, 4));
+
+  points << 1, 2, 3, 4, 5;
+  EXPECT_NO_THROW((stan::model::log_prob_grad_batch<true, true>(
+      model, points, lp, gradients)));
+  EXPECT_FLOAT_EQ(-3, gradients(0, 2));
+}
@@ -0,0 +1,57 @@
+#ifndef TEST_UNIT_MODEL_ROSENBROCK_MODEL_HPP
+#define TEST_UNIT_MODEL_ROSENBROCK_MODEL_HPP
+
+#include <stan/math/prim.hpp>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Rosenbrock's function chained over the parameters, log density
+ * -sum_i (100 (x[i + 1] - x[i]^2)^2 + (1 - x[i])^2), with its mode at
+ * all ones.  In two dimensions, the default, the log density is
+ * -((1 - x)^2 + 100 (y - x^2)^2) and its Hessian is
+ * [-2 + 400 y - 1200 x^2, 400 x; 400 x, -200].
+ *
+ * Evaluation throws std::domain_error if a parameter is above 100 and
+ * writes "x=" followed by the first parameter and ";" to the message
+ * stream, if there is one.
+ */
+class rosenbrock_model {
+ public:
+  explicit rosenbrock_model(size_t num_params = 2)
+      : num_params_(num_params) {}
+
+  size_t num_params_r() const { return num_params_; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs = 0) const {
+    using stan::math::square;
+    for (int i = 0; i < params_r.size(); ++i)
+      if (stan::math::value_of(params_r(i)) > 100)
+        throw std::domain_error("parameter too large");
+    if (msgs)
+      *msgs << "x=" << stan::math::value_of(params_r(0)) << ";";
+    T lp = 0.0;
+    for (int i = 0; i + 1 < params_r.size(); ++i)
+      lp = lp
+           - (100 * square(params_r(i + 1) - square(params_r(i)))
+              + square(1 - params_r(i)));
+    return lp;
+  }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(std::vector<T>& params_r, std::vector<int>& params_i,
+             std::ostream* msgs = 0) const {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> x(params_r.size());
+    for (size_t i = 0; i < params_r.size(); ++i)
+      x(i) = params_r[i];
+    return log_prob<propto, jacobian>(x, msgs);
+  }
+
+ private:
+  size_t num_params_;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef TEST_UNIT_OPTIMIZATION_BAD_HESSIAN_MODEL_HPP
+#define TEST_UNIT_OPTIMIZATION_BAD_HESSIAN_MODEL_HPP
+
+#include <stan/math/mix.hpp>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Standard normal log density in two dimensions whose second
+ * derivatives are broken: evaluation with <code>fvar<var></code>, as
+ * for autodiff Hessians and Hessian-vector products, throws
+ * std::domain_error "bad second derivative" or, if the model does not
+ * throw, returns NaN.  Log densities and gradients are fine.
+ */
+class bad_hessian_model {
+ public:
+  explicit bad_hessian_model(bool throws) : throws_(throws) {}
+
+  size_t num_params_r() const { return 2; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs = 0) const {
+    T lp = 0.0;
+    for (int i = 0; i < params_r.size(); ++i)
+      lp = lp - 0.5 * (params_r(i) * params_r(i));
+    if (std::is_same<T, stan::math::fvar<stan::math::var> >::value) {
+      if (throws_)
+        throw std::domain_error("bad second derivative");
+      return std::numeric_limits<double>::quiet_NaN() * lp;
+    }
+    return lp;
+  }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(std::vector<T>& params_r, std::vector<int>& params_i,
+             std::ostream* msgs = 0) const {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> x(params_r.size());
+    for (size_t i = 0; i < params_r.size(); ++i)
+      x(i) = params_r[i];
+    return log_prob<propto, jacobian>(x, msgs);
+  }
+
+ private:
+  bool throws_;
+};
+
+#endif
@@ -192,3 +192,123 @@ TEST(OptimizationBfgsLinesearch, wolfeLineSearch) {
   EXPECT_LE(f1, f0 + c1 * alpha * p.dot(gradx0));
   EXPECT_LE(std::fabs(p.dot(gradx1)), c2 * std::fabs(p.dot(gradx0)));
 }
+
+class steep_testfunc {
+ public:
+  int grad_evals;
+  steep_testfunc() : grad_evals(0) {}
+
+  int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x, double &f,
+                 Eigen::Matrix<double, Eigen::Dynamic, 1> &g) {
+    ++grad_evals;
+    f = (3.0 * x).array().exp().sum() - 3.0 * x.sum();
+    g = 3.0 * (3.0 * x).array().exp() - 3.0;
+    return 0;
+  }
+};
+
+class steep_value_testfunc : public steep_testfunc {
+ public:
+  int value_evals;
+  steep_value_testfunc() : value_evals(0) {}
+
+  using steep_testfunc::operator();
+  int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x,
+                 double &f) {
+    ++value_evals;
+    f = (3.0 * x).array().exp().sum() - 3.0 * x.sum();
+    return 0;
+  }
+};
+
+TEST(OptimizationBfgsLinesearch, LSEvaluationCache) {
+  typedef Eigen::Matrix<double, -1, 1> VectorT;
+  stan::optimization::LSEvaluationCache<double, VectorT> cache;
+  steep_value_testfunc func;
+  VectorT x0 = VectorT::Constant(3, -1.0);
+  VectorT p = VectorT::Ones(3);
+  VectorT x, g;
+  double f;
+
+  EXPECT_EQ(0, cache.evaluate(func, x0, p, 0.5, x, f, g, false));
+  EXPECT_FLOAT_EQ(3 * std::exp(-1.5) + 4.5, f);
+  EXPECT_EQ(1, func.value_evals);
+  EXPECT_EQ(0, func.grad_evals);
+
+  // value again is a hit, the gradient needs an evaluation
+  EXPECT_EQ(0, cache.evaluate(func, x0, p, 0.5, x, f, g, false));
+  EXPECT_EQ(1, func.value_evals);
+  EXPECT_EQ(1, cache.hits());
+  EXPECT_EQ(0, cache.evaluate(func, x0, p, 0.5, x, f, g, true));
+  EXPECT_EQ(1, func.grad_evals);
+  ASSERT_EQ(3, g.size());
+  EXPECT_FLOAT_EQ(3 * std::exp(-1.5) - 3, g[0]);
+  EXPECT_FLOAT_EQ(0, (x - (x0 + 0.5 * p)).norm());
+
+  // and is then recorded
+  g.setZero();
+  EXPECT_EQ(0, cache.evaluate(func, x0, p, 0.5, x, f, g, true));
+  EXPECT_EQ(1, func.grad_evals);
+  EXPECT_EQ(2, cache.hits());
+  EXPECT_FLOAT_EQ(3 * std::exp(-1.5) - 3, g[0]);
+
+  EXPECT_EQ(0, cache.evaluate(func, x0, p, 0.25, x, f, g, true));
+  EXPECT_EQ(2, func.grad_evals);
+  EXPECT_EQ(1, cache.value_evals());
+  EXPECT_EQ(2, cache.grad_evals());
+}
+
+TEST(OptimizationBfgsLinesearch, wolfeLineSearch_value_only) {
+  using stan::optimization::WolfeLineSearch;
+  typedef Eigen::Matrix<double, -1, 1> VectorT;
+
+  static const double c1 = 1e-4;
+  static const double c2 = 0.9;
+
+  // With a far too long initial step, zooming in rejects many trials,
+  // which need no gradient.
+  steep_testfunc grad_func;
+  steep_value_testfunc value_func;
+  VectorT x0 = VectorT::Constant(3, -1.0);
+  VectorT gradx0, gradx1, x1;
+  double f0, f1;
+  grad_func(x0, f0, gradx0);
+  grad_func.grad_evals = 0;
+  VectorT p = -gradx0;
+
+  double alpha = 100;
+  EXPECT_EQ(0, WolfeLineSearch(grad_func, alpha, x1, f1, gradx1, p, x0, f0,
+                               gradx0, c1, c2, 1e-16, 20.0, 10.0));
+
+  alpha = 100;
+  EXPECT_EQ(0, WolfeLineSearch(value_func, alpha, x1, f1, gradx1, p, x0, f0,
+                               gradx0, c1, c2, 1e-16, 20.0, 10.0));
+  EXPECT_GT(value_func.value_evals, 0);
+  EXPECT_LT(value_func.grad_evals, grad_func.grad_evals);
+
+  EXPECT_NEAR(0, (x1 - (x0 + alpha * p)).norm(), 1e-8);
+  VectorT g;
+  double f;
+  grad_func(x1, f, g);
+  EXPECT_FLOAT_EQ(f, f1);
+  EXPECT_NEAR(0, (g - gradx1).norm(), 1e-10);
+  EXPECT_LE(f1, f0 + c1 * alpha * p.dot(gradx0));
+  EXPECT_LE(std::fabs(p.dot(gradx1)), c2 * std::fabs(p.dot(gradx0)));
+}
+
+TEST(OptimizationBfgsLinesearch, CubicInterp_values) {
+  using stan::optimization::CubicInterp;
+  using stan::optimization::QuadraticInterp;
+
+  // f(x) = (x - 1)^2 (x + 2) has a local minimum at 1
+  auto f = [](double x) { return (x - 1) * (x - 1) * (x + 2); };
+  double df0 = 3 * (-0.5) * (-0.5) - 3;  // f'(-0.5)
+  EXPECT_NEAR(1.0, CubicInterp(-0.5, f(-0.5), df0, 2.0, f(2.0), 3.0, f(3.0)),
+              1e-10);
+
+  // g(x) = 2 (x - 0.75)^2 + 1
+  auto g = [](double x) { return 2 * (x - 0.75) * (x - 0.75) + 1; };
+  EXPECT_NEAR(0.75, QuadraticInterp(0.0, g(0.0), -3.0, 2.0, g(2.0)), 1e-10);
+  EXPECT_NEAR(0.75, CubicInterp(0.0, g(0.0), -3.0, 2.0, g(2.0), 5.0, g(5.0)),
+              1e-10);
+}
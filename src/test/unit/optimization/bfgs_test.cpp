@@ -291,6 +291,8 @@ TEST(OptimizationBfgs, ModelAdaptor_operator_parens__matrix_double) {
   double f;
 
   EXPECT_FLOAT_EQ(mod(cont_vector, f), 0);
+  EXPECT_EQ(1, mod.value_evals());
+  EXPECT_EQ(0, mod.fevals());
 }
 
 TEST(OptimizationBfgs, ModelAdaptor_operator_parens__matrix_double_matrix) {
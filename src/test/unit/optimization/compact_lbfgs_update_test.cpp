@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <stan/optimization/compact_lbfgs_update.hpp>
+#include <stan/optimization/lbfgs_update.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+
+typedef stan::optimization::CompactLBFGSUpdate<> CompactT;
+typedef stan::optimization::LBFGSUpdate<> ReferenceT;
+typedef CompactT::VectorT VectorT;
+
+namespace {
+// Random update pair with positive curvature s'y > 0
+void random_pair(boost::ecuyer1988& rng, VectorT& yk, VectorT& sk) {
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+      normal(rng, boost::normal_distribution<>());
+  for (int i = 0; i < sk.size(); ++i) {
+    sk[i] = normal();
+    yk[i] = (1.0 + i % 3) * sk[i] + 0.1 * normal();
+  }
+}
+}  // namespace
+
+TEST(OptimizationCompactLbfgsUpdate, lbfgs_update_secant) {
+  const unsigned int nDim = 10;
+  const unsigned int maxRank = 3;
+  VectorT yk(nDim), sk(nDim), sdir(nDim);
+
+  // Construct a set of BFGS update vectors and check that
+  // the secant equation H*yk = sk is always satisfied.
+  for (unsigned int rank = 1; rank <= maxRank; rank++) {
+    CompactT bfgsUp(rank);
+    for (unsigned int i = 0; i < nDim; i++) {
+      sk.setZero(nDim);
+      yk.setZero(nDim);
+      sk[i] = 1;
+      yk[i] = 1;
+
+      bfgsUp.update(yk, sk, i == 0);
+
+      for (unsigned int j = 0; j <= std::min(rank, i); j++) {
+        sk.setZero(nDim);
+        yk.setZero(nDim);
+        sk[i - j] = 1;
+        yk[i - j] = 1;
+
+        bfgsUp.search_direction(sdir, yk);
+
+        EXPECT_NEAR((sdir + sk).norm(), 0.0, 1e-10);
+      }
+    }
+  }
+}
+
+TEST(OptimizationCompactLbfgsUpdate, matches_two_loop_recursion) {
+  const unsigned int nDim = 50;
+  boost::ecuyer1988 rng(1234);
+  VectorT yk(nDim), sk(nDim), gk(nDim), pk(nDim), pk_ref(nDim);
+
+  for (unsigned int rank = 1; rank <= 6; rank++) {
+    CompactT compact(rank);
+    ReferenceT reference(rank);
+    for (unsigned int i = 0; i < 20; i++) {
+      random_pair(rng, yk, sk);
+      bool reset = i == 0 || i == 11;
+      EXPECT_FLOAT_EQ(reference.update(yk, sk, reset),
+                      compact.update(yk, sk, reset));
+
+      random_pair(rng, gk, sk);
+      compact.search_direction(pk, gk);
+      reference.search_direction(pk_ref, gk);
+      EXPECT_NEAR(0, (pk - pk_ref).norm(), 1e-10 * pk_ref.norm())
+          << "rank " << rank << ", update " << i;
+    }
+
+    compact.set_history_size(rank + 2);
+    reference.set_history_size(rank + 2);
+    for (unsigned int i = 0; i < 5; i++) {
+      random_pair(rng, yk, sk);
+      compact.update(yk, sk);
+      reference.update(yk, sk);
+      compact.search_direction(pk, gk);
+      reference.search_direction(pk_ref, gk);
+      EXPECT_NEAR(0, (pk - pk_ref).norm(), 1e-10 * pk_ref.norm())
+          << "rank " << rank << " grown, update " << i;
+    }
+
+    compact.set_history_size(1);
+    reference.set_history_size(1);
+    compact.search_direction(pk, gk);
+    reference.search_direction(pk_ref, gk);
+    EXPECT_NEAR(0, (pk - pk_ref).norm(), 1e-10 * pk_ref.norm())
+        << "rank " << rank << " shrunk";
+  }
+}
+
+TEST(OptimizationCompactLbfgsUpdate, empty_history) {
+  VectorT gk(3), pk;
+  gk << 1, -2, 3;
+  CompactT compact(4);
+  compact.search_direction(pk, gk);
+  EXPECT_FLOAT_EQ(0, (pk + gk).norm());
+}
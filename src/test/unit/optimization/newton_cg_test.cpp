@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <stan/optimization/newton_cg.hpp>
+#include <stan/optimization/bfgs.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/optimization/bad_hessian_model.hpp>
+#include <sstream>
+#include <vector>
+
+typedef rosenbrock_model_namespace::rosenbrock_model Model;
+
+class OptimizationNewtonCG : public testing::Test {
+ public:
+  std::vector<double> cont_vector;
+  std::vector<int> disc_vector;
+
+  void SetUp() {
+    cont_vector.resize(2);
+    cont_vector[0] = -1;
+    cont_vector[1] = 1;
+  }
+};
+
+TEST_F(OptimizationNewtonCG, minimize) {
+  static const std::string DATA("");
+  std::stringstream data_stream(DATA);
+  stan::io::dump dummy_context(data_stream);
+  Model rb_model(dummy_context);
+  std::stringstream out;
+  stan::optimization::NewtonCG<Model> newton(rb_model, cont_vector,
+                                             disc_vector, &out);
+  EXPECT_FLOAT_EQ(-4, newton.logp());
+  EXPECT_EQ(0, newton.iter_num());
+
+  newton._conv_opts.tolAbsF = 0;
+  newton._conv_opts.tolRelF = 0;
+  newton._conv_opts.tolAbsX = 0;
+  int ret = newton.minimize(cont_vector);
+  EXPECT_EQ(stan::optimization::TERM_ABSGRAD, ret);
+  EXPECT_NEAR(1, cont_vector[0], 1e-8);
+  EXPECT_NEAR(1, cont_vector[1], 1e-8);
+  EXPECT_NEAR(0, newton.logp(), 1e-12);
+  EXPECT_LT(newton.grad_norm(), newton._conv_opts.tolAbsGrad);
+  EXPECT_GT(newton.hessian_vector_evals(), 0);
+  EXPECT_EQ("", out.str());
+
+  // same starting point with BFGS
+  cont_vector[0] = -1;
+  cont_vector[1] = 1;
+  stan::optimization::BFGSLineSearch<Model,
+                                     stan::optimization::BFGSUpdate_HInv<> >
+      bfgs(rb_model, cont_vector, disc_vector, &out);
+  bfgs._conv_opts = newton._conv_opts;
+  while (bfgs.step() == stan::optimization::TERM_SUCCESS)
+    continue;
+  EXPECT_LT(newton.iter_num(), bfgs.iter_num());
+}
+
+TEST_F(OptimizationNewtonCG, max_iterations) {
+  static const std::string DATA("");
+  std::stringstream data_stream(DATA);
+  stan::io::dump dummy_context(data_stream);
+  Model rb_model(dummy_context);
+  stan::optimization::NewtonCG<Model> newton(rb_model, cont_vector,
+                                             disc_vector);
+  newton._conv_opts.maxIts = 2;
+  int ret = stan::optimization::TERM_SUCCESS;
+  while (ret == stan::optimization::TERM_SUCCESS)
+    ret = newton.step();
+  EXPECT_EQ(stan::optimization::TERM_MAXIT, ret);
+  EXPECT_EQ(2, newton.iter_num());
+  EXPECT_GT(newton.logp(), -4);
+  EXPECT_LE(newton.prev_step_size(), 2 * newton._tr_opts.radius0);
+}
+
+TEST_F(OptimizationNewtonCG, get_code_string) {
+  static const std::string DATA("");
+  std::stringstream data_stream(DATA);
+  stan::io::dump dummy_context(data_stream);
+  Model rb_model(dummy_context);
+  stan::optimization::NewtonCG<Model> newton(rb_model, cont_vector,
+                                             disc_vector);
+  EXPECT_EQ("Convergence detected: gradient norm is below tolerance",
+            newton.get_code_string(stan::optimization::TERM_ABSGRAD));
+  EXPECT_EQ(
+      "Trust region step failed to achieve a sufficient decrease, "
+      "no more progress can be made",
+      newton.get_code_string(stan::optimization::TERM_LSFAIL));
+  EXPECT_EQ("Unknown termination code", newton.get_code_string(-5));
+}
+
+TEST_F(OptimizationNewtonCG, hessian_vector_product_throws) {
+  bad_hessian_model model(true);
+  std::stringstream out;
+  stan::optimization::NewtonCG<bad_hessian_model> newton(model, cont_vector,
+                                                         disc_vector, &out);
+  EXPECT_EQ(stan::optimization::TERM_LSFAIL, newton.step());
+  EXPECT_EQ("Hessian-vector product failed", newton.note());
+  EXPECT_NE(std::string::npos,
+            out.str().find("Error evaluating Hessian-vector product: "
+                           "bad second derivative"));
+  EXPECT_FLOAT_EQ(-1, newton.logp());
+}
+
+TEST_F(OptimizationNewtonCG, hessian_vector_product_not_finite) {
+  bad_hessian_model model(false);
+  std::stringstream out;
+  stan::optimization::NewtonCG<bad_hessian_model> newton(model, cont_vector,
+                                                         disc_vector, &out);
+  EXPECT_EQ(stan::optimization::TERM_LSFAIL, newton.step());
+  EXPECT_EQ("Hessian-vector product failed", newton.note());
+  EXPECT_NE(std::string::npos, out.str().find("not finite"));
+  EXPECT_FLOAT_EQ(-1, newton.logp());
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <stan/optimization/newton.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/optimization/bad_hessian_model.hpp>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef rosenbrock_model_namespace::rosenbrock_model Model;
+
+TEST(OptimizationNewton, shifted_cholesky) {
+  stan::optimization::matrix_d A(2, 2);
+  A << 4, 1, 1, 3;
+  Eigen::LLT<stan::optimization::matrix_d> llt;
+  EXPECT_FLOAT_EQ(0, stan::optimization::shifted_cholesky(A, llt));
+  EXPECT_TRUE(A.isApprox(llt.reconstructedMatrix()));
+
+  // eigenvalues -1 and 3
+  A << 1, 2, 2, 1;
+  double tau = stan::optimization::shifted_cholesky(A, llt);
+  EXPECT_GT(tau, 1);
+  stan::optimization::matrix_d shifted
+      = A + tau * stan::optimization::matrix_d::Identity(2, 2);
+  EXPECT_TRUE(shifted.isApprox(llt.reconstructedMatrix()));
+}
+
+TEST(OptimizationNewton, trust_region_solve) {
+  stan::optimization::matrix_d A(2, 2);
+  A << 4, 1, 1, 3;
+  stan::optimization::vector_d g(2);
+  g << 1, 2;
+  stan::optimization::vector_d p;
+
+  double inf = std::numeric_limits<double>::infinity();
+  EXPECT_FLOAT_EQ(0, stan::optimization::trust_region_solve(A, g, inf, p));
+  EXPECT_TRUE(p.isApprox(A.ldlt().solve(g)));
+
+  double radius = 0.1;
+  double lambda = stan::optimization::trust_region_solve(A, g, radius, p);
+  EXPECT_GT(lambda, 0);
+  EXPECT_LE(p.norm(), radius * (1 + 1e-12));
+  EXPECT_GT(p.norm(), 0.9 * radius);
+  EXPECT_GT(g.dot(p), 0) << "step must be an ascent direction";
+}
+
+TEST(OptimizationNewton, trust_region_step_rosenbrock) {
+  static const std::string DATA("");
+  std::stringstream data_stream(DATA);
+  stan::io::dump dummy_context(data_stream);
+  Model model(dummy_context);
+
+  std::vector<double> params_r(2);
+  params_r[0] = -1;
+  params_r[1] = 1;
+  std::vector<int> params_i;
+  double radius = std::numeric_limits<double>::infinity();
+  double lp = -4;
+  int steps = 0;
+  for (; steps < 100; ++steps) {
+    double last_lp = lp;
+    lp = stan::optimization::newton_trust_region_step(
+        model, params_r, params_i, radius,
+        stan::optimization::autodiff_hessian);
+    EXPECT_GE(lp, last_lp) << "log density must not decrease";
+    if (std::fabs(lp - last_lp) <= 1e-12)
+      break;
+  }
+  EXPECT_LT(steps, 100);
+  EXPECT_NEAR(1, params_r[0], 1e-6);
+  EXPECT_NEAR(1, params_r[1], 1e-6);
+  EXPECT_GT(radius, 0);
+
+  params_r[0] = -1;
+  params_r[1] = 1;
+  radius = std::numeric_limits<double>::infinity();
+  for (int n = 0; n < 100; ++n)
+    stan::optimization::newton_trust_region_step(model, params_r, params_i,
+                                                 radius);
+  EXPECT_NEAR(1, params_r[0], 1e-3);
+  EXPECT_NEAR(1, params_r[1], 1e-3);
+}
+
+TEST(OptimizationNewton, hessian_not_finite) {
+  bad_hessian_model model(false);
+  std::vector<double> params_r(2, 1);
+  std::vector<int> params_i;
+  double radius = std::numeric_limits<double>::infinity();
+  EXPECT_THROW(stan::optimization::newton_trust_region_step(
+                   model, params_r, params_i, radius,
+                   stan::optimization::autodiff_hessian),
+               std::domain_error);
+  EXPECT_THROW(
+      stan::optimization::newton_step(model, params_r, params_i,
+                                      stan::optimization::autodiff_hessian),
+      std::domain_error);
+  EXPECT_EQ(std::vector<double>(2, 1), params_r);
+
+  stan::optimization::vector_d g;
+  stan::optimization::matrix_d H;
+  try {
+    stan::optimization::newton_derivatives(
+        model, params_r, params_i, stan::optimization::autodiff_hessian, g,
+        H);
+    FAIL() << "expected std::domain_error";
+  } catch (const std::domain_error& e) {
+    EXPECT_NE(std::string::npos,
+              std::string(e.what()).find("of the log density is not finite"));
+  }
+}
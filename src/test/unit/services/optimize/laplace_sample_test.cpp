@@ -0,0 +1,158 @@
+#include <stan/services/optimize/laplace_sample.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/array_var_context.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+
+struct mock_callback : public stan::callbacks::interrupt {
+  int n;
+  mock_callback() : n(0) {}
+
+  void operator()() { n++; }
+};
+
+class values : public stan::callbacks::stream_writer {
+ public:
+  std::vector<std::string> names_;
+  std::vector<std::vector<double> > states_;
+
+  values(std::ostream& stream) : stan::callbacks::stream_writer(stream) {}
+
+  void operator()(const std::vector<std::string>& names) { names_ = names; }
+
+  void operator()(const std::vector<double>& state) {
+    states_.push_back(state);
+  }
+};
+
+// constrained (x, y) as a var_context
+stan::io::array_var_context xy_context(double x, double y) {
+  std::vector<std::string> names_r;
+  std::vector<double> values_r;
+  std::vector<std::vector<size_t> > dim_r;
+  names_r.push_back("x");
+  names_r.push_back("y");
+  values_r.push_back(x);
+  values_r.push_back(y);
+  dim_r.push_back(std::vector<size_t>());
+  dim_r.push_back(std::vector<size_t>());
+  return stan::io::array_var_context(names_r, values_r, dim_r);
+}
+
+class ServicesOptimizeLaplaceSample : public testing::Test {
+ public:
+  ServicesOptimizeLaplaceSample()
+      : parameter(parameter_ss), model(context, 0, &model_ss) {}
+
+  std::stringstream parameter_ss, model_ss;
+  stan::test::unit::instrumented_logger logger;
+  values parameter;
+  stan::io::empty_var_context context;
+  stan_model model;
+};
+
+TEST_F(ServicesOptimizeLaplaceSample, rosenbrock) {
+  // the inverse of the negative Hessian at the mode (1, 1) is
+  // [[0.5, 1], [1, 2.005]]
+  stan::io::array_var_context mode = xy_context(1, 1);
+  mock_callback callback;
+  int num_draws = 4000;
+  int return_code = stan::services::optimize::laplace_sample(
+      model, mode, 0, 1, num_draws, false, 1000, callback, logger,
+      parameter);
+
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+  EXPECT_EQ(logger.call_count(), logger.call_count_info())
+      << "all output to info";
+  EXPECT_EQ(1, logger.find("Log density at the mode = "));
+  EXPECT_EQ(4, logger.find("Draw: "));
+  EXPECT_EQ(16, callback.n);
+
+  ASSERT_EQ(4, parameter.names_.size());
+  EXPECT_EQ("log_p__", parameter.names_[0]);
+  EXPECT_EQ("log_g__", parameter.names_[1]);
+  EXPECT_EQ("x", parameter.names_[2]);
+  EXPECT_EQ("y", parameter.names_[3]);
+  ASSERT_EQ(num_draws, parameter.states_.size());
+
+  Eigen::MatrixXd draws(num_draws, 2);
+  for (int n = 0; n < num_draws; ++n) {
+    const std::vector<double>& s = parameter.states_[n];
+    double x = s[2];
+    double y = s[3];
+    EXPECT_FLOAT_EQ(-((1 - x) * (1 - x) + 100 * (y - x * x) * (y - x * x)),
+                    s[0]);
+    EXPECT_LE(s[1], 0);
+    draws(n, 0) = x;
+    draws(n, 1) = y;
+  }
+  Eigen::RowVector2d mean = draws.colwise().mean();
+  Eigen::MatrixXd centered = draws.rowwise() - mean;
+  Eigen::Matrix2d cov = centered.transpose() * centered / (num_draws - 1);
+  EXPECT_NEAR(1, mean(0), 0.05);
+  EXPECT_NEAR(1, mean(1), 0.1);
+  EXPECT_NEAR(0.5, cov(0, 0), 0.05);
+  EXPECT_NEAR(1, cov(0, 1), 0.1);
+  EXPECT_NEAR(2.005, cov(1, 1), 0.2);
+}
+
+TEST_F(ServicesOptimizeLaplaceSample, reproducible) {
+  stan::io::array_var_context mode = xy_context(1, 1);
+  mock_callback callback;
+  stan::services::optimize::laplace_sample(model, mode, 3, 1, 300, false, 0,
+                                           callback, logger, parameter);
+  stan::test::unit::instrumented_logger logger2;
+  values parameter2(parameter_ss), parameter3(parameter_ss);
+  stan::services::optimize::laplace_sample(model, mode, 3, 1, 300, false, 0,
+                                           callback, logger2, parameter2);
+  stan::services::optimize::laplace_sample(model, mode, 3, 2, 300, false, 0,
+                                           callback, logger2, parameter3);
+
+  EXPECT_EQ(0, logger.find("Draw: "));
+  EXPECT_EQ(parameter.states_, parameter2.states_);
+  EXPECT_NE(parameter.states_[0], parameter3.states_[0]);
+}
+
+TEST_F(ServicesOptimizeLaplaceSample, autodiff_hessian) {
+  stan::io::array_var_context mode = xy_context(1, 1);
+  mock_callback callback;
+  int return_code = stan::services::optimize::laplace_sample(
+      model, mode, 3, 1, 100, true, 0, callback, logger, parameter);
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+
+  stan::test::unit::instrumented_logger logger2;
+  values parameter2(parameter_ss);
+  stan::services::optimize::laplace_sample(model, mode, 3, 1, 100, false, 0,
+                                           callback, logger2, parameter2);
+  ASSERT_EQ(100, parameter.states_.size());
+  ASSERT_EQ(100, parameter2.states_.size());
+  for (size_t n = 0; n < 100; ++n) {
+    EXPECT_NEAR(parameter2.states_[n][2], parameter.states_[n][2], 1e-4);
+    EXPECT_NEAR(parameter2.states_[n][3], parameter.states_[n][3], 1e-4);
+  }
+}
+
+TEST_F(ServicesOptimizeLaplaceSample, not_a_mode) {
+  // the Hessian at (0, 1) is indefinite
+  stan::io::array_var_context mode = xy_context(0, 1);
+  mock_callback callback;
+  int return_code = stan::services::optimize::laplace_sample(
+      model, mode, 0, 1, 100, false, 0, callback, logger, parameter);
+
+  EXPECT_EQ(stan::services::error_codes::SOFTWARE, return_code);
+  EXPECT_EQ(1, logger.find_error("not negative definite"));
+  EXPECT_EQ(0, parameter.states_.size());
+}
+
+TEST_F(ServicesOptimizeLaplaceSample, bad_num_draws) {
+  stan::io::array_var_context mode = xy_context(1, 1);
+  mock_callback callback;
+  int return_code = stan::services::optimize::laplace_sample(
+      model, mode, 0, 1, 0, false, 0, callback, logger, parameter);
+
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(1, logger.call_count_error());
+  EXPECT_EQ(0, callback.n);
+}
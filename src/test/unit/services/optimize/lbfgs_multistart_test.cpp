@@ -0,0 +1,100 @@
+#include <stan/services/optimize/lbfgs_multistart.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+
+struct mock_callback : public stan::callbacks::interrupt {
+  int n;
+  mock_callback() : n(0) {}
+
+  void operator()() { n++; }
+};
+
+class values : public stan::callbacks::stream_writer {
+ public:
+  std::vector<std::string> names_;
+  std::vector<std::vector<double> > states_;
+
+  values(std::ostream& stream) : stan::callbacks::stream_writer(stream) {}
+
+  void operator()(const std::vector<std::string>& names) { names_ = names; }
+
+  void operator()(const std::vector<double>& state) {
+    states_.push_back(state);
+  }
+};
+
+class ServicesOptimizeLbfgsMultistart : public testing::Test {
+ public:
+  ServicesOptimizeLbfgsMultistart()
+      : init(init_ss), parameter(parameter_ss), model(context, 0, &model_ss) {}
+
+  std::stringstream init_ss, parameter_ss, model_ss;
+  stan::callbacks::stream_writer init;
+  stan::test::unit::instrumented_logger logger;
+  values parameter;
+  stan::io::empty_var_context context;
+  stan_model model;
+};
+
+TEST_F(ServicesOptimizeLbfgsMultistart, rosenbrock_zero_radius) {
+  mock_callback callback;
+  int return_code = stan::services::optimize::lbfgs_multistart(
+      model, context, 0, 1, 0, 3, 1e-3, 5, 0.001, 1e-12, 10000, 1e-8,
+      10000000, 1e-8, 2000, callback, logger, init, parameter);
+
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+  EXPECT_EQ(logger.call_count(), logger.call_count_info())
+      << "all output to info";
+  EXPECT_EQ(3, logger.find("after 22 iterations; Convergence detected"));
+  EXPECT_EQ(1, logger.find("Mode 1: log joint probability"));
+  EXPECT_EQ(1, logger.find("found by 3 of 3 starts"));
+  EXPECT_EQ(1, logger.find("3 of 3 starts converged to 1 mode"));
+  EXPECT_EQ("0,0\n0,0\n0,0\n", init_ss.str());
+
+  ASSERT_EQ(3, parameter.names_.size());
+  EXPECT_EQ("lp__", parameter.names_[0]);
+  ASSERT_EQ(1, parameter.states_.size());
+  // each start is the run of the lbfgs service from (0, 0)
+  EXPECT_FLOAT_EQ(0.99998301, parameter.states_[0][1]);
+  EXPECT_FLOAT_EQ(0.99996597, parameter.states_[0][2]);
+  EXPECT_EQ(3 * 22, callback.n);
+}
+
+TEST_F(ServicesOptimizeLbfgsMultistart, rosenbrock_random_inits) {
+  mock_callback callback;
+  int return_code = stan::services::optimize::lbfgs_multistart(
+      model, context, 0, 1, 2, 8, 1e-3, 5, 0.001, 1e-12, 10000, 1e-8,
+      10000000, 1e-8, 2000, callback, logger, init, parameter);
+
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+  EXPECT_EQ(8, logger.find("Start "));
+  EXPECT_EQ(1, logger.find("found by 8 of 8 starts"));
+  ASSERT_EQ(1, parameter.states_.size());
+  EXPECT_NEAR(1, parameter.states_[0][1], 1e-3);
+  EXPECT_NEAR(1, parameter.states_[0][2], 1e-3);
+
+  // with no tolerance every start is its own mode, best first
+  stan::test::unit::instrumented_logger logger2;
+  values parameter2(parameter_ss);
+  stan::services::optimize::lbfgs_multistart(
+      model, context, 0, 1, 2, 8, 0, 5, 0.001, 1e-12, 10000, 1e-8, 10000000,
+      1e-8, 2000, callback, logger2, init, parameter2);
+  ASSERT_EQ(8, parameter2.states_.size());
+  for (size_t m = 1; m < parameter2.states_.size(); ++m)
+    EXPECT_GE(parameter2.states_[m - 1][0], parameter2.states_[m][0]);
+  EXPECT_EQ(parameter.states_[0], parameter2.states_[0]);
+}
+
+TEST_F(ServicesOptimizeLbfgsMultistart, no_starts) {
+  mock_callback callback;
+  int return_code = stan::services::optimize::lbfgs_multistart(
+      model, context, 0, 1, 2, 0, 1e-3, 5, 0.001, 1e-12, 10000, 1e-8,
+      10000000, 1e-8, 2000, callback, logger, init, parameter);
+
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(1, logger.call_count_error());
+  EXPECT_EQ(0, callback.n);
+}
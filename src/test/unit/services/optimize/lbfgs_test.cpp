@@ -89,3 +89,25 @@ TEST_F(ServicesOptimizeLbfgs, rosenbrock) {
   EXPECT_FLOAT_EQ(return_code, 0);
   EXPECT_EQ(22, callback.n);
 }
+
+TEST_F(ServicesOptimizeLbfgs, rosenbrock_compact_update) {
+  mock_callback callback;
+  int return_code = stan::services::optimize::lbfgs<
+      stan::optimization::CompactLBFGSUpdate<> >(
+      model, context, 0, 1, 0, 5, 0.001, 1e-12, 10000, 1e-8, 10000000, 1e-8,
+      2000, true, 0, callback, logger, init, parameter);
+
+  stan::test::unit::instrumented_logger logger2;
+  values parameter2(parameter_ss);
+  stan::services::optimize::lbfgs(model, context, 0, 1, 0, 5, 0.001, 1e-12,
+                                  10000, 1e-8, 10000000, 1e-8, 2000, true, 0,
+                                  callback, logger2, init, parameter2);
+
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+  EXPECT_EQ(1, logger.find("Optimization terminated normally: "));
+  // same search directions as the two-loop recursion, up to rounding
+  ASSERT_EQ(parameter2.states_.size(), parameter.states_.size());
+  for (size_t n = 0; n < parameter.states_.size(); ++n)
+    for (size_t i = 0; i < 3; ++i)
+      EXPECT_NEAR(parameter2.states_[n][i], parameter.states_[n][i], 1e-8);
+}
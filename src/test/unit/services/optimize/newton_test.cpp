@@ -120,3 +120,81 @@ TEST_F(ServicesOptimizeNewton, rosenbrock_no_save_iterations) {
   EXPECT_FLOAT_EQ(return_code, 0);
   EXPECT_GT(callback.n, 0);
 }
+
+TEST_F(ServicesOptimizeNewton, rosenbrock_autodiff_hessian) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  int num_iterations = 1000;
+  bool save_iterations = true;
+  bool autodiff_hessian = true;
+  mock_callback callback;
+
+  int return_code = stan::services::optimize::newton(
+      model, context, seed, chain, init_radius, num_iterations, save_iterations,
+      autodiff_hessian, callback, logger, init, parameter);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(logger.call_count(), logger.call_count_info())
+      << "all output to info";
+  EXPECT_EQ(1, logger.find("Initial log joint probability = -1"));
+
+  ASSERT_EQ(3, parameter.names_.size());
+  EXPECT_GT(parameter.states_.size(), 0);
+  EXPECT_FLOAT_EQ(0, parameter.states_.front()[1])
+      << "initial value should be (0, 0)";
+  EXPECT_NEAR(1, parameter.states_.back()[1], 1e-6)
+      << "optimal value should be (1, 1)";
+  EXPECT_NEAR(1, parameter.states_.back()[2], 1e-6)
+      << "optimal value should be (1, 1)";
+  EXPECT_GT(callback.n, 0);
+}
+
+TEST_F(ServicesOptimizeNewton, autodiff_hessian_model_base) {
+  stan::model::model_base& base_model = model;
+  mock_callback callback;
+
+  int return_code = stan::services::optimize::newton(
+      base_model, context, 0, 1, 0, 1000, false, true, callback, logger, init,
+      parameter);
+
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(1, logger.call_count_error());
+  EXPECT_EQ(0, parameter.states_.size());
+}
+
+TEST_F(ServicesOptimizeNewton, rosenbrock_trust_region) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  int num_iterations = 1000;
+  bool save_iterations = true;
+  bool autodiff_hessian = false;
+  bool trust_region = true;
+  mock_callback callback;
+
+  int return_code = stan::services::optimize::newton(
+      model, context, seed, chain, init_radius, num_iterations, save_iterations,
+      autodiff_hessian, trust_region, callback, logger, init, parameter);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(logger.call_count(), logger.call_count_info())
+      << "all output to info";
+  EXPECT_EQ(1, logger.find("Initial log joint probability = -1"));
+  EXPECT_EQ(1, logger.find("Iteration  1. Log joint probability ="));
+
+  ASSERT_EQ(3, parameter.names_.size());
+  EXPECT_GT(parameter.states_.size(), 0);
+  EXPECT_FLOAT_EQ(0, parameter.states_.front()[1])
+      << "initial value should be (0, 0)";
+  EXPECT_NEAR(1, parameter.states_.back()[1], 1e-3)
+      << "optimal value should be (1, 1)";
+  EXPECT_NEAR(1, parameter.states_.back()[2], 1e-3)
+      << "optimal value should be (1, 1)";
+  for (size_t n = 1; n < parameter.states_.size(); ++n)
+    EXPECT_GE(parameter.states_[n][0], parameter.states_[n - 1][0])
+        << "log density must not decrease";
+  EXPECT_GT(callback.n, 0);
+}
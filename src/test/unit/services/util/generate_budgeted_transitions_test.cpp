@@ -0,0 +1,64 @@
+#include <stan/services/util/generate_budgeted_transitions.hpp>
+#include <stan/services/sample/fixed_param.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+TEST(ServicesUtilBudget, min_ess_constant_parameter) {
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  boost::normal_distribution<> std_normal;
+  std::vector<std::vector<double>> draws(2);
+  for (int n = 0; n < 1000; ++n) {
+    draws[0].push_back(2.5);
+    draws[1].push_back(std_normal(rng));
+  }
+
+  std::vector<std::vector<double>> random_draws(1, draws[1]);
+  double ess
+      = stan::services::util::min_bulk_effective_sample_size(random_draws);
+  EXPECT_GT(ess, 500);
+  EXPECT_FLOAT_EQ(ess,
+                  stan::services::util::min_bulk_effective_sample_size(draws))
+      << "the constant parameter is skipped";
+
+  std::vector<std::vector<double>> constant_draws(1, draws[0]);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(),
+            stan::services::util::min_bulk_effective_sample_size(
+                constant_draws));
+}
+
+class ServicesUtilBudgetedTransitions : public testing::Test {
+ public:
+  ServicesUtilBudgetedTransitions() : model(context, 0, &model_log) {}
+
+  std::stringstream model_log;
+  stan::test::unit::instrumented_writer parameter, diagnostic;
+  stan::test::unit::instrumented_logger logger;
+  stan::io::empty_var_context context;
+  stan_model model;
+};
+
+TEST_F(ServicesUtilBudgetedTransitions, constant_monitored_parameters) {
+  // the fixed_param sampler never moves, so every monitored parameter,
+  // including lp__, is constant and the target is met at the first check
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  stan::mcmc::fixed_param_sampler sampler;
+  stan::services::util::mcmc_writer writer(parameter, diagnostic, logger);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), 0, 0);
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::services::util::sampling_budget budget(100, 50, 0, 1000);
+
+  int num_iterations;
+  stan::services::util::sampling_stop_reason reason
+      = stan::services::util::generate_budgeted_transitions(
+          sampler, budget, 0, 1, 0, writer, s, model, rng, interrupt, logger,
+          num_iterations);
+  EXPECT_EQ(stan::services::util::sampling_stop_reason::target_ess, reason);
+  EXPECT_EQ(budget.check_every, num_iterations);
+}
@@ -569,3 +569,69 @@ TEST_F(ServicesUtilInitialize, model_throws_in_write_array__full_init) {
   EXPECT_EQ(303, logger.call_count_info());
   EXPECT_EQ(100, logger.find_info("throwing within write_array"));
 }
+
+TEST_F(ServicesUtilInitialize, batched__radius_two) {
+  double init_radius = 2;
+  bool print_timing = false;
+  boost::ecuyer1988 rng_before = rng;
+  std::vector<double> params = stan::services::util::initialize(
+      model, empty_context, rng, init_radius, print_timing, logger, init, 4);
+  ASSERT_EQ(model.num_params_r(), params.size()) << "2 parameters";
+  EXPECT_GT(params[0], -init_radius);
+  EXPECT_LT(params[0], init_radius);
+  EXPECT_GT(params[1], -init_radius);
+  EXPECT_LT(params[1], init_radius);
+  EXPECT_TRUE(rng_before == rng);
+
+  EXPECT_EQ(0, logger.call_count());
+  ASSERT_EQ(1, init.vector_double_values().size());
+  EXPECT_EQ(params, init.vector_double_values()[0]);
+
+  for (size_t batch_size : {2, 7, 100}) {
+    stan::test::unit::instrumented_logger batch_logger;
+    stan::test::unit::instrumented_writer batch_init;
+    EXPECT_EQ(params, stan::services::util::initialize(
+                          model, empty_context, rng, init_radius,
+                          print_timing, batch_logger, batch_init, batch_size));
+  }
+}
+
+TEST_F(ServicesUtilInitialize, batched__radius_zero) {
+  double init_radius = 0;
+  bool print_timing = false;
+  std::vector<double> params = stan::services::util::initialize(
+      model, empty_context, rng, init_radius, print_timing, logger, init, 4);
+  ASSERT_EQ(model.num_params_r(), params.size()) << "2 parameters";
+  EXPECT_FLOAT_EQ(0, params[0]);
+  EXPECT_FLOAT_EQ(0, params[1]);
+  EXPECT_EQ(0, logger.call_count());
+  ASSERT_EQ(1, init.vector_double_values().size());
+}
+
+TEST_F(ServicesUtilInitialize, batched__model_throws__radius_two) {
+  test::mock_throwing_model throwing_model;
+
+  double init_radius = 2;
+  bool print_timing = false;
+  EXPECT_THROW(stan::services::util::initialize(throwing_model, empty_context,
+                                                rng, init_radius, print_timing,
+                                                logger, init, 8),
+               std::domain_error);
+  EXPECT_EQ(303, logger.call_count());
+  EXPECT_EQ(303, logger.call_count_info());
+  EXPECT_EQ(100, logger.find_info("throwing within log_prob"));
+}
+
+TEST_F(ServicesUtilInitialize, batched__model_errors__radius_two) {
+  test::mock_error_model error_model;
+
+  double init_radius = 2;
+  bool print_timing = false;
+  EXPECT_THROW_MSG(stan::services::util::initialize(
+                       error_model, empty_context, rng, init_radius,
+                       print_timing, logger, init, 8),
+                   std::out_of_range, "out_of_range error in log_prob");
+  EXPECT_EQ(2, logger.call_count());
+  EXPECT_EQ(2, logger.call_count_info());
+  EXPECT_EQ(1, logger.find_info("out_of_range error in log_prob"));
+}
@@ -0,0 +1,99 @@
+#include <stan/services/util/philox_engine.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <sstream>
+#include <vector>
+
+using stan::services::util::philox_engine;
+
+TEST(ServicesUtilPhiloxEngine, known_answers) {
+  // Philox4x32-10 known answer test from Random123
+  philox_engine zero(0, 0, 0);
+  EXPECT_EQ(0x6627e8d5u, zero());
+  EXPECT_EQ(0xe169c58du, zero());
+  EXPECT_EQ(0xbc57ac4cu, zero());
+  EXPECT_EQ(0x9b00dbd8u, zero());
+
+  // Not a Random123 vector: their pi-digits vector has the counter
+  // {243f6a88, 85a308d3, 13198a2e, 03707344}, but the position counts
+  // outputs in 64 bits, so only blocks below 2^62 can be reached.  The
+  // top bit of the second counter word is cleared, giving the counter
+  // {243f6a88, 05a308d3, 13198a2e, 03707344} with the same key
+  // {a4093822, 299f31d0}; the expected outputs are from an independent
+  // implementation of the Random123 round function.
+  philox_engine rng(0x299f31d0a4093822ULL, 0x0370734413198a2eULL,
+                    0x05a308d3243f6a88ULL << 2);
+  EXPECT_EQ(0x2fe11a02u, rng());
+  EXPECT_EQ(0x572a2f27u, rng());
+  EXPECT_EQ(0x2f88763bu, rng());
+  EXPECT_EQ(0x78d5e325u, rng());
+}
+
+TEST(ServicesUtilPhiloxEngine, counter_and_discard) {
+  philox_engine rng(123, 4);
+  std::vector<philox_engine::result_type> draws;
+  for (int n = 0; n < 21; ++n)
+    draws.push_back(rng());
+  EXPECT_EQ(21u, rng.counter());
+
+  for (int start = 0; start < 21; ++start) {
+    philox_engine at(123, 4, start);
+    EXPECT_EQ(draws[start], at()) << start;
+
+    philox_engine skipped(123, 4);
+    skipped.discard(start);
+    EXPECT_TRUE(at != skipped);
+    EXPECT_EQ(draws[start], skipped());
+    EXPECT_TRUE(at == skipped);
+  }
+
+  philox_engine far(123, 4);
+  far.discard(1ULL << 60);
+  EXPECT_EQ(philox_engine(123, 4, 1ULL << 60)(), far());
+}
+
+TEST(ServicesUtilPhiloxEngine, streams_and_seeds_differ) {
+  philox_engine a(1, 0), b(1, 1), c(2, 0);
+  int same_ab = 0, same_ac = 0;
+  for (int n = 0; n < 100; ++n) {
+    philox_engine::result_type x = a();
+    same_ab += x == b();
+    same_ac += x == c();
+  }
+  EXPECT_EQ(0, same_ab);
+  EXPECT_EQ(0, same_ac);
+  EXPECT_EQ(1u, b.stream());
+  EXPECT_EQ(2u, c.seed_value());
+  EXPECT_TRUE(stan::services::util::create_philox_rng(3, 2)
+              == philox_engine(3, 2));
+}
+
+TEST(ServicesUtilPhiloxEngine, save_and_restore) {
+  philox_engine rng(99, 7);
+  rng.discard(5);
+  std::stringstream state;
+  state << rng;
+  philox_engine restored;
+  state >> restored;
+  EXPECT_TRUE(rng == restored);
+  EXPECT_EQ(rng(), restored());
+}
+
+TEST(ServicesUtilPhiloxEngine, boost_distributions) {
+  philox_engine rng(42, 1);
+  boost::random::uniform_real_distribution<double> unif(-2, 2);
+  boost::random::normal_distribution<double> normal;
+  double sum = 0, sum_sq = 0;
+  const int N = 100000;
+  for (int n = 0; n < N; ++n) {
+    double u = unif(rng);
+    ASSERT_GE(u, -2);
+    ASSERT_LT(u, 2);
+    double z = normal(rng);
+    sum += z;
+    sum_sq += z * z;
+  }
+  EXPECT_NEAR(0, sum / N, 0.02);
+  EXPECT_NEAR(1, sum_sq / N, 0.02);
+}
@@ -197,3 +197,90 @@ TEST_F(ServicesUtil, num_warmup_num_samples_refresh) {
   EXPECT_EQ(num_samples, diagnostic_writer.call_count("vector_double"))
       << "draws";
 }
+
+TEST_F(ServicesUtil, budget_max_iterations) {
+  num_warmup = 100;
+  stan::services::util::sampling_budget budget(1e9, 100, 0, 500);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, budget, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer);
+  EXPECT_EQ(num_warmup + budget.max_iterations, interrupt.call_count());
+
+  EXPECT_EQ(1 + 3 + 2, logger.call_count())
+      << "Writes the stop reason and the elapsed time";
+  EXPECT_EQ(1, logger.find_info("maximum number of iterations reached"));
+
+  EXPECT_EQ(1 + 2 + 1 + 3, sample_writer.call_count("string"))
+      << "budget + adaptation info + stop reason + elapsed time";
+  EXPECT_EQ(budget.max_iterations, sample_writer.call_count("vector_double"))
+      << "draws";
+  std::vector<std::string> comments = sample_writer.string_values();
+  EXPECT_EQ(
+      "Sampling budget: target_ess = 1e+09, check_every = 100, "
+      "max_seconds = 0, max_iterations = 500",
+      comments.front());
+  EXPECT_EQ(
+      "Sampling stopped: maximum number of iterations reached after 500 "
+      "iterations",
+      comments[3]);
+
+  EXPECT_EQ(1 + 3, diagnostic_writer.call_count("string"))
+      << "stop reason + elapsed time";
+  EXPECT_EQ(budget.max_iterations,
+            diagnostic_writer.call_count("vector_double"))
+      << "draws";
+}
+
+TEST_F(ServicesUtil, budget_deadline) {
+  num_warmup = 10;
+  // a deadline that has passed by the end of the first iteration
+  stan::services::util::sampling_budget budget(1e9, 100, 1e-9, 500);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, budget, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer);
+  EXPECT_EQ(num_warmup + 1, interrupt.call_count());
+
+  EXPECT_EQ(1, logger.find_info("wall-clock deadline reached"));
+  EXPECT_EQ(1, sample_writer.call_count("vector_double")) << "draws";
+  std::vector<std::string> comments = sample_writer.string_values();
+  EXPECT_EQ(
+      "Sampling budget: target_ess = 1e+09, check_every = 100, "
+      "max_seconds = 1e-09, max_iterations = 500",
+      comments.front());
+  EXPECT_EQ("Sampling stopped: wall-clock deadline reached after 1 iterations",
+            comments[3]);
+}
+
+TEST_F(ServicesUtil, budget_target_ess) {
+  num_warmup = 200;
+  stan::services::util::sampling_budget budget(100, 50, 0, 100000);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, budget, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer);
+  int num_samples = interrupt.call_count() - num_warmup;
+  EXPECT_GT(budget.max_iterations, num_samples);
+  EXPECT_EQ(0, num_samples % budget.check_every)
+      << "ESS is only checked every check_every iterations";
+  EXPECT_EQ(1, logger.find_info("target effective sample size reached"));
+  EXPECT_EQ(num_samples, sample_writer.call_count("vector_double"));
+}
+
+TEST_F(ServicesUtil, budget_monitored_subset) {
+  stan::services::util::sampling_budget budget(100, 50, 0, 100000, {1});
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, budget, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer);
+  EXPECT_EQ(1, logger.find_info("target effective sample size reached"));
+  EXPECT_EQ("Monitored unconstrained parameters: 1",
+            sample_writer.string_values()[1]);
+}
+
+TEST_F(ServicesUtil, budget_invalid) {
+  stan::services::util::sampling_budget budget(100, 50, 0, 100000, {2});
+  EXPECT_THROW(stan::services::util::run_adaptive_sampler(
+                   sampler, model, cont_vector, num_warmup, budget, num_thin,
+                   refresh, save_warmup, rng, interrupt, logger, sample_writer,
+                   diagnostic_writer),
+               std::invalid_argument);
+  EXPECT_EQ(0, interrupt.call_count());
+}
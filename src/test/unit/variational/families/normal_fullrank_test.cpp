@@ -139,6 +139,33 @@ TEST(normal_fullrank_test, transform) {
   EXPECT_THROW(my_normal_fullrank.transform(x_nan);, std::domain_error);
 }
 
+TEST(normal_fullrank_test, transform_draws) {
+  Eigen::Vector3d mu;
+  mu << 5.7, -3.2, 0.1332;
+
+  Eigen::Matrix3d L;
+  L << 1.3, 0, 0, 2.3, 41, 0, 3.3, 42, 92;
+  stan::variational::normal_fullrank my_normal_fullrank(mu, L);
+
+  Eigen::MatrixXd x(3, 2);
+  x << 7.1, 0.3, -9.2, -1.7, 0.59, 2.4;
+
+  Eigen::MatrixXd x_result = my_normal_fullrank.transform_draws(x);
+  ASSERT_EQ(3, x_result.rows());
+  ASSERT_EQ(2, x_result.cols());
+  for (int j = 0; j < 2; ++j) {
+    Eigen::VectorXd x_transformed = my_normal_fullrank.transform(x.col(j));
+    for (int i = 0; i < my_normal_fullrank.dimension(); ++i)
+      EXPECT_FLOAT_EQ(x_transformed(i), x_result(i, j));
+  }
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  x(1, 1) = nan;
+  EXPECT_THROW(my_normal_fullrank.transform_draws(x), std::domain_error);
+  EXPECT_THROW(my_normal_fullrank.transform_draws(Eigen::MatrixXd::Zero(2, 2)),
+               std::invalid_argument);
+}
+
 TEST(normal_fullrank_test, calc_log_g) {
   Eigen::Vector3d x;
   x << 7.1, -9.2, 0.59;
@@ -1,8 +1,36 @@
 #include <stan/variational/families/normal_meanfield.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <gtest/gtest.h>
 #include <test/unit/util.hpp>
 
+namespace {
+// Standard normal log density whose evaluations throw after the first
+// num_good ones.
+class failing_model {
+ public:
+  explicit failing_model(int num_good) : num_good_(num_good), calls_(0) {}
+
+  size_t num_params_r() const { return 2; }
+
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs = 0) const {
+    if (calls_++ >= num_good_)
+      throw std::domain_error("failing_model");
+    return -0.5 * params_r.squaredNorm();
+  }
+
+ private:
+  int num_good_;
+  mutable std::atomic<int> calls_;
+};
+}  // namespace
+
 TEST(normal_meanfield_test, zero_init) {
   int my_dimension = 10;
 
@@ -135,6 +163,33 @@ TEST(normal_meanfield_test, transform) {
   EXPECT_THROW(my_normal_meanfield.transform(x_nan);, std::domain_error);
 }
 
+TEST(normal_meanfield_test, transform_draws) {
+  Eigen::Vector3d mu;
+  mu << 5.7, -3.2, 0.1332;
+
+  Eigen::Vector3d omega;
+  omega << -0.42, 0.8922, 13.4;
+  stan::variational::normal_meanfield my_normal_meanfield(mu, omega);
+
+  Eigen::MatrixXd x(3, 2);
+  x << 7.1, 0.3, -9.2, -1.7, 0.59, 2.4;
+
+  Eigen::MatrixXd x_result = my_normal_meanfield.transform_draws(x);
+  ASSERT_EQ(3, x_result.rows());
+  ASSERT_EQ(2, x_result.cols());
+  for (int j = 0; j < 2; ++j) {
+    Eigen::VectorXd x_transformed = my_normal_meanfield.transform(x.col(j));
+    for (int i = 0; i < my_normal_meanfield.dimension(); ++i)
+      EXPECT_FLOAT_EQ(x_transformed(i), x_result(i, j));
+  }
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  x(1, 1) = nan;
+  EXPECT_THROW(my_normal_meanfield.transform_draws(x), std::domain_error);
+  EXPECT_THROW(my_normal_meanfield.transform_draws(Eigen::MatrixXd::Zero(2, 2)),
+               std::invalid_argument);
+}
+
 TEST(normal_meanfield_test, calc_log_g) {
   Eigen::Vector3d x;
   x << 7.1, -9.2, 0.59;
@@ -153,3 +208,21 @@ TEST(normal_meanfield_test, calc_log_g) {
 
   EXPECT_FLOAT_EQ(log_g_out, log_g_true);
 }
+
+TEST(normal_meanfield_test, calc_grad_rng_after_too_many_drops) {
+  // 3 draws are kept and then 100 dropped, 103 in all, as when drawing
+  // and evaluating one at a time
+  failing_model model(3);
+  stan::variational::normal_meanfield q(Eigen::VectorXd::Zero(2));
+  stan::variational::normal_meanfield elbo_grad(2);
+  Eigen::VectorXd cont_params = Eigen::VectorXd::Zero(2);
+  std::stringstream out;
+  stan::callbacks::stream_logger logger(out, out, out, out, out);
+  boost::ecuyer1988 rng(7), expected_rng(7);
+
+  EXPECT_THROW(q.calc_grad(elbo_grad, model, cont_params, 10, rng, logger),
+               std::domain_error);
+  for (int n = 0; n < 2 * 103; ++n)
+    stan::math::normal_rng(0, 1, expected_rng);
+  EXPECT_TRUE(expected_rng == rng);
+}